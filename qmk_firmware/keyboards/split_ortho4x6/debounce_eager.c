@@ -0,0 +1,122 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Per-key debounce: eager press, deferred release (DEBOUNCE_TYPE = custom).
+//
+// A press is reported on the first scan that sees the contact close, then the
+// key ignores its input for DEBOUNCE_PRESS_MS so the closing bounce cannot
+// produce a release. A release is reported only once the input has stayed
+// open for DEBOUNCE_RELEASE_MS, so the opening bounce cannot produce a second
+// press. QMK's default (sym_defer_g) delays presses by the full DEBOUNCE time.
+//
+// scripts/debounce_sim runs this file against chattering waveforms on a host.
+
+#include "debounce.h"
+#include "timer.h"
+
+#include <string.h>
+
+#ifndef DEBOUNCE
+#define DEBOUNCE 5
+#endif
+#ifndef DEBOUNCE_PRESS_MS
+#define DEBOUNCE_PRESS_MS DEBOUNCE // lockout after a reported press
+#endif
+#ifndef DEBOUNCE_RELEASE_MS
+#define DEBOUNCE_RELEASE_MS DEBOUNCE // open time needed to report a release
+#endif
+
+#define KEY_RELEASING 0x80 // the remaining time counts towards a release
+#define KEY_MS_MASK 0x7F
+
+_Static_assert(DEBOUNCE_PRESS_MS <= KEY_MS_MASK && DEBOUNCE_RELEASE_MS <= KEY_MS_MASK,
+               "debounce thresholds must be 127 ms or less");
+
+// Per key: ms left in the current lockout/release wait, 0 = idle
+static uint8_t keys[MATRIX_ROWS][MATRIX_COLS];
+static fast_timer_t last_time;
+static bool waiting; // a key has time left; scan even without raw changes
+
+void debounce_init(uint8_t num_rows) {
+  (void)num_rows;
+  memset(keys, 0, sizeof(keys));
+  last_time = timer_read_fast();
+  waiting = false;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows,
+              bool changed) {
+  fast_timer_t now = timer_read_fast();
+  fast_timer_t diff = TIMER_DIFF_FAST(now, last_time);
+  uint8_t elapsed = diff > KEY_MS_MASK ? KEY_MS_MASK : (uint8_t)diff;
+  last_time = now;
+
+  if (!changed && !waiting) {
+    return false;
+  }
+
+  bool cooked_changed = false;
+  waiting = false;
+  for (uint8_t r = 0; r < num_rows; r++) {
+    matrix_row_t delta = raw[r] ^ cooked[r];
+
+    for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+      uint8_t *k = &keys[r][c];
+      matrix_row_t bit = (matrix_row_t)1 << c;
+
+      if (*k) {
+        uint8_t ms = *k & KEY_MS_MASK;
+        ms = ms > elapsed ? ms - elapsed : 0;
+        if (*k & KEY_RELEASING) {
+          if (!(delta & bit)) {
+            *k = 0; // closed again: still the same press
+          } else if (ms) {
+            *k = KEY_RELEASING | ms;
+            waiting = true;
+          } else {
+            *k = 0;
+            cooked[r] &= ~bit;
+            cooked_changed = true;
+          }
+          continue;
+        }
+        *k = ms;
+        if (ms) {
+          waiting = true; // press lockout: input ignored
+          continue;
+        }
+        // lockout over: take the input as it is now, it may have opened
+        // while nothing was looking
+      }
+
+      if (!(delta & bit)) {
+        continue;
+      }
+      if (raw[r] & bit) {
+        cooked[r] |= bit;
+        cooked_changed = true;
+        *k = DEBOUNCE_PRESS_MS;
+      } else if (DEBOUNCE_RELEASE_MS == 0) {
+        cooked[r] &= ~bit;
+        cooked_changed = true;
+      } else {
+        *k = KEY_RELEASING | DEBOUNCE_RELEASE_MS;
+      }
+      waiting |= *k != 0;
+    }
+  }
+  return cooked_changed;
+}
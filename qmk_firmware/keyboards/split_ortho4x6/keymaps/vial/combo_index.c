@@ -0,0 +1,107 @@
+// keyboards/split_ortho4x6/keymaps/vial/combo_index.c
+
+#include "combo_index.h"
+#include "quantum.h"
+#include "keymap_introspection.h"
+#include <string.h>
+
+#define COMBO_KEYS_MAX (VIAL_COMBO_ENTRIES * 4) // vial_combo_entry_t.input
+
+// ====== Index ====================================================
+// コンボに含まれるキーコードの昇順の表。引くのは二分探索 1 回（32 コンボ x 4 キーでも
+// 7 回の比較）。省けるのはどのコンボにも含まれないキーだけで、コンボのキーは QMK の
+// 全エントリの走査をそのまま通る
+static uint16_t g_keys[COMBO_KEYS_MAX];
+static uint16_t g_num_keys;
+static bool     g_dirty = true; // 最初のイベントで作る（Vial の初期化でコンボを読み込んだ後）
+static bool     g_full;         // 表に入りきらなかった: 索引を使わない
+
+// 候補キーとして押された位置。離しを取りこぼしても走査を省かなくなるだけ
+static matrix_row_t        g_held[MATRIX_ROWS];
+static combo_index_stats_t g_stats;
+
+static void insert_key(uint16_t keycode) {
+    uint16_t i = g_num_keys;
+    while (i > 0 && g_keys[i - 1] > keycode) i--;
+    if (i > 0 && g_keys[i - 1] == keycode) return;
+    if (g_num_keys == COMBO_KEYS_MAX) {
+        g_full = true;
+        return;
+    }
+    memmove(&g_keys[i + 1], &g_keys[i], (g_num_keys - i) * sizeof(g_keys[0]));
+    g_keys[i] = keycode;
+    g_num_keys++;
+}
+
+static void rebuild(void) {
+    g_num_keys = 0;
+    g_full     = false;
+    for (uint16_t i = 0; i < combo_count(); i++) {
+        const uint16_t* keys = combo_get(i)->keys;
+        for (uint16_t k; (k = pgm_read_word(keys)) != COMBO_END; keys++) insert_key(k);
+    }
+    g_dirty = false;
+}
+
+static bool is_combo_keycode(uint16_t keycode) {
+    uint16_t lo = 0, hi = g_num_keys;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (g_keys[mid] < keycode) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < g_num_keys && g_keys[lo] == keycode;
+}
+
+static bool any_held(void) {
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (g_held[r]) return true;
+    }
+    return false;
+}
+
+// ====== QMK core wrappers (-Wl,-wrap) ============================
+bool __real_process_combo(uint16_t keycode, keyrecord_t* record);
+
+bool __wrap_process_combo(uint16_t keycode, keyrecord_t* record) {
+    keypos_t key = record->event.key;
+    g_stats.events++;
+    if (g_dirty) rebuild();
+
+    // QK_COMBO_ON/OFF/TOGGLE と行列外（コンボ自身が出すイベント等）は常に本体へ
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS || (keycode >= QK_COMBO_ON && keycode <= QK_COMBO_TOGGLE)) {
+        return __real_process_combo(keycode, record);
+    }
+
+    matrix_row_t bit = (matrix_row_t)1 << key.col;
+#ifdef COMBO_ONLY_FROM_LAYER
+    // process_combo() と同じく、コンボは指定レイヤのキーコードで照合される
+    uint16_t match = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, key);
+#else
+    uint16_t match = keycode;
+#endif
+    bool candidate = is_combo_keycode(match);
+    if (!candidate && !g_full && !any_held()) {
+        // 候補が無く、保留中のキーも無い: 本体は何もせず true を返す
+        g_stats.skipped++;
+        return true;
+    }
+
+    // 候補キーを押している間は、他のキーも本体に通す（押下中のコンボを中断させるため）
+    if (record->event.pressed && candidate) g_held[key.row] |= bit;
+    bool ret = __real_process_combo(keycode, record);
+    if (!record->event.pressed) g_held[key.row] &= ~bit;
+    return ret;
+}
+
+int __real_dynamic_keymap_set_combo(uint8_t index, const vial_combo_entry_t* entry);
+int __wrap_dynamic_keymap_set_combo(uint8_t index, const vial_combo_entry_t* entry) {
+    int ret = __real_dynamic_keymap_set_combo(index, entry);
+    g_dirty = true; // Vial が RAM 上のコンボを読み直した後、次のイベントで作る
+    return ret;
+}
+
+const combo_index_stats_t* combo_index_get_stats(void) { return &g_stats; }
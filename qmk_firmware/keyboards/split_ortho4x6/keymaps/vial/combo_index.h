@@ -0,0 +1,19 @@
+// keyboards/split_ortho4x6/keymaps/vial/combo_index.h
+#pragma once
+// コンボのキーコード索引。QMK の process_combo() はキーイベントのたびに全コンボを
+// 走査するため、process_combo() をリンカの -wrap で包み、どのコンボにも含まれない
+// キーコードで、かつコンボの途中（候補キーを押している最中）でなければ走査を省く。
+// その場合 QMK 側も何もせず true を返すだけなので、挙動は変わらない。
+// コンボに含まれるキーのイベントは従来どおり全エントリを走査するので、コンボの数に比例する
+// 分は残る（走査をコンボ単位で絞るには QMK 本体の変更が要る）。
+// 索引はコンボの読み込み後と Vial からの変更（dynamic_keymap_set_combo）後に作り直す。
+// 挙動の比較は scripts/combo_test。
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t events; // process_combo() の呼び出し
+    uint32_t skipped; // 走査を省いた回数
+} combo_index_stats_t;
+
+const combo_index_stats_t* combo_index_get_stats(void);
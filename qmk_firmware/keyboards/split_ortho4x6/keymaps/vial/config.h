@@ -3,10 +3,16 @@
 #define EE_HANDS
 #define VIAL_KEYBOARD_UID {0xa1, 0x8b, 0x9b, 0x77, 0x32, 0x7e, 0x7a, 0x6c}
 #define PICO_FLASH_SIZE_BYTES (1 * 1024 * 1024)
-#define SPLIT_POINTING_ENABLE
-#define POINTING_DEVICE_COMBINED
+// 右のトラックボールは標準の SPLIT_POINTING ではなく tb_split.c で転送する
+#define SPLIT_TRANSACTION_IDS_USER TB_SPLIT_POLL, TB_SPLIT_SENSOR
 #define WHEEL_EXTENDED_REPORT
 #define MOUSE_EXTENDED_REPORT
+// トラックボール設定（tb_config_t、拡張用に余裕を持たせる）
+#define EECONFIG_KB_DATA_SIZE 64
+
+// debounce_eager.c: 押下は即時に送り、この間は入力を無視する / 離すのはこの間開き続けてから
+#define DEBOUNCE_PRESS_MS 5
+#define DEBOUNCE_RELEASE_MS 5
 
 #define VIAL_TAP_DANCE_ENTRIES 8
 #define VIAL_COMBO_ENTRIES 8
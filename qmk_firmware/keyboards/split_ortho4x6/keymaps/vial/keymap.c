@@ -10,6 +10,23 @@
 #include "quantum.h"
 #include "pointing_device.h"
 #include "tb.h"
+#include "tb_split.h"
+#include "paw3222.h"
+#include "via.h" // id_unhandled
+#include "rawhid_cmd.h"
+#ifdef TB_TRACE_ENABLE
+#include "tb_trace.h"
+#endif
+#ifdef LINK_STATS_ENABLE
+#include "link_stats.h"
+#endif
+#include "scan_prof.h"
+#ifdef TB_BENCH_ENABLE
+#include "tb_bench.h"
+#endif
+#ifdef LAYER_CACHE_ENABLE
+#include "layer_cache.h"
+#endif
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h> // abs
@@ -264,17 +281,70 @@ void __wrap_dynamic_keymap_reset(void) {
 
     uint16_t const macro_buffer_size = MIN(sizeof(default_macro_buffer), dynamic_keymap_macro_get_buffer_size());
     dynamic_keymap_macro_set_buffer(0, macro_buffer_size, (uint8_t *)default_macro_buffer);
+
+#ifdef LAYER_CACHE_ENABLE
+    layer_cache_invalidate();
+#endif
 }
 
 /* GENERATED CODE END */
 
 
 /* USER CODE BEGIN */
-void keyboard_post_init_user(void) { tb_init(); }
+void keyboard_post_init_user(void) {
+  tb_split_init();
+  tb_init();
+}
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   return tb_process_record(keycode, record);
 }
-report_mouse_t pointing_device_task_combined_user(report_mouse_t l, report_mouse_t r) {
-  return tb_task_combined(l, r);
+report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
+  return tb_split_task(mouse_report);
+}
+void housekeeping_task_user(void) {
+  SCAN_PROF_LOOP_TICK();
+  // ポインティングタスクの間隔とは独立にセンサを読む
+  paw3222_sampler_task();
+  tb_task();
+#ifdef TB_BENCH_ENABLE
+  tb_bench_task();
+#endif
+}
+void suspend_power_down_user(void) { tb_flush(); }
+bool shutdown_user(bool jump_to_bootloader) {
+  tb_flush();
+  return true;
+}
+// VIA/Vial が処理しなかった raw HID コマンド（rawhid_cmd.h）
+void raw_hid_receive_kb(uint8_t *data, uint8_t length) {
+  switch (data[0]) {
+#ifdef TB_TRACE_ENABLE
+    case RAWHID_CMD_TB_TRACE:
+      tb_trace_raw_hid(data, length);
+      return;
+#endif
+#ifdef LINK_STATS_ENABLE
+    case RAWHID_CMD_LINK_STATS:
+      link_stats_raw_hid(data, length);
+      return;
+#endif
+    case RAWHID_CMD_TB_ACCEL:
+      tb_accel_raw_hid(data, length);
+      return;
+    case RAWHID_CMD_TB_SAVE:
+      tb_save_raw_hid(data, length);
+      return;
+    case RAWHID_CMD_SENSOR:
+      tb_split_sensor_raw_hid(data, length);
+      return;
+#ifdef SCAN_PROFILER_ENABLE
+    case RAWHID_CMD_SCAN_PROF:
+      scan_prof_raw_hid(data, length);
+      return;
+#endif
+    default:
+      data[0] = id_unhandled;
+      return;
+  }
 }
 /* USER CODE END */
\ No newline at end of file
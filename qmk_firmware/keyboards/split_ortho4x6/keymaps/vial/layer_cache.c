@@ -0,0 +1,114 @@
+// keyboards/split_ortho4x6/keymaps/vial/layer_cache.c
+
+#include "layer_cache.h"
+#include "quantum.h"
+#include <string.h>
+
+#ifndef LAYER_CACHE_SLOTS
+#    define LAYER_CACHE_SLOTS 8 // 保持するレイヤ状態の数（1 つあたり約 180 バイト）。素 + LT(1..6) + 重ね押し
+#endif
+
+// ====== Cache ====================================================
+// LT() で行き来するレイヤ状態は数種類しかないので、状態ごとに表を持ち、
+// 戻ってきた時は作り直さずに使う。各位置は最初に引かれた時に辿る
+// （全位置を一度に作ると、レイヤキーの直後のキーがその分を待たされるため）。
+typedef struct {
+    layer_state_t state; // layer_state | default_layer_state
+    uint16_t      used;  // 最後に使った時の g_tick（追い出す順）
+    matrix_row_t  valid[MATRIX_ROWS];
+    uint8_t       layer[MATRIX_ROWS][MATRIX_COLS];  // layer_switch_get_layer() の結果
+    action_t      action[MATRIX_ROWS][MATRIX_COLS]; // そのレイヤでの action_for_key()
+} layer_cache_slot_t;
+
+static layer_cache_slot_t  g_slots[LAYER_CACHE_SLOTS];
+static layer_cache_slot_t* g_cur = &g_slots[0];
+static uint16_t            g_tick;
+static uint16_t            g_keymap_config; // 表を作った時の keymap_config（Magic のスワップでアクションが変わる）
+
+action_t __real_action_for_key(uint8_t layer, keypos_t key);
+
+void layer_cache_invalidate(void) {
+    for (uint8_t i = 0; i < LAYER_CACHE_SLOTS; i++) {
+        memset(g_slots[i].valid, 0, sizeof(g_slots[i].valid));
+    }
+}
+
+static inline bool in_matrix(keypos_t key) { return key.row < MATRIX_ROWS && key.col < MATRIX_COLS; }
+
+static void switch_slot(layer_state_t state) {
+    layer_cache_slot_t* slot   = NULL;
+    layer_cache_slot_t* oldest = &g_slots[0];
+    for (uint8_t i = 0; i < LAYER_CACHE_SLOTS; i++) {
+        layer_cache_slot_t* s = &g_slots[i];
+        if (s->state == state) {
+            slot = s;
+            break;
+        }
+        if ((uint16_t)(g_tick - s->used) > (uint16_t)(g_tick - oldest->used)) oldest = s;
+    }
+    if (!slot) {
+        slot        = oldest;
+        slot->state = state;
+        memset(slot->valid, 0, sizeof(slot->valid));
+    }
+    slot->used = ++g_tick;
+    g_cur      = slot;
+}
+
+static inline bool cached(keypos_t key) {
+    if (keymap_config.raw != g_keymap_config) {
+        g_keymap_config = keymap_config.raw;
+        layer_cache_invalidate();
+    }
+    layer_state_t state = layer_state | default_layer_state;
+    if (state != g_cur->state) switch_slot(state);
+    return g_cur->valid[key.row] & ((matrix_row_t)1 << key.col);
+}
+
+// action_layer.c の layer_switch_get_layer() と同じ順に辿る
+static void resolve(keypos_t key) {
+    layer_state_t state  = g_cur->state;
+    uint8_t       layer  = get_highest_layer(default_layer_state);
+    action_t      action = {.code = ACTION_TRANSPARENT};
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if (state & ((layer_state_t)1 << i)) {
+            action = __real_action_for_key(i, key);
+            if (action.code != ACTION_TRANSPARENT) {
+                layer = i;
+                break;
+            }
+        }
+    }
+    if (action.code == ACTION_TRANSPARENT) action = __real_action_for_key(layer, key);
+
+    g_cur->layer[key.row][key.col]  = layer;
+    g_cur->action[key.row][key.col] = action;
+    g_cur->valid[key.row] |= (matrix_row_t)1 << key.col;
+}
+
+// ====== QMK core wrappers (-Wl,-wrap) ============================
+// action_layer.c の layer_switch_get_layer() / store_or_get_action() は、どちらも
+// keymap_common.c の action_for_key() を呼ぶ（別のオブジェクトなので -wrap が効く）。
+// 解決済みのレイヤなら表のアクションを返し、それより上の有効なレイヤは透過と分かって
+// いるので、layer_switch_get_layer() の走査も EEPROM を読まずに済む。
+// 離した時は押した時のレイヤ（source layers cache）で引かれるので、それ以外は元の関数へ
+action_t __wrap_action_for_key(uint8_t layer, keypos_t key) {
+    if (!in_matrix(key) || layer >= MAX_LAYER) return __real_action_for_key(layer, key); // コンボ等
+    if (!cached(key)) resolve(key);
+    uint8_t top = g_cur->layer[key.row][key.col];
+    if (layer == top) return g_cur->action[key.row][key.col];
+    if (layer > top && (g_cur->state & ((layer_state_t)1 << layer))) return (action_t){.code = ACTION_TRANSPARENT};
+    return __real_action_for_key(layer, key);
+}
+
+void __real_dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode);
+void __wrap_dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    __real_dynamic_keymap_set_keycode(layer, row, column, keycode);
+    layer_cache_invalidate();
+}
+
+void __real_dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t* data);
+void __wrap_dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {
+    __real_dynamic_keymap_set_buffer(offset, size, data);
+    layer_cache_invalidate();
+}
@@ -0,0 +1,10 @@
+// keyboards/split_ortho4x6/keymaps/vial/layer_cache.h
+#pragma once
+// キー位置ごとの「今のレイヤ状態で効くレイヤとアクション」のキャッシュ。
+// action_for_key() をリンカの -wrap で包み、上のレイヤから KC_TRNS を辿る処理を、
+// レイヤ状態ごとに位置 1 回だけにする。layer_switch_get_layer() などは
+// action_for_key() と同じオブジェクトに無いので、こちらを包まないと効かない。
+// キーマップの書き換え（Vial の set_keycode / set_buffer / reset）でも作り直す。
+// 効果の確認は scripts/layer_bench。
+
+void layer_cache_invalidate(void);
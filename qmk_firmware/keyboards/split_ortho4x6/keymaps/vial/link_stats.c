@@ -0,0 +1,125 @@
+// keyboards/split_ortho4x6/keymaps/vial/link_stats.c
+
+#include "link_stats.h"
+#include "quantum.h"
+#include "transactions.h"
+#include "rawhid_cmd.h"
+#include "timer_us.h"
+#include <string.h>
+
+#ifndef SERIAL_USART_TIMEOUT
+#    define SERIAL_USART_TIMEOUT 20 // ms（シリアルドライバの既定値）
+#endif
+
+static link_stat_t g_link[NUM_TOTAL_TRANSACTIONS];
+static bool        g_on;
+static uint32_t    g_since; // 有効にした時刻 (ms)
+static int8_t      g_last_fail = -1;
+
+// ====== soft_serial_transaction() wrapper ========================
+bool __real_soft_serial_transaction(int index);
+
+bool __wrap_soft_serial_transaction(int index) {
+    if (!g_on) return __real_soft_serial_transaction(index);
+
+    uint32_t t0  = timer_read_us();
+    bool     ok  = __real_soft_serial_transaction(index);
+    uint32_t rtt = timer_read_us() - t0;
+
+    if (index < 0 || index >= NUM_TOTAL_TRANSACTIONS) return ok;
+    link_stat_t* s = &g_link[index];
+
+    s->count++;
+    if (g_last_fail == index) s->retries++;
+    if (ok) {
+        g_last_fail = -1;
+        s->bytes += split_transaction_table[index].initiator2target_buffer_size + split_transaction_table[index].target2initiator_buffer_size;
+    } else {
+        g_last_fail = index;
+        s->fails++;
+        if (rtt >= SERIAL_USART_TIMEOUT * 1000u) s->timeouts++;
+    }
+
+    if (rtt < s->rtt_min) s->rtt_min = rtt;
+    if (rtt > s->rtt_max) s->rtt_max = rtt;
+    s->rtt_sum += rtt;
+
+    uint8_t b = 0;
+    for (uint32_t r = rtt >> 6; r && b < LINK_HIST_BUCKETS - 1; r >>= 1) b++;
+    if (s->hist[b] < UINT16_MAX) s->hist[b]++;
+    return ok;
+}
+
+// ====== API ======================================================
+void link_stats_enable(bool on) {
+    if (on) {
+        memset(g_link, 0, sizeof(g_link));
+        for (uint8_t i = 0; i < NUM_TOTAL_TRANSACTIONS; ++i) g_link[i].rtt_min = UINT32_MAX;
+        g_since     = timer_read32();
+        g_last_fail = -1;
+    }
+    g_on = on;
+}
+
+const link_stat_t* link_stats_get(uint8_t id) { return id < NUM_TOTAL_TRANSACTIONS ? &g_link[id] : NULL; }
+
+// ====== Raw HID ==================================================
+enum link_stats_subcmd {
+    LINK_STATS_ENABLE = 0x01, // data[2]: 1 = 有効（クリア）, 0 = 停止
+    LINK_STATS_INFO   = 0x02,
+    LINK_STATS_READ   = 0x03, // data[2]: 種別, data[3]: 0 = 回数/往復時間, 1 = 転送量/ヒストグラム
+};
+
+#if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+#    define RPC_ID(x) (x)
+#else
+#    define RPC_ID(x) 0xFF
+#endif
+
+void link_stats_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t* body = &data[4];
+
+    switch (data[1]) {
+        case LINK_STATS_ENABLE:
+            link_stats_enable(data[2] != 0);
+            break;
+        case LINK_STATS_INFO:
+            memset(&data[2], 0, length - 2);
+            data[2] = g_on;
+            data[3] = NUM_TOTAL_TRANSACTIONS;
+            rawhid_put_u32(&body[0], timer_elapsed32(g_since));
+            body[4] = LINK_HIST_BUCKETS;
+            // ホスト側で名前を付けるための、常に存在する種別の番号
+            body[5]  = GET_SLAVE_MATRIX_CHECKSUM;
+            body[6]  = GET_SLAVE_MATRIX_DATA;
+            body[7]  = RPC_ID(PUT_RPC_INFO);
+            body[8]  = RPC_ID(PUT_RPC_REQ);
+            body[9]  = RPC_ID(EXECUTE_RPC);
+            body[10] = RPC_ID(GET_RPC_RESP);
+            break;
+        case LINK_STATS_READ: {
+            const link_stat_t* s = link_stats_get(data[2]);
+            if (!s) {
+                data[1] = RAWHID_ERR;
+                break;
+            }
+            memset(body, 0, length - 4);
+            if (data[3] == 0) {
+                rawhid_put_u32(&body[0], s->count);
+                rawhid_put_u32(&body[4], s->fails);
+                rawhid_put_u32(&body[8], s->timeouts);
+                rawhid_put_u32(&body[12], s->retries);
+                rawhid_put_u32(&body[16], s->count ? s->rtt_min : 0);
+                rawhid_put_u32(&body[20], s->rtt_max);
+                rawhid_put_u32(&body[24], s->rtt_sum);
+            } else {
+                rawhid_put_u32(&body[0], s->bytes);
+                for (uint8_t i = 0; i < LINK_HIST_BUCKETS; ++i) rawhid_put_u16(&body[4 + 2 * i], s->hist[i]);
+            }
+            break;
+        }
+        default:
+            data[1] = RAWHID_ERR;
+            break;
+    }
+}
@@ -0,0 +1,26 @@
+// keyboards/split_ortho4x6/keymaps/vial/link_stats.h
+#pragma once
+// スプリット通信（GP13 のシリアル）の計測。soft_serial_transaction() を
+// リンカの -wrap で包み、トランザクション種別ごとに往復時間・失敗・再送・
+// 転送量を数える。ホストから有効にするまでは分岐 1 つ分のコストしかない。
+// 読み出しは scripts/link_stats.py。
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LINK_HIST_BUCKETS 8 // 往復時間: <64us, <128us, ... , >=4096us
+
+typedef struct {
+    uint32_t count;
+    uint32_t fails;    // 失敗（チェックサム不一致/無応答）
+    uint32_t timeouts; // 失敗のうち往復時間がタイムアウトに達したもの
+    uint32_t retries;  // 同じ種別の失敗直後の再実行
+    uint32_t rtt_min, rtt_max, rtt_sum; // us
+    uint32_t bytes;    // 送受信したペイロードのバイト数
+    uint16_t hist[LINK_HIST_BUCKETS];
+} link_stat_t;
+
+void link_stats_enable(bool on); // 有効にした時点でカウンタをクリア
+const link_stat_t* link_stats_get(uint8_t id);
+
+void link_stats_raw_hid(uint8_t* data, uint8_t length); // RAWHID_CMD_LINK_STATS
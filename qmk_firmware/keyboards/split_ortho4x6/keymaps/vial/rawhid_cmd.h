@@ -0,0 +1,29 @@
+// keyboards/split_ortho4x6/keymaps/vial/rawhid_cmd.h
+#pragma once
+// Vial の raw HID に載せる独自コマンド。VIA/Vial が処理しなかった ID が
+// raw_hid_receive_kb()（keymap.c）に来るので、先頭バイトで各モジュールへ振り分ける。
+// 応答は受信バッファをそのまま書き換えて返す（VIA と同じ流儀）。
+//   data[0] = コマンド, data[1] = サブコマンド（0xFF で返すと失敗）, 以降がペイロード
+
+#include <stdint.h>
+
+#define RAWHID_CMD_TB_TRACE   0x70 // tb_trace.c
+#define RAWHID_CMD_LINK_STATS 0x71 // link_stats.c
+#define RAWHID_CMD_SCAN_PROF  0x72 // scan_prof.c
+#define RAWHID_CMD_SENSOR     0x73 // tb_split.c（左右のセンサのサンプリング統計）
+#define RAWHID_CMD_TB_ACCEL   0x74 // tb.c（加速カーブ）
+#define RAWHID_CMD_TB_SAVE    0x75 // tb.c（設定保存のカウンタ）
+
+#define RAWHID_ERR 0xFF
+
+static inline void rawhid_put_u16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static inline void rawhid_put_u32(uint8_t* p, uint32_t v) {
+    rawhid_put_u16(p, v & 0xFFFF);
+    rawhid_put_u16(p + 2, v >> 16);
+}
+
+static inline uint16_t rawhid_get_u16(const uint8_t* p) { return p[0] | (p[1] << 8); }
@@ -3,11 +3,97 @@ VIAL_ENABLE = yes
 VIAL_INSECURE = yes
 
 POINTING_DEVICE_ENABLE = yes
-SPLIT_POINTING_ENABLE = yes
-POINTING_DEVICE_COMBINED = yes
 POINTING_DEVICE_DRIVER = custom
+# PAW3222 bus backend: pio (default), bitbang, or mock
+PAW3222_BUS_DRIVER ?= pio
 SRC += paw3222.c
+SRC += paw3222_bus_$(PAW3222_BUS_DRIVER).c
+# Poll the sensor on core 1 and hand deltas to core 0 over the SIO FIFO.
+# Only the bus reads move; the transform and the rest of QMK stay on core 0.
+# Needs the pio backend (bitbang relies on ChibiOS delays that are core 0 only).
+PAW3222_CORE1 ?= no
+ifeq ($(strip $(PAW3222_CORE1)), yes)
+    ifneq ($(strip $(PAW3222_BUS_DRIVER)), pio)
+        $(error PAW3222_CORE1 requires PAW3222_BUS_DRIVER = pio)
+    endif
+    OPT_DEFS += -DPAW3222_CORE1
+    SRC += paw3222_core1.c
+    LDFLAGS += -Wl,-wrap=backing_store_unlock -Wl,-wrap=backing_store_lock
+endif
+# Board-specific matrix scan (matrix.c): one SIO read per row and a settle
+# wait only while a column is still recovering. Set to no for the stock QMK
+# matrix, e.g. to compare SCAN_PROF_MATRIX in scripts/scan_prof.py.
+FAST_MATRIX_ENABLE ?= yes
+ifeq ($(strip $(FAST_MATRIX_ENABLE)), yes)
+    CUSTOM_MATRIX = lite
+    SRC += matrix.c
+endif
+# Advertise the wheel Resolution Multiplier and send scroll in 1/120 steps
+# (tb.c, sc_hires). Off by default: hosts that ignore the multiplier (macOS)
+# would scroll 120x faster after an upgrade. See readme.md.
+HIRES_SCROLL_ENABLE ?= no
+ifeq ($(strip $(HIRES_SCROLL_ENABLE)), yes)
+    OPT_DEFS += -DPOINTING_DEVICE_HIRES_SCROLL_ENABLE
+endif
+# Per-key eager press / deferred release (debounce_eager.c). Thresholds are
+# DEBOUNCE_PRESS_MS / DEBOUNCE_RELEASE_MS in config.h; scripts/debounce_sim
+# replays chattering switches through it on the host.
+DEBOUNCE_TYPE = custom
+SRC += debounce_eager.c
+CRC_ENABLE = yes
 SRC += tb.c
+SRC += tb_xform.c
+SRC += tb_split.c
+
+# Raw sensor trace over Vial raw HID (scripts/tb_trace_dump.py)
+TB_TRACE_ENABLE ?= yes
+ifeq ($(strip $(TB_TRACE_ENABLE)), yes)
+    OPT_DEFS += -DTB_TRACE_ENABLE
+    SRC += tb_trace.c
+endif
+
+# Split link counters over Vial raw HID (scripts/link_stats.py)
+LINK_STATS_ENABLE ?= yes
+ifeq ($(strip $(LINK_STATS_ENABLE)), yes)
+    OPT_DEFS += -DLINK_STATS_ENABLE
+    SRC += link_stats.c
+    LDFLAGS += -Wl,-wrap=soft_serial_transaction
+endif
+
+# Per-stage main loop timing over Vial raw HID (scripts/scan_prof.py).
+# Off by default; when off, the SCAN_PROF_* hooks compile to nothing.
+SCAN_PROFILER_ENABLE ?= no
+ifeq ($(strip $(SCAN_PROFILER_ENABLE)), yes)
+    OPT_DEFS += -DSCAN_PROFILER_ENABLE
+    SRC += scan_prof.c
+    LDFLAGS += -Wl,-wrap=matrix_scan -Wl,-wrap=transport_master
+    LDFLAGS += -Wl,-wrap=host_keyboard_send -Wl,-wrap=host_mouse_send
+endif
+
+# Time the fixed-point transform against the old float one on the board and
+# print the result to the console once after boot (tb_bench.c).
+TB_BENCH_ENABLE ?= no
+ifeq ($(strip $(TB_BENCH_ENABLE)), yes)
+    CONSOLE_ENABLE = yes
+    OPT_DEFS += -DTB_BENCH_ENABLE
+    SRC += tb_bench.c tb_float_ref.c
+endif
+
+# Per-position resolved layer/keycode cache (layer_cache.c, scripts/layer_bench)
+LAYER_CACHE_ENABLE ?= yes
+ifeq ($(strip $(LAYER_CACHE_ENABLE)), yes)
+    OPT_DEFS += -DLAYER_CACHE_ENABLE
+    SRC += layer_cache.c
+    LDFLAGS += -Wl,-wrap=action_for_key
+    LDFLAGS += -Wl,-wrap=dynamic_keymap_set_keycode -Wl,-wrap=dynamic_keymap_set_buffer
+endif
+
+# Keycode index in front of QMK's per-event combo scan (combo_index.c, scripts/combo_test)
+COMBO_INDEX_ENABLE ?= yes
+ifeq ($(strip $(COMBO_INDEX_ENABLE)), yes)
+    SRC += combo_index.c
+    LDFLAGS += -Wl,-wrap=process_combo -Wl,-wrap=dynamic_keymap_set_combo
+endif
 
 # Override dynamic_keymap_reset
 LDFLAGS += -Wl,-wrap=dynamic_keymap_reset
\ No newline at end of file
@@ -0,0 +1,124 @@
+// keyboards/split_ortho4x6/keymaps/vial/scan_prof.c
+
+#include "scan_prof.h"
+#include "quantum.h"
+#include "raw_hid.h"
+#include "rawhid_cmd.h"
+#include <string.h>
+
+static scan_prof_stat_t g_prof[SCAN_PROF_STAGES];
+static uint32_t         g_since;     // リセットした時刻 (ms)
+static uint32_t         g_last_loop; // 直前の housekeeping_task (us)
+static uint32_t         g_split_us;  // matrix_scan() 中に transport_master() で使った時間
+
+void scan_prof_record(scan_prof_stage_t stage, uint32_t us) {
+    scan_prof_stat_t* s = &g_prof[stage];
+
+    if (s->count == 0 || us < s->min) s->min = us;
+    if (us > s->max) s->max = us;
+    s->sum += us;
+    s->count++;
+
+    uint8_t b = 0;
+    for (uint32_t r = us >> 3; r && b < SCAN_PROF_BUCKETS - 1; r >>= 1) b++;
+    s->hist[b]++;
+}
+
+void scan_prof_loop_tick(void) {
+    uint32_t now = timer_read_us();
+    if (g_last_loop) scan_prof_record(SCAN_PROF_LOOP, now - g_last_loop);
+    g_last_loop = now;
+}
+
+void scan_prof_reset(void) {
+    memset(g_prof, 0, sizeof(g_prof));
+    g_since     = timer_read32();
+    g_last_loop = 0;
+}
+
+const scan_prof_stat_t* scan_prof_get(scan_prof_stage_t stage) { return stage < SCAN_PROF_STAGES ? &g_prof[stage] : NULL; }
+
+// ====== QMK core wrappers (-Wl,-wrap) ============================
+uint8_t __real_matrix_scan(void);
+bool    __real_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+void    __real_host_keyboard_send(report_keyboard_t* report);
+void    __real_host_mouse_send(report_mouse_t* report);
+
+uint8_t __wrap_matrix_scan(void) {
+    g_split_us = 0;
+    uint32_t t0      = timer_read_us();
+    uint8_t  changed = __real_matrix_scan();
+    scan_prof_record(SCAN_PROF_MATRIX, timer_read_us() - t0 - g_split_us);
+    return changed;
+}
+
+// スプリット時は matrix_scan() の中から呼ばれる
+bool __wrap_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint32_t t0 = timer_read_us();
+    bool     ok = __real_transport_master(master_matrix, slave_matrix);
+    uint32_t us = timer_read_us() - t0;
+    g_split_us += us;
+    scan_prof_record(SCAN_PROF_SPLIT, us);
+    return ok;
+}
+
+void __wrap_host_keyboard_send(report_keyboard_t* report) {
+    SCAN_PROF_BEGIN(SCAN_PROF_USB);
+    __real_host_keyboard_send(report);
+    SCAN_PROF_END(SCAN_PROF_USB);
+}
+
+void __wrap_host_mouse_send(report_mouse_t* report) {
+    SCAN_PROF_BEGIN(SCAN_PROF_USB);
+    __real_host_mouse_send(report);
+    SCAN_PROF_END(SCAN_PROF_USB);
+}
+
+// ====== Raw HID ==================================================
+enum scan_prof_subcmd {
+    SCAN_PROF_RESET = 0x01,
+    SCAN_PROF_INFO  = 0x02,
+    SCAN_PROF_READ  = 0x03, // data[2]: 段階, data[3]: 0 = 回数/min/max/合計, 1,2 = ヒストグラムの前半/後半
+};
+
+#define HIST_PER_PART (SCAN_PROF_BUCKETS / 2)
+
+_Static_assert(4 + 4 * HIST_PER_PART <= RAW_EPSIZE, "histogram part does not fit in a raw HID packet");
+
+void scan_prof_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t* body = &data[4];
+
+    switch (data[1]) {
+        case SCAN_PROF_RESET:
+            scan_prof_reset();
+            break;
+        case SCAN_PROF_INFO:
+            memset(&data[2], 0, length - 2);
+            data[2] = SCAN_PROF_STAGES;
+            data[3] = SCAN_PROF_BUCKETS;
+            rawhid_put_u32(&body[0], timer_elapsed32(g_since));
+            break;
+        case SCAN_PROF_READ: {
+            const scan_prof_stat_t* s = scan_prof_get(data[2]);
+            if (!s || data[3] > 2) {
+                data[1] = RAWHID_ERR;
+                break;
+            }
+            memset(body, 0, length - 4);
+            if (data[3] == 0) {
+                rawhid_put_u32(&body[0], s->count);
+                rawhid_put_u32(&body[4], s->min);
+                rawhid_put_u32(&body[8], s->max);
+                rawhid_put_u32(&body[12], (uint32_t)s->sum);
+                rawhid_put_u32(&body[16], (uint32_t)(s->sum >> 32));
+            } else {
+                const uint32_t* h = &s->hist[(data[3] - 1) * HIST_PER_PART];
+                for (uint8_t i = 0; i < HIST_PER_PART; ++i) rawhid_put_u32(&body[4 * i], h[i]);
+            }
+            break;
+        }
+        default:
+            data[1] = RAWHID_ERR;
+            break;
+    }
+}
@@ -0,0 +1,52 @@
+// keyboards/split_ortho4x6/keymaps/vial/scan_prof.h
+#pragma once
+// メインループの段階ごとの所要時間（µs）を RAM に集計するプロファイラ。
+// SCAN_PROFILER_ENABLE を定義しない限り、下のマクロは空になり何も残らない。
+// 読み出しは scripts/scan_prof.py。
+//
+// QMK 本体側の段階（マトリクス走査、スプリット同期、USB 送信）はリンカの
+// -wrap で包み、自前のコード（センサ読み出し、変換）は SCAN_PROF_BEGIN/END で囲む。
+// 呼び出し側は #ifdef で囲まずにこのヘッダを include してマクロを置く（キーボード側の
+// paw3222.c も同じ）。そのため無効時はここ以外のヘッダに依存させないこと。
+
+#include <stdint.h>
+
+typedef enum {
+    SCAN_PROF_LOOP,     // housekeeping_task 間の間隔 = メインループ 1 周
+    SCAN_PROF_MATRIX,   // matrix_scan()（スプリット同期の分は除く）
+    SCAN_PROF_SPLIT,    // transport_master()（マトリクス等の同期）
+    SCAN_PROF_SPLIT_TB, // 右トラックボールの RPC（tb_split.c）
+    SCAN_PROF_SENSOR,   // サンプラのバス読み出し 1 回（paw3222_sample()）。PAW3222_CORE1 では
+                        // バスはコア 1 が読むので、代わりに FIFO の取り出し（paw3222_core1_take()）
+    SCAN_PROF_XFORM,    // tb_task_combined()
+    SCAN_PROF_USB,      // host_keyboard_send() / host_mouse_send()
+    SCAN_PROF_STAGES,
+} scan_prof_stage_t;
+
+#define SCAN_PROF_BUCKETS 12 // <8us, <16us, ... , <8192us, >=8192us
+
+#ifdef SCAN_PROFILER_ENABLE
+#    include "timer_us.h"
+
+typedef struct {
+    uint32_t count;
+    uint32_t min, max; // us
+    uint64_t sum;      // us
+    uint32_t hist[SCAN_PROF_BUCKETS];
+} scan_prof_stat_t;
+
+void scan_prof_record(scan_prof_stage_t stage, uint32_t us);
+void scan_prof_loop_tick(void);
+void scan_prof_reset(void);
+const scan_prof_stat_t* scan_prof_get(scan_prof_stage_t stage);
+
+void scan_prof_raw_hid(uint8_t* data, uint8_t length); // RAWHID_CMD_SCAN_PROF
+
+#    define SCAN_PROF_BEGIN(stage) uint32_t scan_prof_t0_##stage = timer_read_us()
+#    define SCAN_PROF_END(stage) scan_prof_record(stage, timer_read_us() - scan_prof_t0_##stage)
+#    define SCAN_PROF_LOOP_TICK() scan_prof_loop_tick()
+#else
+#    define SCAN_PROF_BEGIN(stage) ((void)0)
+#    define SCAN_PROF_END(stage) ((void)0)
+#    define SCAN_PROF_LOOP_TICK() ((void)0)
+#endif
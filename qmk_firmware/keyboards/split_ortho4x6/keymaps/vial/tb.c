@@ -1,9 +1,16 @@
 // keyboards/split_ortho4x6/keymaps/vial/tb.c
 
 #include "tb.h"
+#include "tb_xform.h"
 #include "quantum.h"
 #include "pointing_device.h"
-#include <math.h>
+#include "crc.h"
+#include "paw3222.h"
+#include "tb_split.h"
+#include "raw_hid.h"
+#include "rawhid_cmd.h"
+#include <stddef.h>
+#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -13,124 +20,400 @@
 #ifndef COCOT_SCROLL_INV_DEFAULT
 #    define COCOT_SCROLL_INV_DEFAULT true
 #endif
+// HIRES_SCROLL_ENABLE=yes（rules.mk）でディスクリプタに Resolution Multiplier を載せると、
+// Windows/Linux は 120 で 1 ステップとして扱うため、ステップ送りでは 1/120 の速さになる。
+// 既定は高解像度とし、Multiplier を無視する macOS（高解像度だと 120 倍速になる）では
+// TB_SCR_HIRES でステップ送りに切り替える。HIRES_SCROLL_ENABLE=no では常にステップ送りで、
+// 保存する設定（トレースにも載る）もそれに合わせる
+#ifndef TB_SCROLL_HIRES_DEFAULT
+#    ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#        define TB_SCROLL_HIRES_DEFAULT true
+#    else
+#        define TB_SCROLL_HIRES_DEFAULT false
+#    endif
+#endif
 
+// キー操作で巡回する候補値。設定そのものは任意の値を保持できる。
 static const uint16_t k_cpi_opts[] = {200, 400, 800, 1600, 3200};
-static const uint8_t  k_scr_divs[] = {1, 2, 3, 4, 5, 6}; // shift amount
-// 15度刻みで -180..+180 をサポート
-static const int16_t  k_angles[]   = {
-    -180, -165, -150, -135, -120, -105, -90, -75, -60, -45, -30, -15,
-       0,   15,   30,   45,   60,   75,   90,  105,  120,  135,  150,  165,  180
-};
+static const uint8_t  k_scr_divs[] = {2, 4, 8, 16, 32, 64};
 
 #define CPI_OPTION_SIZE (sizeof(k_cpi_opts) / sizeof(k_cpi_opts[0]))
 #define SCRL_DIV_SIZE   (sizeof(k_scr_divs) / sizeof(k_scr_divs[0]))
-#define ANGLE_SIZE      (sizeof(k_angles)   / sizeof(k_angles[0]))
 
-typedef struct {
-    uint8_t cpi_idx;        // 0..CPI_OPTION_SIZE-1
-    uint8_t rot_idx;        // 0..ANGLE_SIZE-1
-    bool    scroll_mode;    // per-side scroll mode
-} tb_side_t;
-
-static tb_side_t gL, gR;
-static bool      g_scrl_inv = COCOT_SCROLL_INV_DEFAULT;
-static uint8_t   g_scrl_div = 4; // default divider index
+#define TB_ROT_STEP 15 // 回転キー 1 回あたりの角度
 
 // ====== Scroll curve parameters (global) =========================
-// sc_gain 調整用の候補値（7段階、0.5..2.0）
-static const float k_sc_gain_table[] = {
-    0.50f, 0.75f, 1.00f, 1.25f, 1.50f, 1.75f, 2.00f
-};
-#define SC_GAIN_SIZE (sizeof(k_sc_gain_table)/sizeof(k_sc_gain_table[0]))
-
-// sc_gamma 調整用の候補値（5段階、0.50..1.50、0.25刻み）
-static const float k_sc_gamma_table[] = {
-    0.50f, 0.75f, 1.00f, 1.25f, 1.50f
+// sc_gain は 0.50..2.00 を 0.10 刻み、sc_gamma は 0.50..1.50 を 0.25 刻みで調整（x100）
+#define SC_GAIN_MIN    50
+#define SC_GAIN_MAX    200
+#define SC_GAIN_STEP   10
+#define SC_GAMMA_MIN   50
+#define SC_GAMMA_MAX   150
+#define SC_GAMMA_STEP  25
+#define SC_GAIN_DEF    125
+#define SC_GAMMA_DEF   75
+
+static tb_config_t g_cfg;
+_Static_assert(sizeof(tb_config_t) <= EECONFIG_KB_DATA_SIZE, "tb_config_t does not fit in EECONFIG_KB_DATA_SIZE");
+
+// ====== Transform state ==========================================
+// 演算本体は tb_xform.c。ここでは設定から導出した値と左右の状態を持つ。
+static tb_xform_t  gXL, gXR;
+static tb_scroll_t g_sc;
+static uint16_t    g_sc_lut_gain, g_sc_lut_gamma; // LUT 構築時の値（0 = 未構築）
+
+// ====== Legacy 32-bit config =====================================
+// 旧形式（eeconfig_kb にテーブルのインデックスを詰めたもの）からの移行用
+static const int16_t k_legacy_angles[] = {
+    -180, -165, -150, -135, -120, -105, -90, -75, -60, -45, -30, -15,
+       0,   15,   30,   45,   60,   75,   90,  105,  120,  135,  150,  165,  180
 };
-#define SC_GAMMA_SIZE (sizeof(k_sc_gamma_table)/sizeof(k_sc_gamma_table[0]))
-
-// 初期インデックスは有効範囲内に設定（tb_loadで上書きされる前提でも安全側に）
-static uint8_t g_sc_gain_idx = 3;   // 1.25
-static uint8_t g_sc_gamma_idx = 1;  // 0.75
-
-// ====== EEPROM pack/unpack =======================================
-static inline uint32_t pack_cfg(void) {
-    uint32_t v = 0;
-    v |= (uint32_t)(gL.cpi_idx & 0xF)      << 0;  // 4 bits
-    v |= (uint32_t)(gL.rot_idx & 0x1F)     << 4;  // 5 bits
-    v |= (uint32_t)(gL.scroll_mode ? 1:0)  << 9;  // 1 bit
-    v |= (uint32_t)(gR.cpi_idx & 0xF)      << 10; // 4 bits
-    v |= (uint32_t)(gR.rot_idx & 0x1F)     << 14; // 5 bits
-    v |= (uint32_t)(gR.scroll_mode ? 1:0)  << 19; // 1 bit
-    v |= (uint32_t)(g_scrl_inv ? 1:0)      << 20; // 1 bit
-    v |= (uint32_t)(g_scrl_div & 0x7)      << 21; // 3 bits
-    v |= (uint32_t)(g_sc_gamma_idx & 0xF)  << 24; // 4 bits
-    v |= (uint32_t)(g_sc_gain_idx & 0xF)   << 28; // 4 bits
-    return v;
+static const uint16_t k_legacy_gains[]  = {50, 75, 100, 125, 150, 175, 200};
+static const uint16_t k_legacy_gammas[] = {50, 75, 100, 125, 150};
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+static bool tb_migrate_legacy(uint32_t v, tb_config_t* c) {
+    uint8_t l_cpi = (v >> 0) & 0xF, l_rot = (v >> 4) & 0x1F;
+    uint8_t r_cpi = (v >> 10) & 0xF, r_rot = (v >> 14) & 0x1F;
+    uint8_t div = (v >> 21) & 0x7, gamma = (v >> 24) & 0xF, gain = (v >> 28) & 0xF;
+
+    if (l_cpi >= CPI_OPTION_SIZE || r_cpi >= CPI_OPTION_SIZE) return false;
+    if (l_rot >= ARRAY_LEN(k_legacy_angles) || r_rot >= ARRAY_LEN(k_legacy_angles)) return false;
+    if (div >= SCRL_DIV_SIZE) return false;
+    if (gain >= ARRAY_LEN(k_legacy_gains) || gamma >= ARRAY_LEN(k_legacy_gammas)) return false;
+
+    c->side[0].cpi         = k_cpi_opts[l_cpi];
+    c->side[0].rot_deg     = k_legacy_angles[l_rot];
+    c->side[0].scroll_mode = (v >> 9) & 1;
+    c->side[1].cpi         = k_cpi_opts[r_cpi];
+    c->side[1].rot_deg     = k_legacy_angles[r_rot];
+    c->side[1].scroll_mode = (v >> 19) & 1;
+    c->sc_inv              = (v >> 20) & 1;
+    c->sc_div              = k_scr_divs[div];
+    c->sc_gamma            = k_legacy_gammas[gamma];
+    c->sc_gain             = k_legacy_gains[gain];
+    return true;
 }
 
-static inline void unpack_cfg(uint32_t v) {
-    gL.cpi_idx     = (v >> 0)  & 0xF;
-    gL.rot_idx     = (v >> 4)  & 0x1F;
-    gL.scroll_mode = ((v >> 9)  & 1) != 0;
-    gR.cpi_idx     = (v >> 10) & 0xF;
-    gR.rot_idx     = (v >> 14) & 0x1F;
-    gR.scroll_mode = ((v >> 19) & 1) != 0;
-    g_scrl_inv     = ((v >> 20) & 1) != 0;
-    g_scrl_div     = (v >> 21) & 0x7;
-    g_sc_gamma_idx = (v >> 24) & 0xF;
-    g_sc_gain_idx  = (v >> 28) & 0xF;
+// ====== Deferred save ============================================
+// RP2040 の EEPROM はフラッシュのエミュレーションなので、キー操作の度に書くと
+// 消去待ちでスキャンが止まり、書き換え回数も消費する。変更は dirty として
+// 記録だけしておき、操作が TB_SAVE_DELAY_MS 途切れた時点でまとめて書く。
+#ifndef TB_SAVE_DELAY_MS
+#    define TB_SAVE_DELAY_MS 3000
+#endif
+
+static bool            g_dirty;
+static uint32_t        g_dirty_since;
+static tb_config_t     g_saved_cfg; // 最後に EEPROM にある値
+static tb_save_stats_t g_save_stats;
+
+#define CFG_BODY(c)    ((uint8_t*)(c) + offsetof(tb_config_t, side))
+#define CFG_BODY_SIZE  (sizeof(tb_config_t) - offsetof(tb_config_t, side))
+
+static void tb_save_now(void) {
+    g_cfg.version = TB_CONFIG_VERSION;
+    g_cfg.size    = sizeof(tb_config_t);
+    g_cfg.crc     = crc8(CFG_BODY(&g_cfg), CFG_BODY_SIZE);
+    g_saved_cfg   = g_cfg;
+    eeconfig_update_kb_datablock(&g_cfg, 0, sizeof(g_cfg));
+    g_save_stats.writes++;
 }
 
-static inline void tb_save(void) { eeconfig_update_kb(pack_cfg()); }
+static inline void tb_save(void) {
+    g_save_stats.requests++;
+    if (g_dirty) g_save_stats.coalesced++;
+    g_dirty       = true;
+    g_dirty_since = timer_read32();
+}
 
-static uint8_t rot_index_for_angle(int16_t deg) {
-    for (uint8_t i = 0; i < ANGLE_SIZE; ++i) {
-        if (k_angles[i] == deg) return i;
+static void tb_commit(void) {
+    if (!g_dirty) return;
+    g_dirty = false;
+    // 行って戻った場合など、内容が同じなら書かない
+    if (memcmp(CFG_BODY(&g_cfg), CFG_BODY(&g_saved_cfg), CFG_BODY_SIZE) == 0) {
+        g_save_stats.unchanged++;
+        return;
     }
-    return 0; // fallback
+    tb_save_now();
 }
 
-static void tb_defaults(void) {
-    gL.cpi_idx = 3; // 1600
-    gL.rot_idx = rot_index_for_angle(90);
-    gL.scroll_mode = true;
+// ====== EEPROM load ==============================================
+static void tb_accel_defaults(tb_config_t* c, uint8_t side) {
+    static const tb_accel_pt_t k_accel_default[] = TB_ACCEL_DEFAULT;
 
-    gR.cpi_idx = 3; // 1600
-    gR.rot_idx = rot_index_for_angle(-90);
-    gR.scroll_mode = false;
+    memset(c->accel[side], 0, sizeof(c->accel[side]));
+    memcpy(c->accel[side], k_accel_default, sizeof(k_accel_default));
+    c->accel_n[side] = TB_ACCEL_DEFAULT_N;
+}
+
+static void tb_defaults(tb_config_t* c) {
+    c->side[0].cpi         = 1600;
+    c->side[0].rot_deg     = 90;
+    c->side[0].scroll_mode = true;
+
+    c->side[1].cpi         = 1600;
+    c->side[1].rot_deg     = -90;
+    c->side[1].scroll_mode = false;
+
+    c->sc_inv   = COCOT_SCROLL_INV_DEFAULT;
+    c->sc_div   = 32;
+    c->sc_gain  = SC_GAIN_DEF;
+    c->sc_gamma = SC_GAMMA_DEF;
+    c->sc_hires = TB_SCROLL_HIRES_DEFAULT;
 
-    g_scrl_inv = COCOT_SCROLL_INV_DEFAULT;
-    g_scrl_div = 4; // >> 5
-    g_sc_gain_idx = 3;  // 1.25
-    g_sc_gamma_idx = 1; // 0.75
+    c->filter[0] = TB_FILTER_IIR;
+    c->filter[1] = TB_FILTER_IIR;
+
+    for (uint8_t i = 0; i < 2; ++i) tb_accel_defaults(c, i);
 }
 
+static bool tb_config_valid(const tb_config_t* c) {
+    for (uint8_t i = 0; i < 2; ++i) {
+        if (c->side[i].cpi < k_cpi_opts[0] || c->side[i].cpi > k_cpi_opts[CPI_OPTION_SIZE - 1]) return false;
+        if (c->side[i].rot_deg < -180 || c->side[i].rot_deg > 180) return false;
+        if (c->filter[i] >= TB_FILTER_COUNT) return false;
+        if (!tb_accel_valid(c->accel[i], c->accel_n[i])) return false;
+    }
+    if (c->sc_div == 0) return false;
+    if (c->sc_gain < SC_GAIN_MIN || c->sc_gain > SC_GAIN_MAX) return false;
+    if (c->sc_gamma < SC_GAMMA_MIN || c->sc_gamma > SC_GAMMA_MAX) return false;
+    if (c->sc_hires > 1) return false;
+    return true;
+}
+
+// データブロック -> 旧 32bit 形式 -> 既定値 の順に試す
 static void tb_load(void) {
+    tb_config_t stored;
+    eeconfig_read_kb_datablock(&stored, 0, sizeof(stored));
+
+    tb_defaults(&g_cfg);
+    if (stored.version >= 1 && stored.version <= TB_CONFIG_VERSION &&
+        stored.size > offsetof(tb_config_t, side) && stored.size <= sizeof(stored) &&
+        stored.crc == crc8(CFG_BODY(&stored), stored.size - offsetof(tb_config_t, side))) {
+        // 古いバージョンで足りないフィールドは既定値のまま
+        memcpy(CFG_BODY(&g_cfg), CFG_BODY(&stored), stored.size - offsetof(tb_config_t, side));
+        if (tb_config_valid(&g_cfg)) {
+            g_saved_cfg = g_cfg;
+            if (stored.version != TB_CONFIG_VERSION) tb_save_now();
+            return;
+        }
+        tb_defaults(&g_cfg);
+    }
+
     uint32_t raw = eeconfig_read_kb();
-    if (raw == 0 || raw == 0xFFFFFFFFu) {
-        tb_defaults();
-        tb_save();
-        return;
+    if (raw != 0 && raw != 0xFFFFFFFFu && !tb_migrate_legacy(raw, &g_cfg)) tb_defaults(&g_cfg);
+    tb_save_now();
+}
+
+// ====== Sensor CPI ===============================================
+// CPI はセンサのレジスタで設定する（相手側は tb_split のポーリングで送る）。
+// センサの下限を下回る分だけ tb_xform 側のゲインで補う。
+static uint16_t g_hw_cpi[2]; // センサに設定した値（0 = 未設定）
+
+static uint16_t tb_hw_cpi(uint16_t cpi) {
+    if (cpi < PAW3222_CPI_MIN) cpi = PAW3222_CPI_MIN;
+    if (cpi > PAW3222_CPI_MAX) cpi = PAW3222_CPI_MAX;
+    return (cpi + PAW3222_CPI_STEP / 2) / PAW3222_CPI_STEP * PAW3222_CPI_STEP;
+}
+
+static void tb_apply_cpi(uint8_t side) {
+    uint16_t hw = tb_hw_cpi(g_cfg.side[side].cpi);
+    if (hw == g_hw_cpi[side]) return;
+    g_hw_cpi[side] = hw;
+    if ((side == 0) == is_keyboard_left()) {
+        pointing_device_set_cpi(hw);
+    } else {
+        tb_split_set_remote_cpi(hw);
+    }
+}
+
+// 1 ステップの分割数（POINTING_DEVICE_HIRES_SCROLL_ENABLE 無しでは常に 1）
+static uint16_t tb_scroll_resolution(void) {
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    if (g_cfg.sc_hires) return pointing_device_get_hires_scroll_resolution();
+#endif
+    return 1;
+}
+
+// 設定値を変換パラメータへ反映する（設定変更時のみ）
+static void tb_apply_settings(void) {
+    tb_apply_cpi(0);
+    tb_apply_cpi(1);
+
+    gXL.rot      = tb_rot_from_deg(g_cfg.side[0].rot_deg);
+    gXL.gain_q8  = tb_cpi_gain_q8(g_cfg.side[0].cpi, g_hw_cpi[0]);
+    gXL.speed_q8 = tb_speed_norm_q8(g_hw_cpi[0]);
+    gXL.scroll   = g_cfg.side[0].scroll_mode;
+    gXL.filter   = g_cfg.filter[0];
+    tb_accel_build(&gXL.accel, g_cfg.accel[0], g_cfg.accel_n[0]);
+    gXR.rot      = tb_rot_from_deg(g_cfg.side[1].rot_deg);
+    gXR.gain_q8  = tb_cpi_gain_q8(g_cfg.side[1].cpi, g_hw_cpi[1]);
+    gXR.speed_q8 = tb_speed_norm_q8(g_hw_cpi[1]);
+    gXR.scroll   = false; // 右はカーソル固定
+    gXR.filter   = g_cfg.filter[1];
+    tb_accel_build(&gXR.accel, g_cfg.accel[1], g_cfg.accel_n[1]);
+
+    g_sc.unit = (int32_t)g_cfg.sc_div * TB_ONE;
+    g_sc.inv  = g_cfg.sc_inv;
+    uint16_t hires = tb_scroll_resolution();
+    if (hires != g_sc.hires) {
+        // 端数の単位が変わるので捨てる
+        g_sc.hires = hires;
+        gXL.acc_h = gXL.acc_v = 0;
+        gXR.acc_h = gXR.acc_v = 0;
     }
-    unpack_cfg(raw);
-    bool bad = false;
-    if (gL.cpi_idx >= CPI_OPTION_SIZE || gR.cpi_idx >= CPI_OPTION_SIZE) bad = true;
-    if (gL.rot_idx >= ANGLE_SIZE || gR.rot_idx >= ANGLE_SIZE) bad = true;
-    if (g_scrl_div >= SCRL_DIV_SIZE) bad = true;
-    if (g_sc_gain_idx >= SC_GAIN_SIZE) bad = true;
-    if (g_sc_gamma_idx >= SC_GAMMA_SIZE) bad = true;
-    if (bad) {
-        tb_defaults();
-        tb_save();
+    if (g_cfg.sc_gain != g_sc_lut_gain || g_cfg.sc_gamma != g_sc_lut_gamma) {
+        tb_scroll_build(&g_sc, g_cfg.sc_gain / 100.0f, g_cfg.sc_gamma / 100.0f);
+        g_sc_lut_gain  = g_cfg.sc_gain;
+        g_sc_lut_gamma = g_cfg.sc_gamma;
     }
 }
 
+static inline void tb_settings_changed(void) {
+    tb_apply_settings();
+    tb_save();
+}
+
+// ====== Key helpers ==============================================
+// 現在値より大きい/小さい候補へ移る（端で反対側へ巡回）
+static uint16_t cpi_step(uint16_t cpi, bool up) {
+    if (up) {
+        for (uint8_t i = 0; i < CPI_OPTION_SIZE; ++i) {
+            if (k_cpi_opts[i] > cpi) return k_cpi_opts[i];
+        }
+        return k_cpi_opts[0];
+    }
+    for (uint8_t i = CPI_OPTION_SIZE; i-- > 0;) {
+        if (k_cpi_opts[i] < cpi) return k_cpi_opts[i];
+    }
+    return k_cpi_opts[CPI_OPTION_SIZE - 1];
+}
+
+// -180..180 に正規化（-180 と 180 は同じ向き）
+static int16_t rot_step(int16_t deg, int16_t delta) {
+    int16_t d = deg + delta;
+    if (d > 180) d -= 360;
+    if (d < -180) d += 360;
+    return d;
+}
+
+static uint8_t div_step(uint8_t div) {
+    for (uint8_t i = 0; i < SCRL_DIV_SIZE; ++i) {
+        if (k_scr_divs[i] > div) return k_scr_divs[i];
+    }
+    return k_scr_divs[0];
+}
+
+static uint16_t clamp_u16(int32_t v, uint16_t lo, uint16_t hi) {
+    return v < lo ? lo : (v > hi ? hi : (uint16_t)v);
+}
+
+static int16_t add_sat(int16_t a, int16_t b, int16_t lo, int16_t hi) {
+    int32_t v = (int32_t)a + b;
+    return v < lo ? lo : (v > hi ? hi : (int16_t)v);
+}
+
 // ====== Public API ===============================================
-void tb_init(void) { tb_load(); }
+void tb_init(void) {
+    tb_load();
+    tb_xform_reset(&gXL);
+    tb_xform_reset(&gXR);
+    tb_apply_settings();
+}
+
+const tb_config_t* tb_get_config(void) {
+    g_cfg.version = TB_CONFIG_VERSION;
+    g_cfg.size    = sizeof(tb_config_t);
+    g_cfg.crc     = crc8(CFG_BODY(&g_cfg), CFG_BODY_SIZE);
+    return &g_cfg;
+}
+
+void tb_task(void) {
+    if (g_dirty && timer_elapsed32(g_dirty_since) >= TB_SAVE_DELAY_MS) tb_commit();
+}
+
+void tb_flush(void) { tb_commit(); }
+
+const tb_save_stats_t* tb_get_save_stats(void) { return &g_save_stats; }
+
+// ====== Save counters over raw HID ===============================
+// トレース（TB_TRACE_ENABLE）の有無に関係なく読めるよう、ここで応答する
+enum tb_save_subcmd {
+    TB_SAVE_STATS = 0x01, // 応答: tb_save_stats_t の 4 値（各 u32）, 未保存の変更の有無（u8）
+};
+
+void tb_save_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t* body = &data[2];
+
+    switch (data[1]) {
+        case TB_SAVE_STATS:
+            memset(body, 0, length - 2);
+            rawhid_put_u32(&body[0], g_save_stats.requests);
+            rawhid_put_u32(&body[4], g_save_stats.coalesced);
+            rawhid_put_u32(&body[8], g_save_stats.unchanged);
+            rawhid_put_u32(&body[12], g_save_stats.writes);
+            body[16] = g_dirty;
+            break;
+        default:
+            data[1] = RAWHID_ERR;
+            break;
+    }
+}
+
+// ====== Acceleration curve over raw HID ==========================
+// 応答/要求とも data[2] = 側 (0 = 左, 1 = 右), data[3] = 点の数, data[4..] = 点
+// （tb_accel_pt_t の並び）。書き込みはその場で反映し、保存は通常どおり遅延させる。
+enum tb_accel_subcmd {
+    TB_ACCEL_GET   = 0x01,
+    TB_ACCEL_SET   = 0x02,
+    TB_ACCEL_RESET = 0x03, // 既定のカーブに戻す
+};
+
+_Static_assert(4 + sizeof(g_cfg.accel[0]) <= RAW_EPSIZE, "acceleration curve does not fit in a raw HID packet");
+
+void tb_accel_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t side = data[2];
+    if (side > 1) {
+        data[1] = RAWHID_ERR;
+        return;
+    }
+
+    switch (data[1]) {
+        case TB_ACCEL_GET:
+            break;
+        case TB_ACCEL_SET: {
+            uint8_t              n   = data[3];
+            const tb_accel_pt_t* pts = (const tb_accel_pt_t*)&data[4];
+            if (!tb_accel_valid(pts, n)) {
+                data[1] = RAWHID_ERR;
+                return;
+            }
+            memset(g_cfg.accel[side], 0, sizeof(g_cfg.accel[side]));
+            memcpy(g_cfg.accel[side], pts, n * sizeof(tb_accel_pt_t));
+            g_cfg.accel_n[side] = n;
+            tb_settings_changed();
+            break;
+        }
+        case TB_ACCEL_RESET:
+            tb_accel_defaults(&g_cfg, side);
+            tb_settings_changed();
+            break;
+        default:
+            data[1] = RAWHID_ERR;
+            return;
+    }
+
+    memset(&data[3], 0, length - 3);
+    data[3] = g_cfg.accel_n[side];
+    memcpy(&data[4], g_cfg.accel[side], sizeof(g_cfg.accel[side]));
+}
 
 bool tb_process_record(uint16_t keycode, keyrecord_t* record) {
     // process_record_user() から本関数が呼ばれるため、ここで再帰呼出ししないこと。
+    tb_side_cfg_t* L = &g_cfg.side[0];
+    tb_side_cfg_t* R = &g_cfg.side[1];
 
     switch (keycode) {
 #ifndef MOUSEKEY_ENABLE
@@ -141,88 +424,77 @@ bool tb_process_record(uint16_t keycode, keyrecord_t* record) {
         }
 #endif
         case TB_L_CPI_NEXT:
-            if (record->event.pressed) { gL.cpi_idx = (gL.cpi_idx + 1) % CPI_OPTION_SIZE; tb_save(); }
+            if (record->event.pressed) { L->cpi = cpi_step(L->cpi, true); tb_settings_changed(); }
             return false;
         case TB_L_CPI_PREV:
-            if (record->event.pressed) { gL.cpi_idx = (gL.cpi_idx + CPI_OPTION_SIZE - 1) % CPI_OPTION_SIZE; tb_save(); }
+            if (record->event.pressed) { L->cpi = cpi_step(L->cpi, false); tb_settings_changed(); }
             return false;
         case TB_L_ROT_R15:
-            if (record->event.pressed) { gL.rot_idx = (gL.rot_idx + 1) % ANGLE_SIZE; tb_save(); }
+            if (record->event.pressed) { L->rot_deg = rot_step(L->rot_deg, TB_ROT_STEP); tb_settings_changed(); }
             return false;
         case TB_L_ROT_L15:
-            if (record->event.pressed) { gL.rot_idx = (gL.rot_idx + ANGLE_SIZE - 1) % ANGLE_SIZE; tb_save(); }
+            if (record->event.pressed) { L->rot_deg = rot_step(L->rot_deg, -TB_ROT_STEP); tb_settings_changed(); }
             return false;
         case TB_R_CPI_NEXT:
-            if (record->event.pressed) { gR.cpi_idx = (gR.cpi_idx + 1) % CPI_OPTION_SIZE; tb_save(); }
+            if (record->event.pressed) { R->cpi = cpi_step(R->cpi, true); tb_settings_changed(); }
             return false;
         case TB_R_CPI_PREV:
-            if (record->event.pressed) { gR.cpi_idx = (gR.cpi_idx + CPI_OPTION_SIZE - 1) % CPI_OPTION_SIZE; tb_save(); }
+            if (record->event.pressed) { R->cpi = cpi_step(R->cpi, false); tb_settings_changed(); }
             return false;
         case TB_R_ROT_R15:
-            if (record->event.pressed) { gR.rot_idx = (gR.rot_idx + 1) % ANGLE_SIZE; tb_save(); }
+            if (record->event.pressed) { R->rot_deg = rot_step(R->rot_deg, TB_ROT_STEP); tb_settings_changed(); }
             return false;
         case TB_R_ROT_L15:
-            if (record->event.pressed) { gR.rot_idx = (gR.rot_idx + ANGLE_SIZE - 1) % ANGLE_SIZE; tb_save(); }
+            if (record->event.pressed) { R->rot_deg = rot_step(R->rot_deg, -TB_ROT_STEP); tb_settings_changed(); }
             return false;
         case TB_SCR_TOG:
             if (record->event.pressed) {
-                gL.scroll_mode = !gL.scroll_mode; // left only
-                gR.scroll_mode = false;           // right stays cursor
-                tb_save();
+                L->scroll_mode = !L->scroll_mode; // left only
+                R->scroll_mode = false;           // right stays cursor
+                tb_settings_changed();
             }
             return false;
         case TB_SCR_DIV:
             if (record->event.pressed) {
-                g_scrl_div = (g_scrl_div + 1) % SCRL_DIV_SIZE;
-                tb_save();
+                g_cfg.sc_div = div_step(g_cfg.sc_div);
+                tb_settings_changed();
             }
             return false;
         case TB_SC_GAIN_UP:
+        case TB_SC_GAIN_DN:
             if (record->event.pressed) {
-                float curr = k_sc_gain_table[g_sc_gain_idx];
-                float tgt  = curr + 0.10f;
-                float maxv = k_sc_gain_table[SC_GAIN_SIZE - 1];
-                if (tgt > maxv) tgt = maxv;
-                // 近傍から最も近いインデックスを探索
-                uint8_t best = g_sc_gain_idx;
-                float   best_err = fabsf(k_sc_gain_table[best] - tgt);
-                for (uint8_t i = 0; i < SC_GAIN_SIZE; ++i) {
-                    float e = fabsf(k_sc_gain_table[i] - tgt);
-                    if (e < best_err) { best = i; best_err = e; }
-                }
-                if (best != g_sc_gain_idx) { g_sc_gain_idx = best; tb_save(); }
+                int32_t  step = keycode == TB_SC_GAIN_UP ? SC_GAIN_STEP : -SC_GAIN_STEP;
+                uint16_t gain = clamp_u16(g_cfg.sc_gain + step, SC_GAIN_MIN, SC_GAIN_MAX);
+                if (gain != g_cfg.sc_gain) { g_cfg.sc_gain = gain; tb_settings_changed(); }
             }
             return false;
-        case TB_SC_GAIN_DN:
+        case TB_SC_GAMMA_UP:
+        case TB_SC_GAMMA_DN:
             if (record->event.pressed) {
-                float curr = k_sc_gain_table[g_sc_gain_idx];
-                float tgt  = curr - 0.10f;
-                float minv = k_sc_gain_table[0];
-                if (tgt < minv) tgt = minv;
-                uint8_t best = g_sc_gain_idx;
-                float   best_err = fabsf(k_sc_gain_table[best] - tgt);
-                for (uint8_t i = 0; i < SC_GAIN_SIZE; ++i) {
-                    float e = fabsf(k_sc_gain_table[i] - tgt);
-                    if (e < best_err) { best = i; best_err = e; }
-                }
-                if (best != g_sc_gain_idx) { g_sc_gain_idx = best; tb_save(); }
+                int32_t  step  = keycode == TB_SC_GAMMA_UP ? SC_GAMMA_STEP : -SC_GAMMA_STEP;
+                uint16_t gamma = clamp_u16(g_cfg.sc_gamma + step, SC_GAMMA_MIN, SC_GAMMA_MAX);
+                if (gamma != g_cfg.sc_gamma) { g_cfg.sc_gamma = gamma; tb_settings_changed(); }
             }
             return false;
-        case TB_SC_GAMMA_UP:
+        case TB_SC_RESET:
             if (record->event.pressed) {
-                if (g_sc_gamma_idx + 1 < SC_GAMMA_SIZE) { g_sc_gamma_idx++; tb_save(); }
+                g_cfg.sc_gain  = SC_GAIN_DEF;
+                g_cfg.sc_gamma = SC_GAMMA_DEF;
+                tb_settings_changed();
             }
             return false;
-        case TB_SC_GAMMA_DN:
+        case TB_L_FILTER:
+        case TB_R_FILTER:
             if (record->event.pressed) {
-                if (g_sc_gamma_idx > 0) { g_sc_gamma_idx--; tb_save(); }
+                uint8_t* f = &g_cfg.filter[keycode == TB_L_FILTER ? 0 : 1];
+                *f         = (*f + 1) % TB_FILTER_COUNT;
+                tb_settings_changed();
             }
             return false;
-        case TB_SC_RESET:
+        case TB_SCR_HIRES:
             if (record->event.pressed) {
-                g_sc_gain_idx = 3;   // 1.25
-                g_sc_gamma_idx = 1;  // 0.75
-                tb_save();
+                g_cfg.sc_hires = !g_cfg.sc_hires;
+                tb_settings_changed();
             }
             return false;
         default:
@@ -232,122 +504,38 @@ bool tb_process_record(uint16_t keycode, keyrecord_t* record) {
     return true;
 }
 
-// ====== Core transform (ported from picot_o44) ===================
-static void tb_apply_transform_side(report_mouse_t* mr, bool is_left) {
-    static float prev_x_l = 0.0f, prev_y_l = 0.0f;
-    static float prev_x_r = 0.0f, prev_y_r = 0.0f;
-    static float x_acc_l = 0.0f, y_acc_l = 0.0f;
-    static float x_acc_r = 0.0f, y_acc_r = 0.0f;
-    static float h_acm_l = 0.0f, v_acm_l = 0.0f;
-    static float h_acm_r = 0.0f, v_acm_r = 0.0f;
-
-    const float sensitivity = 0.5f;            // base cursor sensitivity
-    const float smoothing_factor = 0.7f;       // IIR smoothing
-    const float sensitivity_multiplier = 1.5f; // base multiplier
-
-    const tb_side_t* s = is_left ? &gL : &gR;
-    double rad = (double)k_angles[s->rot_idx] * (M_PI / 180.0) * -1.0;
-    // 回転を適用（Xの余計な反転は行わない）
-    float rx = (mr->x * cos(rad) - mr->y * sin(rad));
-    float ry = (mr->x * sin(rad) + mr->y * cos(rad));
-
-    float prev_x = is_left ? prev_x_l : prev_x_r;
-    float prev_y = is_left ? prev_y_l : prev_y_r;
-    float sx = prev_x * smoothing_factor + rx * (1.0f - smoothing_factor);
-    float sy = prev_y * smoothing_factor + ry * (1.0f - smoothing_factor);
-    if (is_left) { prev_x_l = sx; prev_y_l = sy; } else { prev_x_r = sx; prev_y_r = sy; }
-
-    // 平滑後の値を保存（スクロール専用のカーブに使用）
-    float smx = sx, smy = sy;
-
-    float mag = sqrtf(sx * sx + sy * sy);
-    float dyn = 1.0f + mag / 10.0f;
-    if (dyn < 0.5f) dyn = 0.5f; else if (dyn > 3.0f) dyn = 3.0f;
-
-    // Per-side CPI scaling relative to 800 CPI baseline
-    float cpi_scale = (float)k_cpi_opts[s->cpi_idx] / 800.0f;
-    sx *= sensitivity_multiplier * dyn * cpi_scale;
-    sy *= sensitivity_multiplier * dyn * cpi_scale;
-
-    bool scroll = is_left ? s->scroll_mode : false;
-    if (scroll) {
-        // スクロール専用の非線形カーブ（低速域を持ち上げ、高速域を圧縮）
-        // y = gain * sign(x) * |x|^gamma, 0<gamma
-        const float sc_gain  = k_sc_gain_table[g_sc_gain_idx];
-        const float sc_gamma = k_sc_gamma_table[g_sc_gamma_idx];
-
-        // 1D scroll selection per side（平滑後の生値ベース）
-        float sx_s = smx, sy_s = smy;
-        if (fabsf(sx_s) > fabsf(sy_s)) sy_s = 0.0f; else sx_s = 0.0f;
-
-        // 非線形変換を適用
-        float sx_nl = (sx_s == 0.0f) ? 0.0f : copysignf(sc_gain * powf(fabsf(sx_s), sc_gamma), sx_s);
-        float sy_nl = (sy_s == 0.0f) ? 0.0f : copysignf(sc_gain * powf(fabsf(sy_s), sc_gamma), sy_s);
-
-        float* ph = is_left ? &h_acm_l : &h_acm_r;
-        float* pv = is_left ? &v_acm_l : &v_acm_r;
-        if (g_scrl_inv) { *ph += sx_nl; *pv -= sy_nl; }
-        else            { *ph -= sx_nl; *pv += sy_nl; }
-
-        // シフト量を実数除算で再現（累積は float で保持）
-        const int   sh  = k_scr_divs[g_scrl_div];
-        const float scl = (float)(1 << sh);
-
-        // 出力の飽和処理（WHEEL_EXTENDED_REPORTに追従）
-        float out_h_f = *ph / scl;
-        float out_v_f = *pv / scl;
-
-        long out_h = (long)truncf(out_h_f);
-        long out_v = (long)truncf(out_v_f);
+// ====== Core transform ===========================================
+static void tb_apply_transform_side(report_mouse_t* mr, bool is_left, uint32_t dt_us) {
+    tb_xform_t*    xf = is_left ? &gXL : &gXR;
+    tb_xform_out_t out;
 
-#ifdef WHEEL_EXTENDED_REPORT
-        if (out_h > INT16_MAX) out_h = INT16_MAX; else if (out_h < INT16_MIN) out_h = INT16_MIN;
-        if (out_v > INT16_MAX) out_v = INT16_MAX; else if (out_v < INT16_MIN) out_v = INT16_MIN;
-#else
-        if (out_h > INT8_MAX) out_h = INT8_MAX; else if (out_h < INT8_MIN) out_h = INT8_MIN;
-        if (out_v > INT8_MAX) out_v = INT8_MAX; else if (out_v < INT8_MIN) out_v = INT8_MIN;
-#endif
+    tb_xform_apply(xf, &g_sc, mr->x, mr->y, dt_us, &out);
+    mr->x = out.x;
+    mr->y = out.y;
+    mr->h += out.h;
+    mr->v += out.v;
+}
 
-        if (out_h) { mr->h += (int)out_h; *ph -= (float)out_h * scl; }
-        if (out_v) { mr->v += (int)out_v; *pv -= (float)out_v * scl; }
-        mr->x = 0; mr->y = 0;
-    } else {
-        float* pax = is_left ? &x_acc_l : &x_acc_r;
-        float* pay = is_left ? &y_acc_l : &y_acc_r;
-        *pax += sx * sensitivity;
-        *pay += sy * sensitivity;
-
-        // 出力の飽和処理（MOUSE_EXTENDED_REPORTに追従）
-        if (fabsf(*pax) >= 1.0f) {
-            long out_x = (long)truncf(*pax);
+report_mouse_t tb_task_combined(report_mouse_t left, report_mouse_t right, uint32_t dt_us) {
+    tb_apply_transform_side(&left, true, dt_us);
+    tb_apply_transform_side(&right, false, dt_us);
+
+    // POINTING_DEVICE_COMBINED を使わないので合成もここで行う。
+    // pointing_device_combine_reports() と同じく和を出力範囲で飽和させる
 #ifdef MOUSE_EXTENDED_REPORT
-            if (out_x > INT16_MAX) out_x = INT16_MAX; else if (out_x < INT16_MIN) out_x = INT16_MIN;
+    left.x = add_sat(left.x, right.x, INT16_MIN, INT16_MAX);
+    left.y = add_sat(left.y, right.y, INT16_MIN, INT16_MAX);
 #else
-            if (out_x > INT8_MAX) out_x = INT8_MAX; else if (out_x < INT8_MIN) out_x = INT8_MIN;
+    left.x = add_sat(left.x, right.x, INT8_MIN, INT8_MAX);
+    left.y = add_sat(left.y, right.y, INT8_MIN, INT8_MAX);
 #endif
-            mr->x = (int)out_x;
-            *pax -= (float)out_x;
-        } else {
-            mr->x = 0;
-        }
-
-        if (fabsf(*pay) >= 1.0f) {
-            long out_y = (long)truncf(*pay);
-#ifdef MOUSE_EXTENDED_REPORT
-            if (out_y > INT16_MAX) out_y = INT16_MAX; else if (out_y < INT16_MIN) out_y = INT16_MIN;
+#ifdef WHEEL_EXTENDED_REPORT
+    left.h = add_sat(left.h, right.h, INT16_MIN, INT16_MAX);
+    left.v = add_sat(left.v, right.v, INT16_MIN, INT16_MAX);
 #else
-            if (out_y > INT8_MAX) out_y = INT8_MAX; else if (out_y < INT8_MIN) out_y = INT8_MIN;
+    left.h = add_sat(left.h, right.h, INT8_MIN, INT8_MAX);
+    left.v = add_sat(left.v, right.v, INT8_MIN, INT8_MAX);
 #endif
-            mr->y = (int)out_y;
-            *pay -= (float)out_y;
-        } else {
-            mr->y = 0;
-        }
-    }
-}
-
-report_mouse_t tb_task_combined(report_mouse_t left, report_mouse_t right) {
-    tb_apply_transform_side(&left, true);
-    tb_apply_transform_side(&right, false);
-    return pointing_device_combine_reports(left, right);
+    left.buttons |= right.buttons;
+    return left;
 }
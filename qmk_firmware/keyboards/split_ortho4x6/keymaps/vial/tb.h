@@ -1,11 +1,62 @@
 #pragma once
 #include "quantum.h"
 #include "pointing_device.h"
+#include "tb_xform.h"
 
 // keymap.c から呼び出される公開 API
 void tb_init(void);
 bool tb_process_record(uint16_t keycode, keyrecord_t* record);
-report_mouse_t tb_task_combined(report_mouse_t left, report_mouse_t right);
+// dt_us: 前回の呼び出しからの経過時間（平滑の時定数に使う）
+report_mouse_t tb_task_combined(report_mouse_t left, report_mouse_t right, uint32_t dt_us);
+// 設定の保存は遅延させる。housekeeping から tb_task() を呼び、
+// サスペンド/ブートローダ移行前には tb_flush() で書き出すこと。
+void tb_task(void);
+void tb_flush(void);
+
+typedef struct {
+    uint32_t requests;  // 設定変更の回数
+    uint32_t coalesced; // 未保存の変更に重なった回数（書き込みを 1 回に集約）
+    uint32_t unchanged; // 保存時に EEPROM と同じ値だったため省いた回数
+    uint32_t writes;    // 実際の EEPROM 書き込み回数
+} tb_save_stats_t;
+const tb_save_stats_t* tb_get_save_stats(void);
+// 保存のカウンタを読む（RAWHID_CMD_TB_SAVE、scripts/tb_save_stats.py）
+void tb_save_raw_hid(uint8_t* data, uint8_t length);
+
+// ====== Persistent settings (EECONFIG_KB_DATA) ===================
+// バージョン付きでキーボード用データブロックに保存する。フィールドを足すときは
+// 末尾に追加して TB_CONFIG_VERSION を上げること（古いブロックは不足分を既定値で補う）。
+#define TB_CONFIG_VERSION 4
+
+typedef struct __attribute__((packed)) {
+    uint16_t cpi;         // センサ CPI
+    int16_t  rot_deg;     // 回転角 -180..180
+    uint8_t  scroll_mode; // 1 = スクロール
+} tb_side_cfg_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t       version;
+    uint8_t       size; // ヘッダを含む有効バイト数
+    uint8_t       crc;  // crc8(ヘッダ以降 size - 3 バイト)
+    tb_side_cfg_t side[2]; // [0] = 左, [1] = 右
+    uint16_t      sc_gain;  // スクロールゲイン x100
+    uint16_t      sc_gamma; // スクロールガンマ x100
+    uint8_t       sc_div;   // スクロール分割（この数のカウントで 1 ステップ）
+    uint8_t       sc_inv;
+    // v2
+    uint8_t filter[2]; // tb_filter_t（tb_xform.h）、[0] = 左, [1] = 右
+    // v3
+    uint8_t       accel_n[2]; // 加速カーブの点の数
+    tb_accel_pt_t accel[2][TB_ACCEL_POINTS];
+    // v4
+    uint8_t sc_hires; // 1 = 高解像度スクロール（既定）。0 = ステップ送り（Resolution Multiplier を無視する macOS 用）
+} tb_config_t;
+
+// 現在の設定（EEPROM と同じ形式）。トレースの再生用
+const tb_config_t* tb_get_config(void);
+
+// 加速カーブの読み書き（RAWHID_CMD_TB_ACCEL、scripts/tb_accel.py）
+void tb_accel_raw_hid(uint8_t* data, uint8_t length);
 
 // カスタムキーコード（Vial の QK_KB_0 連番に整列）
 // 左右独立の制御（CPI/回転）
@@ -27,4 +78,8 @@ enum tb_keycodes {
     TB_SC_GAMMA_UP,
     TB_SC_GAMMA_DN,
     TB_SC_RESET,
+    // 平滑フィルタの切替（IIR -> One Euro -> なし）
+    TB_L_FILTER,
+    TB_R_FILTER,
+    TB_SCR_HIRES, // 高解像度スクロール/従来のステップ送りを切替（グローバル、HIRES_SCROLL_ENABLE=yes の時のみ）
 };
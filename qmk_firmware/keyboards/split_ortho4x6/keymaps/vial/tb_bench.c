@@ -0,0 +1,92 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_bench.c
+
+#include "tb_bench.h"
+#include "tb.h"
+#include "tb_float_ref.h"
+#include "quantum.h"
+#include "print.h"
+#include "timer_us.h"
+
+#ifndef TB_BENCH_DELAY_MS
+#    define TB_BENCH_DELAY_MS 5000 // コンソールをつなぐまでの猶予
+#endif
+#ifndef TB_BENCH_CALLS
+#    define TB_BENCH_CALLS 4096
+#endif
+#ifndef TB_BENCH_CPU_MHZ
+#    define TB_BENCH_CPU_MHZ 125 // RP2040 の既定のシステムクロック
+#endif
+
+// 入力は固定の擬似乱数列（停止・低速・高速を含む）。左右とも同じ列を使う
+#define TRACE_LEN 256
+static int8_t g_trace[TRACE_LEN][2];
+
+static void make_trace(void) {
+    uint32_t rng = 0x1234567u;
+    for (uint16_t i = 0; i < TRACE_LEN; ++i) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        uint8_t kind = (i / 32) % 4; // 32 レポートごとに 停止 / 低速 / 高速 / 高速
+        int8_t  lim  = kind == 0 ? 0 : (kind == 1 ? 3 : 60);
+        g_trace[i][0] = lim ? (int8_t)((int32_t)(rng % (2 * lim + 1)) - lim) : 0;
+        g_trace[i][1] = lim ? (int8_t)((int32_t)((rng >> 8) % (2 * lim + 1)) - lim) : 0;
+    }
+}
+
+static volatile int32_t g_sink; // 最適化で消されないように
+
+static void report(const char* name, uint32_t us) {
+    uint32_t ns = (uint32_t)((uint64_t)us * 1000 / TB_BENCH_CALLS);
+    uprintf("tb_bench: %s %lu us / %u calls = %lu ns/call (%lu cycles at %u MHz)\n", name, us, TB_BENCH_CALLS, ns,
+            ns * TB_BENCH_CPU_MHZ / 1000, TB_BENCH_CPU_MHZ);
+}
+
+// 固定小数点: 保存中の設定（既定では左スクロール・右カーソル）で tb_task_combined() を
+// 1ms 間隔として呼ぶ。測った後に 1 カウント未満の端数が残るが、次の動きに混ざるだけ
+static uint32_t bench_fixed(void) {
+    uint32_t t0 = timer_read_us();
+    for (uint16_t n = 0; n < TB_BENCH_CALLS; ++n) {
+        const int8_t*  in = g_trace[n % TRACE_LEN];
+        report_mouse_t l  = {.x = in[0], .y = in[1]};
+        report_mouse_t r  = {.x = in[1], .y = in[0]};
+        report_mouse_t o  = tb_task_combined(l, r, 1000);
+        g_sink += o.x + o.y + o.h + o.v;
+    }
+    return timer_read_us() - t0;
+}
+
+// float: 既定の設定と同じ構成で左右 1 回ずつ（tb_task_combined() 1 回ぶん）
+static uint32_t bench_float(void) {
+    static const tb_float_cfg_t cfg_l = {.rot_deg = 90, .cpi = 1600, .scroll = true, .inv = true, .div_shift = 5, .sc_gain = 1.25f, .sc_gamma = 0.75f};
+    static const tb_float_cfg_t cfg_r = {.rot_deg = -90, .cpi = 1600, .scroll = false};
+    tb_float_state_t            st_l = {0}, st_r = {0};
+
+    uint32_t t0 = timer_read_us();
+    for (uint16_t n = 0; n < TB_BENCH_CALLS; ++n) {
+        const int8_t* in = g_trace[n % TRACE_LEN];
+        int16_t       lx = in[0], ly = in[1], rx = in[1], ry = in[0], h = 0, v = 0;
+        tb_float_apply(&st_l, &cfg_l, &lx, &ly, &h, &v);
+        tb_float_apply(&st_r, &cfg_r, &rx, &ry, &h, &v);
+        g_sink += lx + ly + rx + ry + h + v;
+    }
+    return timer_read_us() - t0;
+}
+
+void tb_bench_task(void) {
+    static bool done;
+    if (done || timer_read32() < TB_BENCH_DELAY_MS) return;
+    done = true;
+
+    make_trace();
+    // USB の割り込みなどが入るので、短い方を採る
+    uint32_t fixed_us = UINT32_MAX, float_us = UINT32_MAX;
+    for (uint8_t i = 0; i < 3; ++i) {
+        uint32_t t = bench_fixed();
+        if (t < fixed_us) fixed_us = t;
+        t = bench_float();
+        if (t < float_us) float_us = t;
+    }
+    report("fixed tb_task_combined", fixed_us);
+    report("float (left scroll + right cursor)", float_us);
+}
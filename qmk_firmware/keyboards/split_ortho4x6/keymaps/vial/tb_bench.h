@@ -0,0 +1,7 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_bench.h
+#pragma once
+// 実機での変換の所要時間（固定小数点の tb_task_combined() と float 版の比較）。
+// TB_BENCH_ENABLE = yes でビルドすると、起動から TB_BENCH_DELAY_MS 後に 1 回だけ測り、
+// 結果をコンソール（qmk console / hid_listen）に出す。
+
+void tb_bench_task(void);
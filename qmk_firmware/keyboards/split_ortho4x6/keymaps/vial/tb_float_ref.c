@@ -0,0 +1,109 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_float_ref.c
+// 固定小数点化する前の tb_apply_transform_side() をそのまま残したもの。
+// 左右の static 変数と設定のグローバルを引数に置き換えた以外は変えていない。
+
+#include "tb_float_ref.h"
+#include <math.h>
+#include <stdint.h>
+
+void tb_float_apply(tb_float_state_t* st, const tb_float_cfg_t* cfg, int16_t* x, int16_t* y, int16_t* h, int16_t* v) {
+    const float sensitivity = 0.5f;            // base cursor sensitivity
+    const float smoothing_factor = 0.7f;       // IIR smoothing
+    const float sensitivity_multiplier = 1.5f; // base multiplier
+
+    double rad = (double)cfg->rot_deg * (M_PI / 180.0) * -1.0;
+    // 回転を適用（Xの余計な反転は行わない）
+    float rx = (*x * cos(rad) - *y * sin(rad));
+    float ry = (*x * sin(rad) + *y * cos(rad));
+
+    float sx = st->prev_x * smoothing_factor + rx * (1.0f - smoothing_factor);
+    float sy = st->prev_y * smoothing_factor + ry * (1.0f - smoothing_factor);
+    st->prev_x = sx; st->prev_y = sy;
+
+    // 平滑後の値を保存（スクロール専用のカーブに使用）
+    float smx = sx, smy = sy;
+
+    float mag = sqrtf(sx * sx + sy * sy);
+    float dyn = 1.0f + mag / 10.0f;
+    if (dyn < 0.5f) dyn = 0.5f; else if (dyn > 3.0f) dyn = 3.0f;
+
+    // Per-side CPI scaling relative to 800 CPI baseline
+    float cpi_scale = (float)cfg->cpi / 800.0f;
+    sx *= sensitivity_multiplier * dyn * cpi_scale;
+    sy *= sensitivity_multiplier * dyn * cpi_scale;
+
+    if (cfg->scroll) {
+        // スクロール専用の非線形カーブ（低速域を持ち上げ、高速域を圧縮）
+        // y = gain * sign(x) * |x|^gamma, 0<gamma
+        const float sc_gain  = cfg->sc_gain;
+        const float sc_gamma = cfg->sc_gamma;
+
+        // 1D scroll selection per side（平滑後の生値ベース）
+        float sx_s = smx, sy_s = smy;
+        if (fabsf(sx_s) > fabsf(sy_s)) sy_s = 0.0f; else sx_s = 0.0f;
+
+        // 非線形変換を適用
+        float sx_nl = (sx_s == 0.0f) ? 0.0f : copysignf(sc_gain * powf(fabsf(sx_s), sc_gamma), sx_s);
+        float sy_nl = (sy_s == 0.0f) ? 0.0f : copysignf(sc_gain * powf(fabsf(sy_s), sc_gamma), sy_s);
+
+        float* ph = &st->acc_h;
+        float* pv = &st->acc_v;
+        if (cfg->inv) { *ph += sx_nl; *pv -= sy_nl; }
+        else          { *ph -= sx_nl; *pv += sy_nl; }
+
+        // シフト量を実数除算で再現（累積は float で保持）
+        const int   sh  = cfg->div_shift;
+        const float scl = (float)(1 << sh);
+
+        // 出力の飽和処理（WHEEL_EXTENDED_REPORTに追従）
+        float out_h_f = *ph / scl;
+        float out_v_f = *pv / scl;
+
+        long out_h = (long)truncf(out_h_f);
+        long out_v = (long)truncf(out_v_f);
+
+#ifdef WHEEL_EXTENDED_REPORT
+        if (out_h > INT16_MAX) out_h = INT16_MAX; else if (out_h < INT16_MIN) out_h = INT16_MIN;
+        if (out_v > INT16_MAX) out_v = INT16_MAX; else if (out_v < INT16_MIN) out_v = INT16_MIN;
+#else
+        if (out_h > INT8_MAX) out_h = INT8_MAX; else if (out_h < INT8_MIN) out_h = INT8_MIN;
+        if (out_v > INT8_MAX) out_v = INT8_MAX; else if (out_v < INT8_MIN) out_v = INT8_MIN;
+#endif
+
+        if (out_h) { *h += (int)out_h; *ph -= (float)out_h * scl; }
+        if (out_v) { *v += (int)out_v; *pv -= (float)out_v * scl; }
+        *x = 0; *y = 0;
+    } else {
+        float* pax = &st->acc_x;
+        float* pay = &st->acc_y;
+        *pax += sx * sensitivity;
+        *pay += sy * sensitivity;
+
+        // 出力の飽和処理（MOUSE_EXTENDED_REPORTに追従）
+        if (fabsf(*pax) >= 1.0f) {
+            long out_x = (long)truncf(*pax);
+#ifdef MOUSE_EXTENDED_REPORT
+            if (out_x > INT16_MAX) out_x = INT16_MAX; else if (out_x < INT16_MIN) out_x = INT16_MIN;
+#else
+            if (out_x > INT8_MAX) out_x = INT8_MAX; else if (out_x < INT8_MIN) out_x = INT8_MIN;
+#endif
+            *x = (int)out_x;
+            *pax -= (float)out_x;
+        } else {
+            *x = 0;
+        }
+
+        if (fabsf(*pay) >= 1.0f) {
+            long out_y = (long)truncf(*pay);
+#ifdef MOUSE_EXTENDED_REPORT
+            if (out_y > INT16_MAX) out_y = INT16_MAX; else if (out_y < INT16_MIN) out_y = INT16_MIN;
+#else
+            if (out_y > INT8_MAX) out_y = INT8_MAX; else if (out_y < INT8_MIN) out_y = INT8_MIN;
+#endif
+            *y = (int)out_y;
+            *pay -= (float)out_y;
+        } else {
+            *y = 0;
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_float_ref.h
+#pragma once
+// 固定小数点化する前の float 版 tb_apply_transform_side()。比較用に残してあり、
+// tb_bench.c（実機での所要時間の比較）と scripts/tb_test（ホストでの比較）だけが使う。
+// ファームウェアの通常の経路には入らない。
+// quantum.h に依存しないため、ホストでもそのままコンパイルできる。
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    float prev_x, prev_y; // IIR 平滑の状態
+    float acc_x, acc_y;   // カーソルの端数
+    float acc_h, acc_v;   // スクロールの端数
+} tb_float_state_t;
+
+typedef struct {
+    int16_t  rot_deg;
+    uint16_t cpi;
+    bool     scroll;
+    bool     inv;
+    uint8_t  div_shift; // スクロール出力を 1 << div_shift で分割
+    float    sc_gain, sc_gamma;
+} tb_float_cfg_t;
+
+// x/y を変換して書き戻す。スクロールの時は h/v に加算し、x/y は 0 にする
+void tb_float_apply(tb_float_state_t* st, const tb_float_cfg_t* cfg, int16_t* x, int16_t* y, int16_t* h, int16_t* v);
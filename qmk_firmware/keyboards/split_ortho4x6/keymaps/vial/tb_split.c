@@ -0,0 +1,279 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_split.c
+
+#include "tb_split.h"
+#include "tb.h"
+#include "transactions.h"
+#include "atomic_util.h"
+#include "crc.h"
+#include "matrix.h"
+#include "paw3222.h"
+#include "timer_us.h"
+#include "raw_hid.h"
+#include "rawhid_cmd.h"
+#include <stddef.h>
+#include <string.h>
+#include "scan_prof.h"
+#ifdef TB_TRACE_ENABLE
+#    include "tb_trace.h"
+#endif
+
+// ====== Wire format ==============================================
+// RPC は 1 回で INFO/REQ/EXECUTE/RESP の 4 トランザクションになるため、送るものが
+// ある時だけ実行する（下の Pending flag）。状態確認とデルタ取得は分けず 1 回で済ませる。
+// QMK は RPC の中身を検査しないので、どちらも末尾に crc8 を付ける。化けたものは
+// 捨てて確認もしないので、相手側は同じフレームを再送する。
+typedef struct __attribute__((packed)) {
+    uint8_t  ack; // マスタが最後に受け取ったフレームの seq
+    uint16_t cpi; // 相手側センサの CPI（0 = 変更なし）
+    uint8_t  crc; // crc8(ここまで)
+} tb_split_req_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t epoch; // 相手側の起動ごとに変わる値（0 は使わない）
+    uint8_t  seq;
+    int16_t  x, y;
+    uint16_t cpi; // 受け取っている CPI（マスタはこれが一致するまで送り直す）
+    uint8_t  crc; // crc8(ここまで)。要求が化けていた時は合わない値を返す
+} tb_split_resp_t;
+
+#define TB_SPLIT_CRC(p) crc8((p), offsetof(__typeof__(*(p)), crc))
+
+typedef struct __attribute__((packed)) {
+    paw3222_sampler_stats_t sampler;
+    paw3222_status_t        status;
+} tb_split_sensor_t;
+
+_Static_assert(sizeof(tb_split_sensor_t) <= RPC_S2M_BUFFER_SIZE, "tb_split_sensor_t does not fit in an RPC reply");
+
+// ====== Pending flag =============================================
+// 相手側に未確認のデルタがあるかは、QMK が毎スキャン同期しているスレーブ側の行列の
+// 空きビットに載せる。マスタは GET_SLAVE_MATRIX_CHECKSUM の 1 バイトで変化を知り、
+// 行データは変わった時だけ取りに行くので、無入力の間は RPC を 1 回も実行しない。
+// 列は MATRIX_COLS 本で、それより上のビットはデバウンス（debounce_eager.c）も
+// keyboard.c のキー処理も見ない。
+#define TB_SPLIT_PENDING_BIT ((matrix_row_t)1 << MATRIX_COLS)
+_Static_assert(MATRIX_COLS < sizeof(matrix_row_t) * 8, "no spare matrix column for the tb_split pending flag");
+
+extern matrix_row_t matrix[MATRIX_ROWS]; // quantum/matrix_common.c（デバウンス後、スレーブはこれを送る）
+
+// 各手の先頭行（split_common と同じく左が前半）
+static inline uint8_t tb_split_pending_row(bool left) { return left ? 0 : MATRIX_ROWS / 2; }
+
+// ====== Target side ==============================================
+// デルタの積算は pointing_device_task（メインループ）、応答は転送スレッドで
+// 行われるため、共有部分は ATOMIC_BLOCK で保護する。
+static int32_t           g_acc_x, g_acc_y;
+static tb_split_resp_t   g_frame;      // 送信中（未確認）のフレーム
+static bool              g_frame_live; // g_frame が未確認
+static volatile uint16_t g_req_cpi;    // マスタから指定された CPI
+static uint16_t          g_epoch;      // 0 = まだ決めていない
+
+static inline int16_t take_i16(int32_t* acc) {
+    int32_t v = *acc;
+    if (v > INT16_MAX) v = INT16_MAX; else if (v < INT16_MIN) v = INT16_MIN;
+    *acc -= v;
+    return (int16_t)v;
+}
+
+static void tb_split_poll_slave(uint8_t in_len, const void* in_data, uint8_t out_len, void* out_data) {
+    const tb_split_req_t* req  = in_data;
+    tb_split_resp_t*      resp = out_data;
+    if (in_len < sizeof(*req) || out_len < sizeof(*resp)) return;
+    if (req->crc != TB_SPLIT_CRC(req)) {
+        // ack も CPI も信用できないので何も変えず、マスタには失敗として見せる
+        memset(resp, 0, sizeof(*resp));
+        resp->crc = ~TB_SPLIT_CRC(resp);
+        return;
+    }
+
+    // 起動してから最初の要求を受けた時刻（µs）。左右の起動のずれで毎回変わるので、
+    // 再起動した相手側の seq をマスタが前の続きと取り違えない
+    if (g_epoch == 0) {
+        uint16_t t = (uint16_t)timer_read_us();
+        g_epoch    = t ? t : 1;
+    }
+
+    ATOMIC_BLOCK_FORCEON {
+        if (g_frame_live && req->ack == g_frame.seq) g_frame_live = false;
+        // 確認済みなら次のフレームを切り出す。未確認なら同じものを再送する
+        if (!g_frame_live && (g_acc_x != 0 || g_acc_y != 0)) {
+            g_frame.seq++;
+            g_frame.x    = take_i16(&g_acc_x);
+            g_frame.y    = take_i16(&g_acc_y);
+            g_frame_live = true;
+        }
+        if (g_frame_live) {
+            *resp = g_frame;
+        } else {
+            resp->seq = g_frame.seq;
+            resp->x = resp->y = 0;
+        }
+    }
+    resp->epoch = g_epoch;
+    if (req->cpi) g_req_cpi = req->cpi;
+    resp->cpi = g_req_cpi;
+    resp->crc = TB_SPLIT_CRC(resp);
+}
+
+// センサのサンプリング統計と接続状態（raw HID から要求された時だけ呼ばれる）
+static void tb_split_sensor_slave(uint8_t in_len, const void* in_data, uint8_t out_len, void* out_data) {
+    tb_split_sensor_t* resp = out_data;
+    if (out_len < sizeof(*resp)) return;
+    resp->sampler = *paw3222_get_sampler_stats();
+    resp->status  = *paw3222_get_status();
+}
+
+static report_mouse_t tb_split_target_task(report_mouse_t local) {
+    bool pending;
+    ATOMIC_BLOCK_FORCEON {
+        g_acc_x += local.x;
+        g_acc_y += local.y;
+        pending = g_frame_live || g_acc_x != 0 || g_acc_y != 0;
+    }
+    // 次の matrix_scan() で transport_slave() がマスタ向けにコピーする
+    uint8_t row = tb_split_pending_row(is_keyboard_left());
+    if (pending) {
+        matrix[row] |= TB_SPLIT_PENDING_BIT;
+    } else {
+        matrix[row] &= ~TB_SPLIT_PENDING_BIT;
+    }
+    // センサのバスはメインループからしか触らない
+    uint16_t cpi = g_req_cpi;
+    if (cpi && cpi != pointing_device_get_cpi()) pointing_device_set_cpi(cpi);
+
+    local.x = local.y = 0;
+    return local;
+}
+
+// ====== Initiator side ===========================================
+static tb_split_stats_t g_stats;
+static uint32_t         g_last_us; // 前回 tb_task_combined() を呼んだ時刻
+static uint8_t          g_last_seq;
+static uint16_t         g_remote_epoch;
+static uint16_t         g_remote_cpi;
+static uint16_t         g_remote_cpi_ack; // 相手側が受け取っていると返した CPI
+
+static report_mouse_t tb_split_fetch(void) {
+    report_mouse_t remote = {0};
+
+    // 切断中は RPC を試さない（応答待ちで終わるだけ）。再接続は QMK の接続確認
+    // （SPLIT_CONNECTION_CHECK_TIMEOUT ごと）に任せる
+    if (!is_transport_connected()) return remote;
+
+    // 相手側にデルタが無く、CPI も届いているならリンクを使わない。
+    // 切断中は QMK が相手側の行列を 0 にするので、ここで止まる
+    bool pending = matrix_get_row(tb_split_pending_row(!is_keyboard_left())) & TB_SPLIT_PENDING_BIT;
+    if (!pending && g_remote_cpi == g_remote_cpi_ack) return remote;
+
+    tb_split_req_t  req = {.ack = g_last_seq, .cpi = g_remote_cpi != g_remote_cpi_ack ? g_remote_cpi : 0};
+    tb_split_resp_t resp;
+    req.crc = TB_SPLIT_CRC(&req);
+    g_stats.polls++;
+    if (!transaction_rpc_exec(TB_SPLIT_POLL, sizeof(req), &req, sizeof(resp), &resp) || resp.crc != TB_SPLIT_CRC(&resp)) {
+        // 確認しないので、相手側は同じフレームを次も送ってくる
+        g_stats.failures++;
+        return remote;
+    }
+    // 相手側が再起動していれば 0 が返り、次の実行で送り直す
+    g_remote_cpi_ack = resp.cpi;
+    if (resp.epoch != g_remote_epoch) {
+        // 相手側が起動した（マスタの起動直後も含む）。送ってきたフレームは新しいものとする
+        if (g_remote_epoch) g_stats.restarts++;
+        g_remote_epoch = resp.epoch;
+        g_last_seq     = resp.seq - 1;
+    }
+    if (!resp.x && !resp.y) {
+        // 無入力。相手側のフレームは全部確認済みなので、seq が飛んでいても落としたものはない
+        g_last_seq = resp.seq;
+        return remote;
+    }
+    if (resp.seq == g_last_seq) {
+        // 受信済みフレームの再送
+        g_stats.dups++;
+        return remote;
+    }
+    if (resp.seq != (uint8_t)(g_last_seq + 1)) g_stats.lost++;
+    g_last_seq = resp.seq;
+    g_stats.frames++;
+
+    remote.x = resp.x;
+    remote.y = resp.y;
+#ifdef TB_TRACE_ENABLE
+    tb_trace_sample(!is_keyboard_left(), resp.x, resp.y, true);
+#endif
+    return remote;
+}
+
+// ====== Public API ===============================================
+void tb_split_init(void) {
+    transaction_register_rpc(TB_SPLIT_POLL, tb_split_poll_slave);
+    transaction_register_rpc(TB_SPLIT_SENSOR, tb_split_sensor_slave);
+}
+
+report_mouse_t tb_split_task(report_mouse_t local) {
+    if (!is_keyboard_master()) return tb_split_target_task(local);
+
+    SCAN_PROF_BEGIN(SCAN_PROF_SPLIT_TB);
+    report_mouse_t remote = tb_split_fetch();
+    SCAN_PROF_END(SCAN_PROF_SPLIT_TB);
+    report_mouse_t left   = is_keyboard_left() ? local : remote;
+    report_mouse_t right  = is_keyboard_left() ? remote : local;
+#ifdef TB_TRACE_ENABLE
+    tb_trace_tick();
+#endif
+
+    uint32_t now = timer_read_us();
+    uint32_t dt  = now - g_last_us;
+    g_last_us    = now;
+
+    SCAN_PROF_BEGIN(SCAN_PROF_XFORM);
+    report_mouse_t out = tb_task_combined(left, right, dt);
+    SCAN_PROF_END(SCAN_PROF_XFORM);
+    return out;
+}
+
+void tb_split_set_remote_cpi(uint16_t cpi) { g_remote_cpi = cpi; }
+
+const tb_split_stats_t* tb_split_get_stats(void) { return &g_stats; }
+
+bool tb_split_get_sensor_stats(bool left, paw3222_sampler_stats_t* out, paw3222_status_t* status) {
+    if (left == is_keyboard_left()) {
+        *out    = *paw3222_get_sampler_stats();
+        *status = *paw3222_get_status();
+        return true;
+    }
+    tb_split_sensor_t resp;
+    if (!transaction_rpc_exec(TB_SPLIT_SENSOR, 0, NULL, sizeof(resp), &resp)) return false;
+    *out    = resp.sampler;
+    *status = resp.status;
+    return true;
+}
+
+// ====== Raw HID ==================================================
+enum tb_sensor_subcmd {
+    TB_SENSOR_STATS = 0x01, // data[2]: 0 = 左, 1 = 右
+};
+
+_Static_assert(4 + 2 + 5 * 4 + 6 <= RAW_EPSIZE, "sensor stats do not fit in a raw HID packet");
+
+void tb_split_sensor_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t*                body = &data[4];
+    paw3222_sampler_stats_t st;
+    paw3222_status_t        status;
+
+    if (data[1] != TB_SENSOR_STATS || !tb_split_get_sensor_stats(data[2] == 0, &st, &status)) {
+        data[1] = RAWHID_ERR;
+        return;
+    }
+    memset(body, 0, length - 4);
+    rawhid_put_u16(&body[0], st.interval_us);
+    rawhid_put_u32(&body[2], st.ticks);
+    rawhid_put_u32(&body[6], st.late);
+    rawhid_put_u32(&body[10], st.saturated);
+    rawhid_put_u32(&body[14], st.reports);
+    rawhid_put_u32(&body[18], timer_read32());
+    body[22] = status.state;
+    body[23] = status.pid;
+    rawhid_put_u16(&body[24], status.inits);
+    rawhid_put_u16(&body[26], status.lost);
+}
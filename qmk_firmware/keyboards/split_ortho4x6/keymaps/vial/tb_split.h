@@ -0,0 +1,41 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_split.h
+#pragma once
+// マスタでない側のトラックボールを独自のスプリットトランザクションで転送する
+// （SPLIT_POINTING_ENABLE の代わり）。
+//   - 新しいデルタフレームは動きがあった時だけ作り、未確認のものがある間は
+//     スレーブ側の行列の空きビットで知らせる（マスタはその間だけ RPC を実行する）
+//   - 相手側は転送の合間もデルタを積算し、カウントを落とさない
+//   - シーケンス番号で欠落/重複を検出し、未確認のフレームは再送する
+//   - 相手側は起動ごとに epoch を変え、マスタはそれが変わったら seq を合わせ直す
+// 標準の転送と違い、通信エラーで落ちたデルタも再送で取り戻せる。
+
+#include "quantum.h"
+#include "pointing_device.h"
+#include "paw3222.h"
+
+typedef struct {
+    uint32_t polls;    // RPC の実行回数（相手側に送るものがある時だけ）
+    uint32_t frames;   // 受け取ったデルタフレーム
+    uint32_t dups;     // 受信済みフレームの再送（無視した）
+    uint32_t lost;     // 同じ epoch でのシーケンスの飛び（未確認のフレームを落とした）
+    uint32_t restarts; // 相手側の再起動（epoch の変化）
+    uint32_t failures; // トランザクション失敗（チェックサム/タイムアウト）
+} tb_split_stats_t;
+
+void tb_split_init(void);
+
+// pointing_device_task_user() から呼ぶ（マスタ/スレーブ共通）。
+// マスタでは左右のレポートを揃えて tb_task_combined() に渡した結果を、
+// スレーブではデルタを積算して空のレポートを返す。
+report_mouse_t tb_split_task(report_mouse_t local);
+
+// 相手側センサに設定する CPI（相手側が受け取ったと返すまで送る）
+void tb_split_set_remote_cpi(uint16_t cpi);
+
+const tb_split_stats_t* tb_split_get_stats(void);
+
+// 左右それぞれのセンサのサンプリング統計と接続状態。相手側は RPC で取りに行く
+// （マスタでのみ有効、失敗すると false）。
+bool tb_split_get_sensor_stats(bool left, paw3222_sampler_stats_t* out, paw3222_status_t* status);
+
+void tb_split_sensor_raw_hid(uint8_t* data, uint8_t length); // RAWHID_CMD_SENSOR
@@ -0,0 +1,130 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_trace.c
+
+#include "tb_trace.h"
+#include "tb.h"
+#include "raw_hid.h"
+#include "timer_us.h"
+#include <string.h>
+
+// ====== Ring buffer ==============================================
+static tb_trace_rec_t g_trace[TB_TRACE_LEN];
+static uint16_t       g_head;    // 次に書き込む位置
+static uint16_t       g_count;   // 有効レコード数
+static uint32_t       g_dropped; // 上書き/停止で失ったレコード数
+static bool           g_running;
+static bool           g_oneshot;
+
+// 畳み込み先（種類ごとの直前のレコードの位置）。動きのあるサンプルで全部無効にする
+static uint16_t g_fold[3];
+static bool     g_fold_live[3];
+
+static void trace_append(const tb_trace_rec_t* rec) {
+    if (g_count == TB_TRACE_LEN) {
+        g_dropped++;
+        if (g_oneshot) {
+            g_running = false;
+            return;
+        }
+    } else {
+        g_count++;
+    }
+    g_trace[g_head] = *rec;
+    g_head          = (g_head + 1) % TB_TRACE_LEN;
+}
+
+// 動きの無い読み出しとティックは、動きが来るまで同じ種類の 1 レコードに数える
+static void trace_fold(uint8_t kind) {
+    tb_trace_rec_t* last = &g_trace[g_fold[kind]];
+    if (g_fold_live[kind] && last->repeat < UINT16_MAX) {
+        last->repeat++;
+        return;
+    }
+    tb_trace_rec_t rec = {.t_us = timer_read_us(), .repeat = 1, .kind = kind};
+    g_fold[kind]       = g_head;
+    g_fold_live[kind]  = true;
+    trace_append(&rec);
+}
+
+void tb_trace_sample(bool left, int16_t x, int16_t y, bool motion) {
+    if (!g_running) return;
+
+    uint8_t kind = left ? TB_TRACE_LEFT : TB_TRACE_RIGHT;
+    if (!motion && x == 0 && y == 0) {
+        trace_fold(kind);
+        return;
+    }
+    tb_trace_rec_t rec = {
+        .t_us   = timer_read_us(),
+        .repeat = 1,
+        .kind   = kind,
+        .motion = motion,
+        .x      = x,
+        .y      = y,
+    };
+    memset(g_fold_live, 0, sizeof(g_fold_live));
+    trace_append(&rec);
+}
+
+void tb_trace_tick(void) {
+    if (!g_running) return;
+    trace_fold(TB_TRACE_TICK);
+}
+
+// ====== Raw HID ==================================================
+#define TRACE_RECS_PER_PACKET ((RAW_EPSIZE - 2) / sizeof(tb_trace_rec_t))
+
+#define CONFIG_CHUNK (RAW_EPSIZE - 4)
+
+void tb_trace_raw_hid(uint8_t* data, uint8_t length) {
+    uint8_t* body = &data[2];
+
+    switch (data[1]) {
+        case TB_TRACE_ARM:
+            g_head = g_count = 0;
+            g_dropped        = 0;
+            memset(g_fold_live, 0, sizeof(g_fold_live));
+            g_oneshot        = data[2] != 0;
+            g_running        = true;
+            break;
+        case TB_TRACE_STOP:
+            g_running = false;
+            break;
+        case TB_TRACE_INFO:
+            memset(body, 0, length - 2);
+            body[0] = g_running;
+            body[1] = sizeof(tb_trace_rec_t);
+            rawhid_put_u16(&body[2], g_count);
+            rawhid_put_u16(&body[4], TB_TRACE_LEN);
+            rawhid_put_u32(&body[6], g_dropped);
+            break;
+        case TB_TRACE_CONFIG: {
+            // 再生側で同じ設定を使うため、保存形式のまま返す
+            const uint8_t* cfg    = (const uint8_t*)tb_get_config();
+            uint8_t        offset = data[2];
+            memset(&data[3], 0, length - 3);
+            data[3] = sizeof(tb_config_t);
+            if (offset < sizeof(tb_config_t)) {
+                uint8_t n = sizeof(tb_config_t) - offset;
+                memcpy(&data[4], cfg + offset, n < CONFIG_CHUNK ? n : CONFIG_CHUNK);
+            }
+            break;
+        }
+        case TB_TRACE_READ: {
+            // 記録中は読ませない（先頭が動くため）
+            uint16_t start = rawhid_get_u16(&data[2]);
+            memset(body, 0, length - 2);
+            if (g_running) {
+                data[1] = RAWHID_ERR;
+                break;
+            }
+            uint16_t oldest = (g_head + TB_TRACE_LEN - g_count) % TB_TRACE_LEN;
+            for (uint8_t i = 0; i < TRACE_RECS_PER_PACKET && start + i < g_count; ++i) {
+                memcpy(&body[i * sizeof(tb_trace_rec_t)], &g_trace[(oldest + start + i) % TB_TRACE_LEN], sizeof(tb_trace_rec_t));
+            }
+            break;
+        }
+        default:
+            data[1] = RAWHID_ERR;
+            break;
+    }
+}
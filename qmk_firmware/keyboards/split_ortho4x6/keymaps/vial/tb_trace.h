@@ -0,0 +1,54 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_trace.h
+#pragma once
+// トラックボール入力のトレース（センサの読み出し 1 回ごとの生デルタ + µs タイムスタンプ）。
+// console が無効なので pd_dprintf は使えない。代わりに RAM のリングバッファへ
+// 記録し、Vial の raw HID 経由でまとめて吸い出す（scripts/tb_trace_dump.py）。
+// 吸い出したトレースは scripts/tb_replay で tb_task_combined() に再投入できる。
+
+#include "quantum.h"
+#include "pointing_device.h"
+#include "rawhid_cmd.h"
+
+#ifndef TB_TRACE_LEN
+#    define TB_TRACE_LEN 1024 // レコード数（1 レコード 12 バイト）
+#endif
+
+enum tb_trace_subcmd {
+    TB_TRACE_ARM    = 0x01, // data[2]: 0 = 上書き継続, 1 = 満杯で停止
+    TB_TRACE_STOP   = 0x02,
+    TB_TRACE_INFO   = 0x03,
+    TB_TRACE_READ   = 0x04, // data[2..3]: 先頭インデックス（0 = 最古）
+    // 0x05: 設定保存のカウンタは RAWHID_CMD_TB_SAVE（tb.c）へ移した
+    TB_TRACE_CONFIG = 0x06, // 現在の設定（tb_config_t、保存形式のまま）。data[2]: オフセット
+                            // 応答: data[3] = 全体のサイズ, data[4..] = 続き（最大 28 バイト）
+};
+
+// レコードの種類。サンプルは読み出しがあった側、ティックは tb_task_combined() の呼び出し
+enum tb_trace_kind {
+    TB_TRACE_LEFT  = 0,
+    TB_TRACE_RIGHT = 1,
+    TB_TRACE_TICK  = 2,
+};
+
+// 1 レコード。サンプルは読み出し 1 回（report_paw3222_t と時刻）、ティックはそこまでの
+// サンプルを 1 レポートにまとめて変換へ渡した印。動きの無い読み出しとティックは、
+// 次に動きが来るまで同じ種類の直前のレコードの repeat に畳み込む
+// （IIR の減衰と読み出し回数を再現するため、捨てずに数だけ残す）。
+typedef struct __attribute__((packed)) {
+    uint32_t t_us;   // 最初の読み出し/ティックの時刻（timer_read_us()、RP2040 では time_us_32()）
+    uint16_t repeat; // 畳み込んだ数（1 以上）
+    uint8_t  kind;   // tb_trace_kind
+    uint8_t  motion; // report_paw3222_t.isMotion（ティックは 0）
+    int16_t  x, y;   // 読み出したデルタ（ティックは 0）
+} tb_trace_rec_t;
+
+_Static_assert(sizeof(tb_trace_rec_t) == 12, "tb_trace_rec_t must stay 12 bytes");
+
+// センサを読むたびに呼ぶ。自分の側は paw3222.c のサンプラ（MOTION ピンで読み飛ばした
+// スロットも動き無しとして数える）。PAW3222_CORE1 の時はコア 1 から受け取った FIFO の
+// 1 語ごとで、時刻は受け取った時。相手側は tb_split.c が受け取ったフレームごと
+// （相手側の読み出しは転送前に相手側でまとめられている）。
+void tb_trace_sample(bool left, int16_t x, int16_t y, bool motion);
+// tb_task_combined() の直前に呼ぶ（再生側はここでサンプルを 1 レポートにまとめる）
+void tb_trace_tick(void);
+void tb_trace_raw_hid(uint8_t* data, uint8_t length); // RAWHID_CMD_TB_TRACE
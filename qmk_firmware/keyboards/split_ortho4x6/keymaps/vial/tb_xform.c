@@ -0,0 +1,273 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_xform.c
+
+#include "tb_xform.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ====== Config-time helpers ======================================
+tb_rot_t tb_rot_from_deg(int16_t deg) {
+    // 回転方向は従来どおり -deg（Xの余計な反転は行わない）
+    double   rad = (double)deg * (M_PI / 180.0) * -1.0;
+    tb_rot_t r   = {
+        .c = (int32_t)lround(cos(rad) * 32768.0),
+        .s = (int32_t)lround(sin(rad) * 32768.0),
+    };
+    return r;
+}
+
+// CPI はセンサ側で設定するため、ここではセンサで表現できない分の補正
+// cpi / hw_cpi だけを Q8 にする（センサの最小 CPI を下回る設定や、38 刻みへの丸め誤差）。
+// 従来の sensitivity (0.5) * sensitivity_multiplier (1.5) は加速カーブの倍率に含める。
+int32_t tb_cpi_gain_q8(uint16_t cpi, uint16_t hw_cpi) {
+    if (hw_cpi == 0) hw_cpi = cpi;
+    return (int32_t)((256u * cpi + hw_cpi / 2) / hw_cpi);
+}
+
+// センサの CPI を上げるとカウント/ms も比例して増えるため、そのままカーブに入れると
+// 同じ手の速さで加速が早く頭打ちになり、スクロールも速くなる。800 / hw_cpi を Q8 で返す
+int32_t tb_speed_norm_q8(uint16_t hw_cpi) {
+    if (hw_cpi == 0) return TB_ONE;
+    return (int32_t)((256u * TB_CURVE_CPI + hw_cpi / 2) / hw_cpi);
+}
+
+// ====== Acceleration curve =======================================
+// 速度は厳密に増加、点は 1 個以上
+bool tb_accel_valid(const tb_accel_pt_t* pts, uint8_t n) {
+    if (n == 0 || n > TB_ACCEL_POINTS) return false;
+    for (uint8_t i = 1; i < n; ++i) {
+        if (pts[i].speed <= pts[i - 1].speed) return false;
+    }
+    return true;
+}
+
+void tb_accel_build(tb_accel_t* a, const tb_accel_pt_t* pts, uint8_t n) {
+    a->n = n;
+    for (uint8_t i = 0; i < n; ++i) {
+        a->x[i]     = (int32_t)pts[i].speed << (TB_Q - 2); // x4 -> Q8
+        a->y[i]     = (int32_t)pts[i].gain << (TB_Q - 5);  // x32 -> Q8
+        a->slope[i] = 0;
+    }
+    for (uint8_t i = 0; i + 1 < n; ++i) {
+        a->slope[i] = (a->y[i + 1] - a->y[i]) * TB_ONE / (a->x[i + 1] - a->x[i]);
+    }
+}
+
+// v: 速度 (Q8 カウント/ms) -> 倍率 (Q8)
+static int32_t tb_accel_eval(const tb_accel_t* a, int32_t v) {
+    if (v <= a->x[0]) return a->y[0];
+    for (uint8_t i = 0; i + 1 < a->n; ++i) {
+        if (v < a->x[i + 1]) return a->y[i] + (((v - a->x[i]) * a->slope[i]) >> TB_Q);
+    }
+    return a->y[a->n - 1];
+}
+
+// ====== Scroll curve LUT =========================================
+// y = gain * |x|^gamma を事前計算し、レポート毎は表引き + 線形補間のみ。
+// gamma < 1 では原点付近の傾きが大きいため、4 カウント未満は 1/16 刻み、
+// それ以上は 1 カウント刻みの 2 段構成にする。入出力とも Q8。
+#define SC_LUT_FINE_SHIFT (TB_Q - 4) // 1/16 カウント刻み
+#define SC_LUT_FINE_END   (TB_SC_LUT_FINE_N << SC_LUT_FINE_SHIFT)
+
+static int32_t tb_scroll_curve_exact(float x, float gain, float gamma) {
+    return (int32_t)lroundf(gain * powf(x, gamma) * TB_ONE);
+}
+
+// gain / gamma が変わった時だけ呼ぶ
+void tb_scroll_build(tb_scroll_t* sc, float gain, float gamma) {
+    for (uint16_t i = 0; i <= TB_SC_LUT_FINE_N; ++i) {
+        sc->fine[i] = tb_scroll_curve_exact((float)i / (1 << (TB_Q - SC_LUT_FINE_SHIFT)), gain, gamma);
+    }
+    for (uint16_t i = 0; i <= TB_SC_LUT_COARSE_N; ++i) {
+        sc->coarse[i] = tb_scroll_curve_exact((float)(i + SC_LUT_FINE_END / TB_ONE), gain, gamma);
+    }
+}
+
+// a: |x| (Q8) -> gain * |x|^gamma (Q8)
+static int32_t tb_scroll_curve(const tb_scroll_t* sc, int32_t a) {
+    if (a < SC_LUT_FINE_END) {
+        int32_t i  = a >> SC_LUT_FINE_SHIFT;
+        int32_t f  = a & ((1 << SC_LUT_FINE_SHIFT) - 1);
+        int32_t y0 = sc->fine[i];
+        return y0 + (((sc->fine[i + 1] - y0) * f) >> SC_LUT_FINE_SHIFT);
+    }
+    int32_t b = a - SC_LUT_FINE_END;
+    int32_t i = b >> TB_Q;
+    if (i >= TB_SC_LUT_COARSE_N) i = TB_SC_LUT_COARSE_N - 1; // 表の外は最終区間の傾きで外挿
+    int32_t f  = b - (i << TB_Q);
+    int32_t y0 = sc->coarse[i];
+    return y0 + (int32_t)(((int64_t)(sc->coarse[i + 1] - y0) * f) >> TB_Q);
+}
+
+// ====== Core transform (ported from picot_o44) ===================
+// RP2040 (Cortex-M0+) は FPU を持たないため、レポート毎の処理は整数のみで行う。
+
+#ifdef WHEEL_EXTENDED_REPORT
+#    define TB_WHEEL_MAX INT16_MAX
+#else
+#    define TB_WHEEL_MAX INT8_MAX
+#endif
+
+// |v| の近似: max(a, 7/8*a + 1/2*b)（a >= b、誤差 3% 程度）
+static inline int32_t tb_magnitude(int32_t x, int32_t y) {
+    int32_t a = x < 0 ? -x : x;
+    int32_t b = y < 0 ? -y : y;
+    if (a < b) { int32_t t = a; a = b; b = t; }
+    int32_t m = a - (a >> 3) + (b >> 1);
+    return m > a ? m : a;
+}
+
+// Q8 の累積値から整数部を取り出し、端数を残す（0 方向へ切り捨て）
+static inline int32_t tb_take_whole(int32_t* acc, int32_t unit, int32_t lo, int32_t hi) {
+    int32_t out = *acc / unit;
+    if (out > hi) out = hi; else if (out < lo) out = lo;
+    *acc -= out * unit;
+    return out;
+}
+
+// Q8 同士の乗算（四捨五入）
+static inline int32_t tb_mul_q8(int32_t a, int32_t b) {
+    return (a * b + (TB_ONE >> 1)) >> TB_Q;
+}
+
+static inline int32_t tb_sat(int64_t v, int64_t lim) {
+    return (int32_t)(v > lim ? lim : (v < -lim ? -lim : v));
+}
+
+static inline int32_t tb_clamp_in(int32_t v) {
+    return v > TB_IN_LIMIT ? TB_IN_LIMIT : (v < -TB_IN_LIMIT ? -TB_IN_LIMIT : v);
+}
+
+// 四捨五入の除算（切り捨てだと低速で変位が 0 側へ偏る）
+static inline int32_t tb_div_round(int32_t n, int32_t d) {
+    return (n < 0 ? n - d / 2 : n + d / 2) / d;
+}
+
+// ====== Time-aware low-pass ======================================
+// 1 - e^(-dt/tau) (Q15)。e^(-x) は x/16 を 2 次まで展開して 4 回二乗する
+// （誤差 0.1% 未満、除算 1 回と乗算 5 回）。
+static int32_t tb_lpf_alpha_q15(uint32_t dt_us, uint32_t tau_us) {
+    if (dt_us >= 12 * tau_us) return 1 << 15; // e^-12 < 2^-15
+    int32_t y = (int32_t)((dt_us << 11) / tau_us); // x/16 (Q15)
+    int32_t e = (1 << 15) - y + ((y * y) >> 16);
+    for (uint8_t i = 0; i < 4; ++i) e = (e * e + (1 << 14)) >> 15;
+    return (1 << 15) - e;
+}
+
+// 速度の単位を 1024us あたりから 1ms あたりへ（x 1000/1024）。
+// 加速やスクロールのカーブは従来の「1ms 周期の 1 レポートあたり」で定義されている
+// dt が TB_DT_MIN_US で入力が TB_IN_LIMIT の時は 2^24 を超えるので 64 ビットで掛ける
+static inline int32_t tb_per_ms(int32_t v) {
+    return (int32_t)(((int64_t)v * 125) >> 7);
+}
+
+// カーブに入れる速度: 1ms あたり、800 CPI 換算。実際の動きでは届かない値で頭打ちにして、
+// スクロールカーブの外挿（LUT の端より上）を int32 に収める
+#define TB_CURVE_SPEED_MAX (4096 << TB_Q)
+
+static inline int32_t tb_curve_speed(const tb_xform_t* xf, int32_t v) {
+    return tb_sat(((int64_t)tb_per_ms(v) * xf->speed_q8) >> TB_Q, TB_CURVE_SPEED_MAX);
+}
+
+// 1 回の更新量は v 側へ切り上げる。四捨五入だと |v - s| < 0.5 / alpha で止まり、
+// 入力が 0 になっても速度が残り続けて（IIR で ±1、One Euro で ±4）カーソルが這う
+static inline int32_t tb_lpf(int32_t s, int32_t v, int32_t alpha_q15) {
+    int64_t d = (int64_t)(v - s) * alpha_q15;
+    return s + (int32_t)(d >= 0 ? (d + (1 << 15) - 1) >> 15 : -((-d + (1 << 15) - 1) >> 15));
+}
+
+// One Euro: 速度推定からカットオフを決め、その時定数で平滑する
+static int32_t tb_euro_alpha_q15(tb_xform_t* xf, int32_t vx, int32_t vy, uint32_t dt_us) {
+    xf->speed = tb_lpf(xf->speed, tb_magnitude(vx, vy), tb_lpf_alpha_q15(dt_us, 159155 / TB_EURO_D_CUTOFF_HZ));
+
+    // fc (Hz, Q8) -> tau = 1 / (2 pi fc)
+    int32_t fc_q8 = (TB_EURO_MIN_CUTOFF_HZ << TB_Q) + TB_EURO_BETA * xf->speed;
+    if (fc_q8 > (2000 << TB_Q)) fc_q8 = 2000 << TB_Q;
+    return tb_lpf_alpha_q15(dt_us, (159155u << TB_Q) / (uint32_t)fc_q8);
+}
+
+void tb_xform_reset(tb_xform_t* xf) {
+    xf->prev_x = xf->prev_y = 0;
+    xf->speed = 0;
+    xf->acc_x = xf->acc_y = 0;
+    xf->acc_h = xf->acc_v = 0;
+}
+
+void tb_xform_apply(tb_xform_t* xf, const tb_scroll_t* sc, int16_t in_x, int16_t in_y, uint32_t dt_us, tb_xform_out_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (dt_us < TB_DT_MIN_US) dt_us = TB_DT_MIN_US; else if (dt_us > TB_DT_MAX_US) dt_us = TB_DT_MAX_US;
+    const int32_t dt = (int32_t)dt_us;
+
+    // 回転を適用（Q15 x カウント -> Q8）
+    const tb_rot_t* r = &xf->rot;
+    int32_t x = tb_clamp_in(in_x), y = tb_clamp_in(in_y);
+    int32_t rx = (x * r->c - y * r->s + (1 << 6)) >> 7;
+    int32_t ry = (x * r->s + y * r->c + (1 << 6)) >> 7;
+
+    // 速度へ変換して平滑し、dt を掛けて変位 (Q8) に戻す
+    int32_t vx = tb_div_round(rx * (1 << TB_DT_SHIFT), dt);
+    int32_t vy = tb_div_round(ry * (1 << TB_DT_SHIFT), dt);
+    int32_t sx, sy;
+    if (xf->filter == TB_FILTER_NONE) {
+        xf->prev_x = vx;
+        xf->prev_y = vy;
+        sx = rx; // 変換を往復させず、入力をそのまま使う
+        sy = ry;
+    } else {
+        int32_t a = xf->filter == TB_FILTER_ONE_EURO ? tb_euro_alpha_q15(xf, vx, vy, dt_us) : tb_lpf_alpha_q15(dt_us, TB_IIR_TAU_US);
+        xf->prev_x = tb_lpf(xf->prev_x, vx, a);
+        xf->prev_y = tb_lpf(xf->prev_y, vy, a);
+        sx = (int32_t)(((int64_t)xf->prev_x * dt + (1 << (TB_DT_SHIFT - 1))) >> TB_DT_SHIFT);
+        sy = (int32_t)(((int64_t)xf->prev_y * dt + (1 << (TB_DT_SHIFT - 1))) >> TB_DT_SHIFT);
+    }
+
+    if (xf->scroll) {
+        // スクロール専用の非線形カーブ（低速域を持ち上げ、高速域を圧縮）
+        // y = gain * sign(x) * |x|^gamma, 0<gamma
+
+        // 1D scroll selection per side（平滑後の速度ベース）
+        int32_t sx_s = tb_curve_speed(xf, xf->prev_x), sy_s = tb_curve_speed(xf, xf->prev_y);
+        if (abs(sx_s) > abs(sy_s)) sy_s = 0; else sx_s = 0;
+
+        // 非線形変換は速度に掛けてから dt 分の量に戻す（LUT、結果は Q8 で累積）。
+        // 1 レポートあたりの量に掛けると、レポートが細かいほど gamma < 1 で速くなる
+        int64_t sx_nl = sx_s < 0 ? -tb_scroll_curve(sc, -sx_s) : tb_scroll_curve(sc, sx_s);
+        int64_t sy_nl = sy_s < 0 ? -tb_scroll_curve(sc, -sy_s) : tb_scroll_curve(sc, sy_s);
+        sx_nl = (sx_nl * dt * 1049) >> 20; // x dt / 1000
+        sy_nl = (sy_nl * dt * 1049) >> 20;
+
+        // 高解像度では 1/hires ステップ単位で送る。カーブはそのままで、
+        // 1 ステップ分たまるまで何も出ない区間だけが無くなる
+        sx_nl *= sc->hires;
+        sy_nl *= sc->hires;
+
+        // 分割（累積は Q8 のまま保持）。1 回に足す量を 1 レポートで出せる量で頭打ちに
+        // すれば、出力が飽和しても端数は unit 未満に留まり、累積は int32 に収まる
+        const int32_t unit = sc->unit;
+        const int32_t dh   = tb_sat(sx_nl, (int64_t)unit * TB_WHEEL_MAX);
+        const int32_t dv   = tb_sat(sy_nl, (int64_t)unit * TB_WHEEL_MAX);
+        if (sc->inv) { xf->acc_h += dh; xf->acc_v -= dv; }
+        else         { xf->acc_h -= dh; xf->acc_v += dv; }
+
+        // 出力の飽和処理（WHEEL_EXTENDED_REPORTに追従）
+        out->h = tb_take_whole(&xf->acc_h, unit, -TB_WHEEL_MAX - 1, TB_WHEEL_MAX);
+        out->v = tb_take_whole(&xf->acc_v, unit, -TB_WHEEL_MAX - 1, TB_WHEEL_MAX);
+    } else {
+        // 加速カーブ（速度は 800 CPI 換算のカウント / ms）
+        int32_t dyn = tb_accel_eval(&xf->accel, tb_curve_speed(xf, tb_magnitude(xf->prev_x, xf->prev_y)));
+
+        xf->acc_x += tb_mul_q8(tb_mul_q8(sx, dyn), xf->gain_q8);
+        xf->acc_y += tb_mul_q8(tb_mul_q8(sy, dyn), xf->gain_q8);
+
+        // 出力の飽和処理（MOUSE_EXTENDED_REPORTに追従）
+#ifdef MOUSE_EXTENDED_REPORT
+        out->x = tb_take_whole(&xf->acc_x, TB_ONE, INT16_MIN, INT16_MAX);
+        out->y = tb_take_whole(&xf->acc_y, TB_ONE, INT16_MIN, INT16_MAX);
+#else
+        out->x = tb_take_whole(&xf->acc_x, TB_ONE, INT8_MIN, INT8_MAX);
+        out->y = tb_take_whole(&xf->acc_y, TB_ONE, INT8_MIN, INT8_MAX);
+#endif
+    }
+}
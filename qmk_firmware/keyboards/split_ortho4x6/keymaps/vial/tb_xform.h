@@ -0,0 +1,118 @@
+// keyboards/split_ortho4x6/keymaps/vial/tb_xform.h
+#pragma once
+// トラックボール変換の演算部（回転 -> 平滑 -> 速度ゲイン -> 端数累積）。
+// quantum.h に依存しないため、ホスト環境でもそのままコンパイルできる。
+// 設定（キー操作・EEPROM）は tb.c 側で持ち、導出値だけをここへ渡す。
+// 出力の飽和範囲は MOUSE/WHEEL_EXTENDED_REPORT（config.h）に従うため、
+// ホストでビルドする場合は同じ定義を -D で与えること。
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 位置・速度は Q8（1/256 カウント）、係数は Q12/Q15 で保持する。
+#define TB_Q        8
+#define TB_ONE      (1 << TB_Q)
+#define TB_IN_LIMIT 1024 // 1 レポートあたりの入力上限（オーバーフロー防止）
+// 加速とスクロールのカーブを定義した CPI（従来はセンサを電源投入時の約 800 CPI で使っていた）。
+// 速度はセンサの CPI から 800 CPI 換算へ直してからカーブに入れる
+#define TB_CURVE_CPI 800
+
+typedef struct {
+    int32_t c, s; // cos/sin, Q15
+} tb_rot_t;
+
+// ====== Acceleration curve =======================================
+// 速度 -> 倍率の折れ線（sensitivity を含む）。点の間は線形補間、両端の外側は端の値。
+#define TB_ACCEL_POINTS 8
+
+typedef struct __attribute__((packed)) {
+    uint8_t speed; // カウント/ms x4（0..63.75）
+    uint8_t gain;  // 倍率 x32（0..7.97）
+} tb_accel_pt_t;
+
+// 既定: 従来の 0.75 x (1 + v/10)、倍率 0.75..2.25（v = 20 カウント/ms で頭打ち）
+#define TB_ACCEL_DEFAULT {{0, 24}, {80, 72}}
+#define TB_ACCEL_DEFAULT_N 2
+
+// 区間ごとの事前計算（設定変更時に tb_accel_build() で作る）
+typedef struct {
+    uint8_t n;
+    int32_t x[TB_ACCEL_POINTS];     // 速度 (Q8 カウント/ms)
+    int32_t y[TB_ACCEL_POINTS];     // 倍率 (Q8)
+    int32_t slope[TB_ACCEL_POINTS]; // 区間 i..i+1 の傾き (Q8)
+} tb_accel_t;
+
+// ====== Smoothing ================================================
+// 平滑はレポート間隔 dt を使って速度（Q8 カウント / 1024us）に対して行い、
+// 出力は速度 x dt で変位に戻す。スキャン周期やスプリット通信のタイミングが
+// 変わっても時定数（ms）は変わらない。
+typedef enum {
+    TB_FILTER_IIR,      // 一次 IIR（時定数固定）
+    TB_FILTER_ONE_EURO, // 速度が上がるほどカットオフを上げる One Euro 型
+    TB_FILTER_NONE,
+    TB_FILTER_COUNT,
+} tb_filter_t;
+
+#define TB_DT_SHIFT  10 // 速度の時間単位 1024us
+#define TB_DT_MIN_US 16
+#define TB_DT_MAX_US 100000 // 無入力が続いた後の 1 レポート目
+
+// 従来の「1 レポートごとに 0.7」を 1ms 周期で再現する時定数: -1ms / ln(0.7)
+#ifndef TB_IIR_TAU_US
+#    define TB_IIR_TAU_US 2804
+#endif
+// One Euro: カットオフ = MIN_CUTOFF + BETA x 速度（カウント/ms）[Hz]
+// 低速では手ぶれを抑え、速く動かすと遅延がほぼ無くなる
+#ifndef TB_EURO_MIN_CUTOFF_HZ
+#    define TB_EURO_MIN_CUTOFF_HZ 20
+#endif
+#ifndef TB_EURO_BETA
+#    define TB_EURO_BETA 30
+#endif
+#ifndef TB_EURO_D_CUTOFF_HZ
+#    define TB_EURO_D_CUTOFF_HZ 50 // 速度推定そのものの平滑
+#endif
+
+// スクロールカーブ LUT（左右共通）
+#define TB_SC_LUT_FINE_N   64  // 0..4 カウントを 1/16 刻み
+#define TB_SC_LUT_COARSE_N 252 // 4..256 カウントを 1 刻み
+
+typedef struct {
+    int32_t fine[TB_SC_LUT_FINE_N + 1];
+    int32_t coarse[TB_SC_LUT_COARSE_N + 1];
+    int32_t  unit;  // 1 ステップあたりの量 (Q8)
+    uint16_t hires; // 1 ステップを何分割して送るか（1 = 整数ステップのみ）
+    bool     inv;
+} tb_scroll_t;
+
+typedef struct {
+    // 設定から導出した値（設定変更時のみ更新）
+    tb_rot_t   rot;
+    int32_t    gain_q8;  // CPI の補正（センサで表現できない分）
+    int32_t    speed_q8; // 速度を 800 CPI 換算に直す係数（tb_speed_norm_q8()）
+    tb_accel_t accel;
+    bool       scroll;
+    uint8_t    filter; // tb_filter_t
+    // 状態
+    int32_t prev_x, prev_y; // 平滑後の速度 (Q8 / 1024us)
+    int32_t speed;          // One Euro の速度推定 (Q8 / 1024us)
+    int32_t acc_x, acc_y;   // カーソルの端数 (Q8)
+    int32_t acc_h, acc_v;   // スクロールの端数 (Q8)
+} tb_xform_t;
+
+typedef struct {
+    int16_t x, y; // カーソル
+    int16_t h, v; // スクロール
+} tb_xform_out_t;
+
+// 設定変更時に使う（float 演算を含むためレポート毎には呼ばない）
+tb_rot_t tb_rot_from_deg(int16_t deg);
+int32_t  tb_cpi_gain_q8(uint16_t cpi, uint16_t hw_cpi);
+int32_t  tb_speed_norm_q8(uint16_t hw_cpi);
+void     tb_scroll_build(tb_scroll_t* sc, float gain, float gamma);
+bool     tb_accel_valid(const tb_accel_pt_t* pts, uint8_t n);
+void     tb_accel_build(tb_accel_t* a, const tb_accel_pt_t* pts, uint8_t n);
+
+void tb_xform_reset(tb_xform_t* xf);
+// dt_us: 前回のレポートからの経過時間
+void tb_xform_apply(tb_xform_t* xf, const tb_scroll_t* sc, int16_t in_x, int16_t in_y, uint32_t dt_us, tb_xform_out_t* out);
@@ -0,0 +1,116 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// COL2ROW matrix scan for this board (CUSTOM_MATRIX = lite, FAST_MATRIX_ENABLE
+// in rules.mk). The pins come from keyboard.json as usual; what changes is how
+// a row is read:
+//  - all columns are sampled with a single SIO gpio_in read and mapped to
+//    matrix bits through a per-column mask table built for the current half
+//    (the halves use different pins, and the right one has a NO_PIN column)
+//  - rows are switched by toggling output enable on a pin whose output latch
+//    is already low, instead of reconfiguring the pad each time
+//  - after a row, the wait is only as long as a column is still being pulled
+//    back up, and only if a key on that row was down; the stock matrix waits
+//    MATRIX_IO_DELAY after every row regardless
+// Debounce, split sync and the rest stay with QMK's matrix_common.c.
+
+#include "matrix.h"
+#include "gpio.h"
+#include "split_util.h"
+#include "wait.h"
+
+#include "hardware/structs/sio.h"
+#include "hardware/timer.h"
+
+// Upper bound for a column to recover after its row is released
+#ifndef MATRIX_IO_DELAY
+#define MATRIX_IO_DELAY 30
+#endif
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+static const pin_t row_pins_left[ROWS_PER_HAND] = MATRIX_ROW_PINS;
+static const pin_t col_pins_left[MATRIX_COLS] = MATRIX_COL_PINS;
+static const pin_t row_pins_right[ROWS_PER_HAND] = MATRIX_ROW_PINS_RIGHT;
+static const pin_t col_pins_right[MATRIX_COLS] = MATRIX_COL_PINS_RIGHT;
+
+static uint32_t row_bit[ROWS_PER_HAND]; // SIO bit driving each row
+static uint32_t col_bit[MATRIX_COLS];   // SIO bit of each column, 0 for NO_PIN
+static uint32_t col_bits;               // all column bits
+
+static inline uint32_t pin_bit(pin_t pin) { return 1u << PAL_PAD(pin); }
+
+void matrix_init_custom(void) {
+  bool left = is_keyboard_left();
+  const pin_t *rows = left ? row_pins_left : row_pins_right;
+  const pin_t *cols = left ? col_pins_left : col_pins_right;
+
+  // Rows idle as pulled-up inputs; enabling the output drives the low latch
+  for (uint8_t r = 0; r < ROWS_PER_HAND; r++) {
+    row_bit[r] = pin_bit(rows[r]);
+    gpio_set_pin_input_high(rows[r]);
+    sio_hw->gpio_clr = row_bit[r];
+  }
+
+  col_bits = 0;
+  for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+    col_bit[c] = 0;
+    if (cols[c] != NO_PIN) {
+      col_bit[c] = pin_bit(cols[c]);
+      col_bits |= col_bit[c];
+      gpio_set_pin_input_high(cols[c]);
+    }
+  }
+}
+
+static inline matrix_row_t cols_to_row(uint32_t low) {
+  matrix_row_t row = 0;
+  for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+    if (low & col_bit[c]) {
+      row |= (matrix_row_t)1 << c;
+    }
+  }
+  return row;
+}
+
+// With every row released nothing drives a column low, so once they all
+// read high again the next row cannot see a ghost of this one.
+static inline void wait_cols_released(void) {
+  uint32_t start = time_us_32();
+  while ((~sio_hw->gpio_in & col_bits) && time_us_32() - start < MATRIX_IO_DELAY) {
+  }
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+  bool changed = false;
+
+  for (uint8_t r = 0; r < ROWS_PER_HAND; r++) {
+    sio_hw->gpio_oe_set = row_bit[r];
+    matrix_output_select_delay();
+    uint32_t low = ~sio_hw->gpio_in & col_bits;
+    sio_hw->gpio_oe_clr = row_bit[r];
+
+    if (low) {
+      wait_cols_released();
+    }
+    matrix_row_t row = cols_to_row(low);
+    if (current_matrix[r] != row) {
+      current_matrix[r] = row;
+      changed = true;
+    }
+  }
+  return changed;
+}
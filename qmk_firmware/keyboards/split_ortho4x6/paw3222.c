@@ -22,8 +22,16 @@
 #include "debug.h"
 #include "gpio.h"
 #include "paw3222.h"
+#include "paw3222_bus.h"
+#ifdef PAW3222_CORE1
+#include "paw3222_core1.h"
+#endif
 #include "pointing_device_internal.h"
-#include "wait.h"
+#include "timer_us.h"
+#include "scan_prof.h" // keymaps/vial; the hooks compile to nothing unless SCAN_PROFILER_ENABLE
+#ifdef TB_TRACE_ENABLE
+#include "tb_trace.h" // keymaps/vial
+#endif
 
 #define REG_PID1 0x00
 #define REG_PID2 0x01
@@ -36,6 +44,9 @@
 
 #define REG_PROTECT 0x09
 
+#define STAT_MOTION 0x80
+#define STAT_FLOATING 0xFF // reserved bits set: nothing is driving SDIO
+
 #define VAL_PROTECT_DISABLE 0x5A
 #define VAL_PROTECT_ENABLE 0x00
 
@@ -53,14 +64,33 @@ enum cpi_values {
   CPI1600, // 0b110
 };
 
-#define CPI_STEP 38
-#define CPI_MIN (16 * CPI_STEP)
-#define CPI_MAX (127 * CPI_STEP)
-
-uint8_t paw3222_serial_read(void);
-void paw3222_serial_write(uint8_t reg_addr);
-uint8_t paw3222_read_reg(uint8_t reg_addr);
-void paw3222_write_reg(uint8_t reg_addr, uint8_t data);
+#define CPI_STEP PAW3222_CPI_STEP
+#define CPI_MIN PAW3222_CPI_MIN
+#define CPI_MAX PAW3222_CPI_MAX
+uint8_t paw3222_read_reg(paw3222_t *dev, uint8_t reg_addr);
+void paw3222_write_reg(paw3222_t *dev, uint8_t reg_addr, uint8_t data);
+static void paw3222_transfer(paw3222_t *dev, paw3222_xfer_t *xfers, uint8_t count);
+static void paw3222_program_cpi(paw3222_t *dev, uint8_t cpival);
+
+#ifdef PAW3222_MOTION_PIN
+paw3222_t paw3222_primary = PAW3222_INSTANCE(PAW3222_CS_PIN, PAW3222_MOTION_PIN);
+#else
+paw3222_t paw3222_primary = PAW3222_INSTANCE(PAW3222_CS_PIN, NO_PIN);
+#endif
+
+static bool bus_ready;
+static paw3222_bus_stats_t bus_stats;
+static paw3222_sampler_stats_t sampler_stats = {.interval_us = PAW3222_SAMPLE_INTERVAL_US};
+static uint32_t sample_next;
+// motion integrated since the last report; only touched on core 0
+static int32_t carry_x, carry_y;
+
+_Static_assert(PAW3222_SAMPLE_INTERVAL_US >= 100 && PAW3222_SAMPLE_INTERVAL_US <= UINT16_MAX,
+               "PAW3222_SAMPLE_INTERVAL_US out of range");
+
+static void paw3222_motion_cb(void *arg) {
+  ((paw3222_t *)arg)->motion_pending = true;
+}
 
 const pointing_device_driver_t paw3222_pointing_device_driver = {
     .init = paw3222_init,
@@ -69,87 +99,232 @@ const pointing_device_driver_t paw3222_pointing_device_driver = {
     .get_cpi = paw3222_get_cpi,
 };
 
-void paw3222_init(void) {
-  gpio_write_pin_high(PAW3222_CS_PIN);       // set cs pin high
-  gpio_set_pin_output(PAW3222_CS_PIN);       // set cs pin to output
-  gpio_write_pin_high(PAW3222_SCLK_PIN);     // set clock pin high
-  gpio_set_pin_output(PAW3222_SCLK_PIN);     // setclockpin to output
-  gpio_set_pin_input_high(PAW3222_SDIO_PIN); // set datapin input high
+// ====== Instances ================================================
+void paw3222_dev_init(paw3222_t *dev) {
+  gpio_write_pin_high(dev->cs_pin); // set cs pin high
+  gpio_set_pin_output(dev->cs_pin); // set cs pin to output
+  if (!bus_ready) {
+    paw3222_bus_init();
+    bus_ready = true;
+  }
 
-  paw3222_write_reg(REG_CONFIGURATION, 0x80); // reset sensor
-  wait_ms(2);
+  if (dev->motion_pin != NO_PIN) {
+    // Start pending so the first tick drains whatever the sensor latched
+    dev->motion_pending = true;
+    gpio_set_pin_input_high(dev->motion_pin);
+    palEnableLineEvent(dev->motion_pin, PAL_EVENT_MODE_FALLING_EDGE);
+    palSetLineCallback(dev->motion_pin, paw3222_motion_cb, dev);
+  }
 
-  paw3222_read_reg(0x00); // read id
-  paw3222_read_reg(0x01); // read id2
-  paw3222_read_reg(0x02);
-  paw3222_read_reg(0x03);
-  paw3222_read_reg(0x04);
-  paw3222_read_reg(0x12);
+  // the reset and PID check happen in paw3222_dev_service() so boot is not
+  // held up
+  dev->status.state = PAW3222_STATE_RESET;
+  dev->state_until = timer_read_us();
 }
 
-uint8_t paw3222_serial_read(void) {
-  gpio_set_pin_input(PAW3222_SDIO_PIN);
-  uint8_t byte = 0;
+static void paw3222_enter(paw3222_t *dev, paw3222_state_t state, uint32_t wait_us) {
+  dev->status.state = state;
+  dev->state_until = timer_read_us() + wait_us;
+}
 
-  for (uint8_t i = 0; i < 8; ++i) {
-    gpio_write_pin_low(PAW3222_SCLK_PIN);
-    wait_us(1);
+// Brings the sensor up after the reset delay: read id, id2, the power-on CPI
+// and flush stale motion in one transaction, then restore the requested CPI.
+static bool paw3222_boot(paw3222_t *dev) {
+  paw3222_xfer_t flush[] = {
+      {.addr = REG_PID1}, {.addr = REG_PID2}, {.addr = REG_STAT},
+      {.addr = REG_X},    {.addr = REG_Y},    {.addr = 0x12},
+      {.addr = REG_CPI_X},
+  };
+  _Static_assert(sizeof(flush) / sizeof(flush[0]) <= PAW3222_BUS_MAX_WORDS, "flush does not fit in one CS window");
+  paw3222_transfer(dev, flush, sizeof(flush) / sizeof(flush[0]));
+  dev->status.pid = flush[0].data;
+  if (dev->status.pid != PAW3222_PID1) {
+    pd_dprintf("PAW3222 CS %u: PID 0x%02X, retrying\n", (unsigned)dev->cs_pin, dev->status.pid);
+    paw3222_enter(dev, PAW3222_STATE_OFFLINE, PAW3222_RETRY_INTERVAL_MS * 1000UL);
+    return false;
+  }
+
+  dev->cpi_reg = flush[6].data;
+  if (dev->cpi_target) {
+    uint16_t cpi = constrain(dev->cpi_target, CPI_MIN, CPI_MAX);
+    paw3222_program_cpi(dev, (cpi + (CPI_STEP >> 1)) / CPI_STEP);
+  } else {
+    dev->cpi_cache = dev->cpi_reg * CPI_STEP;
+  }
+  dev->status.inits++;
+  if (dev->motion_pin != NO_PIN) {
+    dev->motion_pending = true;
+  }
+  paw3222_enter(dev, PAW3222_STATE_READY, PAW3222_PROBE_INTERVAL_MS * 1000UL);
+  return true;
+}
 
-    byte = (byte << 1) | gpio_read_pin(PAW3222_SDIO_PIN);
+// Unplugged, the bus reads back its idle level instead of the PID; after a
+// brown-out the sensor answers again but with its power-on CPI.
+static bool paw3222_probe(paw3222_t *dev) {
+  paw3222_xfer_t probe[] = {{.addr = REG_PID1}, {.addr = REG_CPI_X}};
+  paw3222_transfer(dev, probe, 2);
+  dev->status.pid = probe[0].data;
+  if (dev->status.pid != PAW3222_PID1 || probe[1].data != dev->cpi_reg) {
+    pd_dprintf("PAW3222 CS %u: lost (PID 0x%02X CPI 0x%02X)\n", (unsigned)dev->cs_pin, dev->status.pid,
+               probe[1].data);
+    dev->status.lost++;
+    paw3222_enter(dev, PAW3222_STATE_RESET, 0);
+    return false;
+  }
+  paw3222_enter(dev, PAW3222_STATE_READY, PAW3222_PROBE_INTERVAL_MS * 1000UL);
+  return true;
+}
 
-    gpio_write_pin_high(PAW3222_SCLK_PIN);
-    wait_us(1);
+bool paw3222_dev_service(paw3222_t *dev) {
+  bool ready = dev->status.state == PAW3222_STATE_READY;
+  if ((int32_t)(timer_read_us() - dev->state_until) < 0) {
+    return ready;
   }
 
-  return byte;
+  switch (dev->status.state) {
+  case PAW3222_STATE_RESET:
+  case PAW3222_STATE_OFFLINE:
+    paw3222_write_reg(dev, REG_CONFIGURATION, 0x80); // reset sensor
+    paw3222_enter(dev, PAW3222_STATE_BOOT, PAW3222_RESET_WAIT_US);
+    return false;
+  case PAW3222_STATE_BOOT:
+    return paw3222_boot(dev);
+  case PAW3222_STATE_READY:
+    return paw3222_probe(dev);
+  }
+  return false;
 }
 
-void paw3222_serial_write(uint8_t data) {
-  gpio_write_pin_low(PAW3222_SDIO_PIN);
-  gpio_set_pin_output(PAW3222_SDIO_PIN);
+const paw3222_status_t *paw3222_dev_get_status(const paw3222_t *dev) { return &dev->status; }
 
-  for (int8_t b = 7; b >= 0; b--) {
-    gpio_write_pin_low(PAW3222_SCLK_PIN);
-    if (data & (1 << b)) {
-      gpio_write_pin_high(PAW3222_SDIO_PIN);
-    } else {
-      gpio_write_pin_low(PAW3222_SDIO_PIN);
-    }
-    gpio_write_pin_high(PAW3222_SCLK_PIN);
+static void paw3222_transfer(paw3222_t *dev, paw3222_xfer_t *xfers, uint8_t count) {
+  gpio_write_pin_low(dev->cs_pin); // set cs pin low
+  paw3222_bus_transfer(dev->cs_pin, xfers, count);
+  gpio_write_pin_high(dev->cs_pin); // set cs pin high
+}
+
+// The MOTION edge only latches the pending flag; the bus is touched from the
+// sampler. MOTION stays low while more data is queued, so the flag is
+// re-armed after the read instead of waiting for another edge.
+static bool paw3222_take_motion(paw3222_t *dev) {
+  if (dev->motion_pin == NO_PIN) {
+    return true;
   }
+  if (!dev->motion_pending) {
+    bus_stats.idle_skips++;
+    return false;
+  }
+  dev->motion_pending = false;
+  return true;
+}
 
-  wait_us(4);
+static void paw3222_rearm_motion(paw3222_t *dev) {
+  if (dev->motion_pin != NO_PIN && !gpio_read_pin(dev->motion_pin)) {
+    dev->motion_pending = true;
+  }
 }
 
-report_paw3222_t paw3222_read(void) {
+// STAT is read first and the CS window is closed right there when the motion
+// bit is clear. With motion, X and Y follow in the same window so each sensor
+// costs one select/deselect. Define PAW3222_READ_PER_REGISTER to get the
+// original three-window read for comparison.
+static report_paw3222_t paw3222_read_one(paw3222_t *dev) {
   report_paw3222_t data = {0};
 
-  data.isMotion = paw3222_read_reg(REG_STAT) &
-                  (1 << 7); // check for motion only (bit 7 in field)
-  data.x = (int8_t)paw3222_read_reg(REG_X);
-  data.y = (int8_t)paw3222_read_reg(REG_Y);
+#ifdef PAW3222_READ_PER_REGISTER
+  data.isMotion = paw3222_read_reg(dev, REG_STAT) & STAT_MOTION;
+  data.x = (int8_t)paw3222_read_reg(dev, REG_X);
+  data.y = (int8_t)paw3222_read_reg(dev, REG_Y);
+#else
+  paw3222_xfer_t stat = {.addr = REG_STAT};
+  gpio_write_pin_low(dev->cs_pin); // set cs pin low
+  paw3222_bus_transfer(dev->cs_pin, &stat, 1);
+  if (stat.data == STAT_FLOATING) {
+    // don't turn the pulled-up bus into motion; probe on the next slot
+    stat.data = 0;
+    dev->state_until = timer_read_us();
+  }
+  data.isMotion = stat.data & STAT_MOTION;
+  if (data.isMotion) {
+    paw3222_xfer_t xy[] = {{.addr = REG_X}, {.addr = REG_Y}};
+    paw3222_bus_transfer(dev->cs_pin, xy, 2);
+    data.x = (int8_t)xy[0].data;
+    data.y = (int8_t)xy[1].data;
+  }
+  gpio_write_pin_high(dev->cs_pin); // set cs pin high
+#endif
 
+  if (data.x == INT8_MAX || data.x == INT8_MIN || data.y == INT8_MAX ||
+      data.y == INT8_MIN) {
+    sampler_stats.saturated++;
+  }
   return data;
 }
 
-void paw3222_write_reg(uint8_t reg_addr, uint8_t data) {
-  gpio_write_pin_low(PAW3222_CS_PIN); // set cs pin low
-  paw3222_serial_write(0b10000000 | reg_addr);
-  paw3222_serial_write(data);
-  gpio_write_pin_high(PAW3222_CS_PIN); // set cs pin high
+static void paw3222_account(uint32_t start, bool motion) {
+  uint32_t elapsed = timer_read_us() - start;
+  bus_stats.polls++;
+  if (motion) {
+    bus_stats.motion_polls++;
+  }
+  bus_stats.bus_us_last = elapsed;
+  bus_stats.bus_us_total += elapsed;
+  if (elapsed > bus_stats.bus_us_max) {
+    bus_stats.bus_us_max = elapsed;
+  }
 }
 
-uint8_t paw3222_read_reg(uint8_t reg_addr) {
-  gpio_write_pin_low(PAW3222_CS_PIN); // set cs pin low
-  paw3222_serial_write(reg_addr);
-  wait_us(5);
-  uint8_t reg = paw3222_serial_read();
-  gpio_write_pin_high(PAW3222_CS_PIN); // set cs pin high
+// Bring-up and probes run first so the reads themselves go out back to back.
+uint8_t paw3222_dev_read_batch(paw3222_t *const *devs, uint8_t count, report_paw3222_t *out) {
+  uint8_t due = 0;
+  for (uint8_t i = 0; i < count && i < PAW3222_MAX_INSTANCES; i++) {
+    out[i] = (report_paw3222_t){0};
+    if (paw3222_dev_service(devs[i]) && paw3222_take_motion(devs[i])) {
+      due |= 1u << i;
+    }
+  }
+  if (!due) {
+    return 0;
+  }
+
+  uint8_t moved = 0;
+  uint32_t start = timer_read_us();
+  for (uint8_t i = 0; i < count && i < PAW3222_MAX_INSTANCES; i++) {
+    if (due & (1u << i)) {
+      out[i] = paw3222_read_one(devs[i]);
+      if (out[i].isMotion) {
+        moved |= 1u << i;
+      }
+    }
+  }
+  paw3222_account(start, moved);
 
-  return reg;
+  for (uint8_t i = 0; i < count && i < PAW3222_MAX_INSTANCES; i++) {
+    if (due & (1u << i)) {
+      paw3222_rearm_motion(devs[i]);
+    }
+  }
+  return moved;
 }
 
-void paw3222_set_cpi(uint16_t cpi) {
+const paw3222_bus_stats_t *paw3222_get_bus_stats(void) { return &bus_stats; }
+
+void paw3222_reset_bus_stats(void) { bus_stats = (paw3222_bus_stats_t){0}; }
+
+void paw3222_write_reg(paw3222_t *dev, uint8_t reg_addr, uint8_t data) {
+  paw3222_xfer_t xfer = {.addr = PAW3222_WRITE | reg_addr, .data = data};
+  paw3222_transfer(dev, &xfer, 1);
+}
+
+uint8_t paw3222_read_reg(paw3222_t *dev, uint8_t reg_addr) {
+  paw3222_xfer_t xfer = {.addr = reg_addr};
+  paw3222_transfer(dev, &xfer, 1);
+
+  return xfer.data;
+}
+
+void paw3222_dev_write_cpi(paw3222_t *dev, uint16_t cpi) {
   if (cpi < CPI_MIN) {
     cpi = CPI_MIN;
   } else if (cpi > CPI_MAX) {
@@ -157,30 +332,143 @@ void paw3222_set_cpi(uint16_t cpi) {
   }
   uint8_t cpival = (cpi + (CPI_STEP >> 1)) / CPI_STEP;
 
-  paw3222_write_reg(REG_PROTECT, VAL_PROTECT_DISABLE);
-  paw3222_write_reg(REG_CPI_X, cpival);
-  paw3222_write_reg(REG_CPI_Y, cpival);
-  paw3222_write_reg(REG_PROTECT, VAL_PROTECT_ENABLE);
+  dev->cpi_target = cpi;
+  dev->cpi_cache = cpival * CPI_STEP;
+  if (dev->status.state == PAW3222_STATE_READY) {
+    paw3222_program_cpi(dev, cpival);
+  }
+}
+
+static void paw3222_program_cpi(paw3222_t *dev, uint8_t cpival) {
+  paw3222_xfer_t xfers[] = {
+      {.addr = PAW3222_WRITE | REG_PROTECT, .data = VAL_PROTECT_DISABLE},
+      {.addr = PAW3222_WRITE | REG_CPI_X, .data = cpival},
+      {.addr = PAW3222_WRITE | REG_CPI_Y, .data = cpival},
+      {.addr = PAW3222_WRITE | REG_PROTECT, .data = VAL_PROTECT_ENABLE},
+  };
+  _Static_assert(2 * sizeof(xfers) / sizeof(xfers[0]) <= PAW3222_BUS_MAX_WORDS, "CPI write does not fit in one CS window");
+  paw3222_transfer(dev, xfers, sizeof(xfers) / sizeof(xfers[0]));
+  dev->cpi_reg = cpival;
+  dev->cpi_cache = cpival * CPI_STEP;
+}
+
+uint16_t paw3222_dev_get_cpi(const paw3222_t *dev) { return dev->cpi_cache; }
+
+// ====== Primary sensor ===========================================
+void paw3222_init(void) {
+  paw3222_dev_init(&paw3222_primary);
+  sample_next = timer_read_us();
+
+#ifdef PAW3222_CORE1
+  paw3222_core1_start();
+#endif
+}
+
+bool paw3222_service(void) { return paw3222_dev_service(&paw3222_primary); }
+
+const paw3222_status_t *paw3222_get_status(void) { return &paw3222_primary.status; }
+
+report_paw3222_t paw3222_read(void) {
+  uint32_t start = timer_read_us();
+  report_paw3222_t data = paw3222_read_one(&paw3222_primary);
+  paw3222_account(start, data.isMotion);
+  return data;
+}
+
+void paw3222_set_cpi(uint16_t cpi) {
+#ifdef PAW3222_CORE1
+  if (paw3222_core1_running()) {
+    // the bus and cpi_cache belong to core 1; it programs the value before
+    // its next sample and reports it back through the FIFO
+    paw3222_core1_post_cpi(constrain(cpi, CPI_MIN, CPI_MAX));
+    return;
+  }
+#endif
+  paw3222_write_cpi(cpi);
 }
 
+void paw3222_write_cpi(uint16_t cpi) { paw3222_dev_write_cpi(&paw3222_primary, cpi); }
+
 uint16_t paw3222_get_cpi(void) {
-  return paw3222_read_reg(REG_CPI_X) * CPI_STEP;
+#ifdef PAW3222_CORE1
+  if (paw3222_core1_running()) {
+    return paw3222_core1_cpi();
+  }
+#endif
+  return paw3222_dev_get_cpi(&paw3222_primary);
+}
+
+bool paw3222_sample(int16_t *x, int16_t *y) {
+  static paw3222_t *const devs[] = {&paw3222_primary};
+  report_paw3222_t data;
+  if (!paw3222_dev_read_batch(devs, 1, &data)) {
+    return false;
+  }
+  *x = data.x;
+  *y = data.y;
+  return true;
+}
+
+bool paw3222_sampler_due(void) {
+  int32_t behind = (int32_t)(timer_read_us() - sample_next);
+  if (behind < 0) {
+    return false;
+  }
+  uint32_t missed = (uint32_t)behind / PAW3222_SAMPLE_INTERVAL_US;
+  sampler_stats.late += missed;
+  sample_next += (missed + 1) * PAW3222_SAMPLE_INTERVAL_US;
+  sampler_stats.ticks++;
+  return true;
 }
 
-uint8_t read_pid_paw3222(void) { return paw3222_read_reg(REG_PID1); }
+void paw3222_sampler_task(void) {
+#ifdef PAW3222_CORE1
+  if (paw3222_core1_running()) {
+    // core 1 owns the bus, so the sensor stage measures what is left on core 0
+    SCAN_PROF_BEGIN(SCAN_PROF_SENSOR);
+    paw3222_core1_take(&carry_x, &carry_y);
+    SCAN_PROF_END(SCAN_PROF_SENSOR);
+    return;
+  }
+#endif
+  if (!paw3222_sampler_due()) {
+    return;
+  }
+
+  int16_t x, y;
+  SCAN_PROF_BEGIN(SCAN_PROF_SENSOR);
+  bool motion = paw3222_sample(&x, &y);
+  SCAN_PROF_END(SCAN_PROF_SENSOR);
+  if (!motion) {
+    x = y = 0;
+  }
+#ifdef TB_TRACE_ENABLE
+  tb_trace_sample(is_keyboard_left(), x, y, motion);
+#endif
+  if (motion) {
+    pd_dprintf("Raw ] X: %d, Y: %d\n", x, y);
+    carry_x += x;
+    carry_y += y;
+  }
+}
+
+const paw3222_sampler_stats_t *paw3222_get_sampler_stats(void) {
+  return &sampler_stats;
+}
 
 // 注意: motionが無いフレームでは x/y を必ず0にリセットし、
 // 直前フレームのデルタが再利用されるのを防ぐ（累積ドリフト/ジャンプ対策）。
 report_mouse_t paw3222_get_report(report_mouse_t mouse_report) {
-  report_paw3222_t data = paw3222_read();
-  // デフォルトは0（無入力）
-  mouse_report.x = 0;
-  mouse_report.y = 0;
-  if (data.isMotion) {
-    pd_dprintf("Raw ] X: %d, Y: %d\n", data.x, data.y);
-    mouse_report.x = data.x;
-    mouse_report.y = data.y;
-  }
+  // catch the current slot in case housekeeping has not run since
+  paw3222_sampler_task();
+
+  // Everything sampled since the last tick goes out as one report; whatever
+  // exceeds the report range is carried to the next instead of being clipped.
+  mouse_report.x = constrain(carry_x, XY_REPORT_MIN, XY_REPORT_MAX);
+  mouse_report.y = constrain(carry_y, XY_REPORT_MIN, XY_REPORT_MAX);
+  carry_x -= mouse_report.x;
+  carry_y -= mouse_report.y;
+  sampler_stats.reports++;
   return mouse_report;
 }
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "gpio.h"
 #include "pointing_device.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -42,6 +43,38 @@
 #define PAW3222_CS_PIN 21
 #endif
 #endif
+// Optional active-low MOTION output. Without it the sensor is polled on every
+// sample slot (PAW3222_SAMPLE_INTERVAL_US).
+#ifndef PAW3222_MOTION_PIN
+#ifdef POINTING_DEVICE_MOTION_PIN
+#define PAW3222_MOTION_PIN POINTING_DEVICE_MOTION_PIN
+#endif
+#endif
+
+// Sensor sampling period, independent of POINTING_DEVICE_TASK_THROTTLE_MS.
+// Deltas read in between pointing task ticks are integrated and handed out
+// as one report, so fast flicks do not saturate the int8 X/Y registers.
+#ifndef PAW3222_SAMPLE_INTERVAL_US
+#define PAW3222_SAMPLE_INTERVAL_US 500 // 2 kHz
+#endif
+
+// Bring-up and health check. Nothing here blocks: the steps run from the
+// sampler (or core 1), one bus transaction at a time.
+#define PAW3222_PID1 0x30
+#ifndef PAW3222_RESET_WAIT_US
+#define PAW3222_RESET_WAIT_US 2000 // soft reset to first register access
+#endif
+#ifndef PAW3222_PROBE_INTERVAL_MS
+#define PAW3222_PROBE_INTERVAL_MS 500 // PID/CPI re-check while running
+#endif
+#ifndef PAW3222_RETRY_INTERVAL_MS
+#define PAW3222_RETRY_INTERVAL_MS 250 // next bring-up after a bad PID
+#endif
+
+// CPI register granularity and range (REG_CPI_X/Y hold cpi / 38)
+#define PAW3222_CPI_STEP 38
+#define PAW3222_CPI_MIN (16 * PAW3222_CPI_STEP)
+#define PAW3222_CPI_MAX (127 * PAW3222_CPI_STEP)
 
 typedef struct {
   int16_t x;
@@ -49,17 +82,112 @@ typedef struct {
   bool isMotion;
 } report_paw3222_t;
 
-const pointing_device_driver_t paw3222_pointing_device_driver;
+typedef struct {
+  uint32_t polls;        // read passes (one per paw3222_dev_read_batch())
+  uint32_t motion_polls; // passes where a sensor had the motion bit set
+  uint32_t bus_us_last;  // bus time of the most recent pass
+  uint32_t bus_us_max;
+  uint32_t bus_us_total; // divide by polls for the average
+  uint32_t idle_skips;   // sensors skipped because MOTION was not asserted
+} paw3222_bus_stats_t;
+
+typedef struct {
+  uint32_t ticks;     // sample slots taken (idle MOTION slots included)
+  uint32_t late;      // slots that passed while the caller was busy
+  uint32_t saturated; // reads where X or Y hit the int8 limit
+  uint32_t reports;   // consolidated reports handed to the pointing task
+  uint16_t interval_us;
+} paw3222_sampler_stats_t;
+
+typedef enum {
+  PAW3222_STATE_RESET,   // soft reset pending
+  PAW3222_STATE_BOOT,    // waiting PAW3222_RESET_WAIT_US after the reset
+  PAW3222_STATE_READY,   // sampling
+  PAW3222_STATE_OFFLINE, // wrong or no PID, waiting to retry
+} paw3222_state_t;
+
+typedef struct __attribute__((packed)) {
+  uint8_t state;  // paw3222_state_t
+  uint8_t pid;    // REG_PID1 as last read
+  uint16_t inits; // successful bring-ups, boot included
+  uint16_t lost;  // times a running sensor went missing or came back reset
+} paw3222_status_t;
+
+// One sensor. Every instance shares SCLK/SDIO (PAW3222_SCLK_PIN /
+// PAW3222_SDIO_PIN, owned by the bus backend) and has its own CS and
+// optional MOTION line. Fill the pins with PAW3222_INSTANCE() and leave the
+// rest to the driver.
+typedef struct {
+  pin_t cs_pin;
+  pin_t motion_pin; // NO_PIN: poll on every sample slot
+  volatile bool motion_pending;
+  paw3222_status_t status;
+  uint32_t state_until; // timer_read_us() at which the state acts next
+  uint16_t cpi_cache;   // CPI reported by paw3222_dev_get_cpi()
+  uint16_t cpi_target;  // last requested CPI, 0 = keep the power-on value
+  uint8_t cpi_reg;      // what REG_CPI_X should hold
+} paw3222_t;
+
+#define PAW3222_INSTANCE(cs, motion) {.cs_pin = (cs), .motion_pin = (motion)}
+
+// Upper bound for paw3222_dev_read_batch()
+#define PAW3222_MAX_INSTANCES 4
+
+// The pointing device sensor (PAW3222_CS_PIN / PAW3222_MOTION_PIN). The
+// paw3222_* functions without a device argument act on this one.
+extern paw3222_t paw3222_primary;
+
+extern const pointing_device_driver_t paw3222_pointing_device_driver;
+
+// ====== Per-instance API ========================================
+// Instances sharing the bus must all be driven from the same context (the
+// sampler, or core 1 with PAW3222_CORE1).
+
+/**
+ * @brief Sets up the instance's CS/MOTION pins and schedules its bring-up.
+ * The bus itself is set up once, by whichever instance is initialized first.
+ */
+void paw3222_dev_init(paw3222_t *dev);
+
+/**
+ * @brief Advances the bring-up state machine and, once running, re-probes
+ * the sensor every PAW3222_PROBE_INTERVAL_MS. A sensor that stops answering
+ * with its PID, or whose CPI register no longer holds the programmed value
+ * (brown-out), is brought up again.
+ *
+ * @return true when the sensor is ready to be sampled
+ */
+bool paw3222_dev_service(paw3222_t *dev);
 
 /**
- * @brief Initializes the sensor so it is in a working state and ready to
- * be polled for data.
+ * @brief Reads every ready sensor in devs[] back to back, one CS window each
+ * and skipping those whose MOTION line is idle. out[i] is zeroed for sensors
+ * that were skipped or had no motion.
  *
- * @return true Initialization was a success
- * @return false Initialization failed, do not proceed operation
+ * @return bit i set when devs[i] reported motion
+ */
+uint8_t paw3222_dev_read_batch(paw3222_t *const *devs, uint8_t count, report_paw3222_t *out);
+
+void paw3222_dev_write_cpi(paw3222_t *dev, uint16_t cpi);
+uint16_t paw3222_dev_get_cpi(const paw3222_t *dev);
+const paw3222_status_t *paw3222_dev_get_status(const paw3222_t *dev);
+
+// ====== Primary sensor ===========================================
+
+/**
+ * @brief Sets up the pins and schedules the sensor bring-up. Returns at once;
+ * paw3222_service() resets the sensor and checks its PID on later ticks.
  */
 void paw3222_init(void);
 
+/**
+ * @brief paw3222_dev_service() for the primary sensor. Called by
+ * paw3222_sample(), so only the bus owner runs it.
+ */
+bool paw3222_service(void);
+
+const paw3222_status_t *paw3222_get_status(void);
+
 /**
  * @brief Reads and clears the current delta, and motion register values on the
  * given sensor.
@@ -79,11 +207,55 @@ report_paw3222_t paw3222_read(void);
 void paw3222_set_cpi(uint16_t cpi);
 
 /**
- * @brief Gets the currently set CPI value from the sensor. CPI is often
- * refereed to as the sensors sensitivity.
+ * @brief Gets the currently set CPI value of the sensor. CPI is often
+ * refereed to as the sensors sensitivity. The value is cached from init and
+ * paw3222_set_cpi(), so this does not touch the bus. With PAW3222_CORE1 it
+ * is the value core 1 last reported, which trails paw3222_set_cpi() until
+ * core 1 has programmed the request.
  *
  * @return uint16_t Current CPI value of the sensor
  */
 uint16_t paw3222_get_cpi(void);
 
 report_mouse_t paw3222_get_report(report_mouse_t mouse_report);
+
+/**
+ * @brief Polls the sensor once (skipped while MOTION is idle) and returns
+ * true with the deltas when it reported motion. Used by the pointing task,
+ * or by core 1 when PAW3222_CORE1 is enabled.
+ */
+bool paw3222_sample(int16_t *x, int16_t *y);
+
+/**
+ * @brief Advances the sampling schedule. Returns true when a sample slot is
+ * due; slots missed while the caller was busy are counted as late instead of
+ * being replayed.
+ */
+bool paw3222_sampler_due(void);
+
+/**
+ * @brief Runs the sampler from the main loop (housekeeping) so the sensor is
+ * read at PAW3222_SAMPLE_INTERVAL_US rather than once per pointing task tick.
+ * With PAW3222_CORE1 this only drains the core 1 queue.
+ */
+void paw3222_sampler_task(void);
+
+const paw3222_sampler_stats_t *paw3222_get_sampler_stats(void);
+
+/**
+ * @brief Programs REG_CPI_X/Y on the bus. paw3222_set_cpi() calls this
+ * directly, or hands the value to core 1 when it owns the bus. While the
+ * sensor is not ready the value is only remembered and is written at the
+ * next bring-up.
+ */
+void paw3222_write_cpi(uint16_t cpi);
+
+/**
+ * @brief Returns per-poll bus timing accumulated by paw3222_read().
+ */
+const paw3222_bus_stats_t *paw3222_get_bus_stats(void);
+
+/**
+ * @brief Clears the counters returned by paw3222_get_bus_stats().
+ */
+void paw3222_reset_bus_stats(void);
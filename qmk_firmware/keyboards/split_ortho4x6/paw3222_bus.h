@@ -0,0 +1,64 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Byte transport for the PAW3222 3-wire serial interface (SCLK + half-duplex
+// SDIO). Chip select is owned by paw3222.c; a backend only moves bytes while
+// CS is held low. Several sensors may share SCLK/SDIO with their own CS. The backend is chosen at build time with
+// PAW3222_BUS_DRIVER = pio | bitbang | mock in rules.mk.
+
+#include "gpio.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PAW3222_WRITE 0x80
+
+// Longest CS window a backend accepts, in command words: a read takes one
+// and a write two. Covers the longest transaction the driver issues
+// (register protect + CPI X/Y + protect) and sizes the PIO DMA buffers.
+#define PAW3222_BUS_MAX_WORDS 16
+
+typedef struct {
+  uint8_t addr; // register address, PAW3222_WRITE set for a write
+  uint8_t data; // value to write, or the value read back
+} paw3222_xfer_t;
+
+/**
+ * @brief Configures SCLK/SDIO for the backend. SCLK idles high and SDIO is
+ * left as an input with pull-up.
+ */
+void paw3222_bus_init(void);
+
+static inline uint8_t paw3222_bus_words(const paw3222_xfer_t *xfers, uint8_t count) {
+  uint8_t words = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    words += (xfers[i].addr & PAW3222_WRITE) ? 2 : 1;
+  }
+  return words;
+}
+
+/**
+ * @brief Runs a list of register accesses back to back inside one CS window.
+ * Writes send address and data; reads send the address, wait for the sensor
+ * turnaround and store the result in xfers[i].data. cs is the line
+ * paw3222.c holds low; the hardware backends ignore it and the mock uses it
+ * to pick the addressed sensor. A list longer than PAW3222_BUS_MAX_WORDS is
+ * rejected without touching the bus.
+ *
+ * @return false if the list was rejected
+ */
+bool paw3222_bus_transfer(pin_t cs, paw3222_xfer_t *xfers, uint8_t count);
@@ -0,0 +1,81 @@
+/* Copyright 2021 Gompa (@Gompa)
+ * Modifications Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// GPIO bit-bang backend. Kept as a fallback for boards where no PIO state
+// machine is free (PAW3222_BUS_DRIVER = bitbang).
+
+#include "gpio.h"
+#include "paw3222.h"
+#include "paw3222_bus.h"
+#include "wait.h"
+
+static uint8_t paw3222_serial_read(void) {
+  gpio_set_pin_input(PAW3222_SDIO_PIN);
+  uint8_t byte = 0;
+
+  for (uint8_t i = 0; i < 8; ++i) {
+    gpio_write_pin_low(PAW3222_SCLK_PIN);
+    wait_us(1);
+
+    byte = (byte << 1) | gpio_read_pin(PAW3222_SDIO_PIN);
+
+    gpio_write_pin_high(PAW3222_SCLK_PIN);
+    wait_us(1);
+  }
+
+  return byte;
+}
+
+static void paw3222_serial_write(uint8_t data) {
+  gpio_write_pin_low(PAW3222_SDIO_PIN);
+  gpio_set_pin_output(PAW3222_SDIO_PIN);
+
+  for (int8_t b = 7; b >= 0; b--) {
+    gpio_write_pin_low(PAW3222_SCLK_PIN);
+    if (data & (1 << b)) {
+      gpio_write_pin_high(PAW3222_SDIO_PIN);
+    } else {
+      gpio_write_pin_low(PAW3222_SDIO_PIN);
+    }
+    gpio_write_pin_high(PAW3222_SCLK_PIN);
+  }
+
+  wait_us(4);
+}
+
+void paw3222_bus_init(void) {
+  gpio_write_pin_high(PAW3222_SCLK_PIN);     // set clock pin high
+  gpio_set_pin_output(PAW3222_SCLK_PIN);     // setclockpin to output
+  gpio_set_pin_input_high(PAW3222_SDIO_PIN); // set datapin input high
+}
+
+bool paw3222_bus_transfer(pin_t cs, paw3222_xfer_t *xfers, uint8_t count) {
+  (void)cs;
+  if (paw3222_bus_words(xfers, count) > PAW3222_BUS_MAX_WORDS) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    paw3222_serial_write(xfers[i].addr);
+    if (xfers[i].addr & PAW3222_WRITE) {
+      paw3222_serial_write(xfers[i].data);
+    } else {
+      wait_us(5);
+      xfers[i].data = paw3222_serial_read();
+    }
+  }
+  return true;
+}
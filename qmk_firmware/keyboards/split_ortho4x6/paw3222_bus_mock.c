@@ -0,0 +1,145 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "paw3222_bus.h"
+#include "paw3222_bus_mock.h"
+
+#include <string.h>
+
+// Mirrors the register map in paw3222.c
+#define REG_PID1 0x00
+#define REG_PID2 0x01
+#define REG_STAT 0x02
+#define REG_X 0x03
+#define REG_Y 0x04
+#define REG_CONFIGURATION 0x06
+#define REG_PROTECT 0x09
+#define REG_CPI_X 0x0D
+#define REG_CPI_Y 0x0E
+
+#define VAL_PID1 0x30
+#define VAL_PROTECT_DISABLE 0x5A
+#define STAT_MOTION 0x80
+
+paw3222_mock_t paw3222_mocks[PAW3222_MOCK_SENSORS];
+
+static void mock_power_on(paw3222_mock_t *m) {
+  memset(m->regs, 0, sizeof(m->regs));
+  m->regs[REG_PID1] = VAL_PID1;
+  m->regs[REG_PID2] = 0x02;
+  m->regs[REG_CPI_X] = 0x15;
+  m->regs[REG_CPI_Y] = 0x15;
+}
+
+void paw3222_mock_reset(void) {
+  for (uint8_t i = 0; i < PAW3222_MOCK_SENSORS; i++) {
+    paw3222_mock_t *m = &paw3222_mocks[i];
+    pin_t cs = m->cs;
+    memset(m, 0, sizeof(*m));
+    m->cs = cs;
+    mock_power_on(m);
+  }
+}
+
+void paw3222_mock_attach(uint8_t i, pin_t cs) { paw3222_mocks[i].cs = cs; }
+
+static int8_t saturate(int16_t v) {
+  return v > INT8_MAX ? INT8_MAX : (v < INT8_MIN ? INT8_MIN : (int8_t)v);
+}
+
+void paw3222_mock_move_sensor(paw3222_mock_t *m, int16_t dx, int16_t dy) {
+  uint8_t *r = m->regs;
+  r[REG_X] = (uint8_t)saturate((int8_t)r[REG_X] + dx);
+  r[REG_Y] = (uint8_t)saturate((int8_t)r[REG_Y] + dy);
+  r[REG_STAT] |= STAT_MOTION;
+}
+
+static void mock_log(paw3222_mock_t *m, uint8_t byte) {
+  m->log[m->log_len % PAW3222_MOCK_LOG_SIZE] = byte;
+  m->log_len++;
+}
+
+static uint8_t mock_read(paw3222_mock_t *m, uint8_t addr) {
+  uint8_t *r = m->regs;
+  uint8_t v = r[addr];
+
+  // The delta registers clear on read; motion drops once both are consumed
+  if (addr == REG_X || addr == REG_Y) {
+    r[addr] = 0;
+    if (r[REG_X] == 0 && r[REG_Y] == 0) {
+      r[REG_STAT] &= ~STAT_MOTION;
+    }
+  }
+  return v;
+}
+
+static void mock_write(paw3222_mock_t *m, uint8_t addr, uint8_t data) {
+  uint8_t *r = m->regs;
+
+  if ((addr == REG_CPI_X || addr == REG_CPI_Y) &&
+      r[REG_PROTECT] != VAL_PROTECT_DISABLE) {
+    return;
+  }
+  if (addr == REG_CONFIGURATION && (data & 0x80)) {
+    mock_power_on(m);
+    return;
+  }
+  r[addr] = data;
+}
+
+static paw3222_mock_t *mock_select(pin_t cs) {
+  for (uint8_t i = 0; i < PAW3222_MOCK_SENSORS; i++) {
+    if (paw3222_mocks[i].cs == cs && !paw3222_mocks[i].unplugged) {
+      return &paw3222_mocks[i];
+    }
+  }
+  return NULL;
+}
+
+void paw3222_bus_init(void) {}
+
+bool paw3222_bus_transfer(pin_t cs, paw3222_xfer_t *xfers, uint8_t count) {
+  // Same limit as the hardware backends, so an oversized window fails here
+  // too instead of only on the board
+  if (paw3222_bus_words(xfers, count) > PAW3222_BUS_MAX_WORDS) {
+    return false;
+  }
+  paw3222_mock_t *m = mock_select(cs);
+  if (!m) {
+    for (uint8_t i = 0; i < count; i++) {
+      if (!(xfers[i].addr & PAW3222_WRITE)) {
+        xfers[i].data = 0xFF;
+      }
+    }
+    return true;
+  }
+
+  m->windows++;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t addr = xfers[i].addr & (PAW3222_MOCK_REGS - 1);
+    mock_log(m, xfers[i].addr);
+    if (xfers[i].addr & PAW3222_WRITE) {
+      mock_log(m, xfers[i].data);
+      mock_write(m, addr, xfers[i].data);
+      m->writes++;
+    } else {
+      xfers[i].data = mock_read(m, addr);
+      mock_log(m, xfers[i].data);
+      m->reads++;
+    }
+  }
+  return true;
+}
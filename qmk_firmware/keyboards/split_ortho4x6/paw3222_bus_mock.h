@@ -0,0 +1,69 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Register-level PAW3222 model behind paw3222_bus.h. Apart from pin_t it has
+// no QMK or hardware dependency, so the driver's framing and the scheduling
+// of several sensors on one bus can be exercised on a host.
+
+#include "paw3222_bus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PAW3222_MOCK_REGS 0x80
+#define PAW3222_MOCK_LOG_SIZE 64
+#define PAW3222_MOCK_SENSORS 4
+
+typedef struct {
+  pin_t cs; // the CS line this sensor answers to
+  uint8_t regs[PAW3222_MOCK_REGS];
+  uint32_t windows; // paw3222_bus_transfer() calls, i.e. CS low periods
+  uint32_t reads;
+  uint32_t writes;
+  // Cable pulled: its CS window reads the pulled-up bus and writes are lost
+  bool unplugged;
+  // Raw bytes seen on SDIO in order; wraps after PAW3222_MOCK_LOG_SIZE
+  uint8_t log[PAW3222_MOCK_LOG_SIZE];
+  uint16_t log_len;
+} paw3222_mock_t;
+
+// A window whose CS matches no sensor reads the pulled-up bus (0xFF).
+extern paw3222_mock_t paw3222_mocks[PAW3222_MOCK_SENSORS];
+
+// Sensor 0; single-sensor tests only need this one
+#define paw3222_mock (paw3222_mocks[0])
+
+/**
+ * @brief Puts every sensor back into its power-on state and clears
+ * counters. The CS bindings are kept.
+ */
+void paw3222_mock_reset(void);
+
+/**
+ * @brief Makes sensor i answer to the given CS line.
+ */
+void paw3222_mock_attach(uint8_t i, pin_t cs);
+
+/**
+ * @brief Adds motion to the delta registers and raises the motion bit, as
+ * if the ball had moved by (dx, dy) counts since the last read.
+ */
+void paw3222_mock_move_sensor(paw3222_mock_t *m, int16_t dx, int16_t dy);
+
+static inline void paw3222_mock_move(int16_t dx, int16_t dy) {
+  paw3222_mock_move_sensor(&paw3222_mock, dx, dy);
+}
@@ -0,0 +1,217 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// RP2040 PIO backend. One state machine clocks the half-duplex SDIO protocol
+// so the CPU only queues command words; transactions longer than the PIO FIFO
+// are moved by a pair of DMA channels.
+
+#include "quantum.h"
+#include "paw3222.h"
+#include "paw3222_bus.h"
+
+#include "hardware/clocks.h"
+#include "hardware/pio.h"
+
+#if defined(PAW3222_PIO_USE_PIO0)
+static const PIO pio = pio0;
+#else
+// pio0 is normally taken by the split serial and WS2812 vendor drivers
+static const PIO pio = pio1;
+#endif
+
+// 4 cycles per SCLK period -> 1 MHz SCLK
+#ifndef PAW3222_PIO_CLOCK_HZ
+#define PAW3222_PIO_CLOCK_HZ 4000000
+#endif
+
+// .program paw3222_sdio
+// .side_set 1 opt                     ; SCLK
+// ; TX word: [31:24] byte to send, [23] 1 = read one byte after the turnaround.
+// ; Every command word yields exactly one RX word (the read byte, or 0).
+// .wrap_target
+// top:
+//     pull block          side 1
+//     set pindirs, 1
+//     set x, 7
+// wbit:
+//     out pins, 1         side 0 [1]  ; sensor latches SDIO on the rising edge
+//     jmp x-- wbit        side 1 [1]
+//     out y, 1
+//     set x, 15                       ; ~4 us inter-command gap
+// wgap:
+//     jmp x-- wgap
+//     jmp !y wdone
+//     set pindirs, 0
+//     set x, 19                       ; ~5 us read turnaround
+// rgap:
+//     jmp x-- rgap
+//     set x, 7
+// rbit:
+//     nop                 side 0 [1]
+//     in pins, 1          side 1      ; autopush after 8 bits
+//     jmp x-- rbit
+//     jmp top
+// wdone:
+//     in null, 8
+// .wrap
+static const uint16_t paw3222_sdio_program_instructions[] = {
+    //     .wrap_target
+    0x98a0, //  0: pull   block           side 1
+    0xe081, //  1: set    pindirs, 1
+    0xe027, //  2: set    x, 7
+    0x7101, //  3: out    pins, 1         side 0 [1]
+    0x1943, //  4: jmp    x--, 3          side 1 [1]
+    0x6041, //  5: out    y, 1
+    0xe02f, //  6: set    x, 15
+    0x0047, //  7: jmp    x--, 7
+    0x0071, //  8: jmp    !y, 17
+    0xe080, //  9: set    pindirs, 0
+    0xe033, // 10: set    x, 19
+    0x004b, // 11: jmp    x--, 11
+    0xe027, // 12: set    x, 7
+    0xb142, // 13: nop                    side 0 [1]
+    0x5801, // 14: in     pins, 1         side 1
+    0x004d, // 15: jmp    x--, 13
+    0x0000, // 16: jmp    0
+    0x4068, // 17: in     null, 8
+            //     .wrap
+};
+
+static const pio_program_t paw3222_sdio_program = {
+    .instructions = paw3222_sdio_program_instructions,
+    .length = 18,
+    .origin = -1,
+};
+
+#define PAW3222_SDIO_WRAP_TARGET 0
+#define PAW3222_SDIO_WRAP 17
+
+#define CMD_READ (1u << 23)
+#define PIO_FIFO_DEPTH 4
+
+static int sm;
+static const rp_dma_channel_t *dma_tx;
+static const rp_dma_channel_t *dma_rx;
+
+static inline bool dma_busy(const rp_dma_channel_t *ch) {
+  return (ch->channel->CTRL_TRIG & DMA_CTRL_TRIG_BUSY) != 0;
+}
+
+void paw3222_bus_init(void) {
+  uint pio_idx = pio_get_index(pio);
+  hal_lld_peripheral_unreset(pio_idx == 0 ? RESETS_ALLREG_PIO0
+                                          : RESETS_ALLREG_PIO1);
+
+  iomode_t mode =
+      (pio_idx == 0 ? PAL_MODE_ALTERNATE_PIO0 : PAL_MODE_ALTERNATE_PIO1);
+  palSetLineMode(PAW3222_SCLK_PIN, mode | PAL_RP_PAD_DRIVE4);
+  palSetLineMode(PAW3222_SDIO_PIN, mode | PAL_RP_PAD_PUE);
+
+  sm = pio_claim_unused_sm(pio, true);
+  uint offset = pio_add_program(pio, &paw3222_sdio_program);
+
+  pio_sm_set_pins_with_mask(pio, sm, 1u << PAW3222_SCLK_PIN,
+                            1u << PAW3222_SCLK_PIN);
+  pio_sm_set_consecutive_pindirs(pio, sm, PAW3222_SCLK_PIN, 1, true);
+  pio_sm_set_consecutive_pindirs(pio, sm, PAW3222_SDIO_PIN, 1, false);
+
+  pio_sm_config c = pio_get_default_sm_config();
+  sm_config_set_wrap(&c, offset + PAW3222_SDIO_WRAP_TARGET,
+                     offset + PAW3222_SDIO_WRAP);
+  sm_config_set_sideset(&c, 2, true, false);
+  sm_config_set_sideset_pins(&c, PAW3222_SCLK_PIN);
+  sm_config_set_out_pins(&c, PAW3222_SDIO_PIN, 1);
+  sm_config_set_set_pins(&c, PAW3222_SDIO_PIN, 1);
+  sm_config_set_in_pins(&c, PAW3222_SDIO_PIN);
+  sm_config_set_out_shift(&c, false, false, 32);
+  sm_config_set_in_shift(&c, false, true, 8);
+  sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / PAW3222_PIO_CLOCK_HZ);
+  pio_sm_init(pio, sm, offset, &c);
+  pio_sm_set_enabled(pio, sm, true);
+
+  osalSysLock();
+  dma_tx = dmaChannelAllocI(RP_DMA_CHANNEL_ID_ANY, RP_IRQ_DMA0_PRIORITY, NULL,
+                            NULL);
+  dma_rx = dmaChannelAllocI(RP_DMA_CHANNEL_ID_ANY, RP_IRQ_DMA0_PRIORITY, NULL,
+                            NULL);
+  osalSysUnlock();
+
+  // clang-format off
+  dmaChannelSetModeX(dma_tx, DMA_CTRL_TRIG_INCR_READ |
+                             DMA_CTRL_TRIG_DATA_SIZE_WORD |
+                             DMA_CTRL_TRIG_IRQ_QUIET |
+                             DMA_CTRL_TRIG_TREQ_SEL(pio_get_dreq(pio, sm, true)));
+  dmaChannelSetModeX(dma_rx, DMA_CTRL_TRIG_INCR_WRITE |
+                             DMA_CTRL_TRIG_DATA_SIZE_WORD |
+                             DMA_CTRL_TRIG_IRQ_QUIET |
+                             DMA_CTRL_TRIG_TREQ_SEL(pio_get_dreq(pio, sm, false)));
+  // clang-format on
+  dmaChannelSetDestinationX(dma_tx, (uint32_t)&pio->txf[sm]);
+  dmaChannelSetSourceX(dma_rx, (uint32_t)&pio->rxf[sm]);
+}
+
+static void paw3222_pio_run(const uint32_t *tx, uint32_t *rx, uint8_t words) {
+  if (words <= PIO_FIFO_DEPTH) {
+    for (uint8_t i = 0; i < words; i++) {
+      pio_sm_put(pio, sm, tx[i]);
+    }
+    for (uint8_t i = 0; i < words; i++) {
+      rx[i] = pio_sm_get_blocking(pio, sm);
+    }
+    return;
+  }
+
+  dmaChannelSetDestinationX(dma_rx, (uint32_t)rx);
+  dmaChannelSetCounterX(dma_rx, words);
+  dmaChannelSetSourceX(dma_tx, (uint32_t)tx);
+  dmaChannelSetCounterX(dma_tx, words);
+  dmaChannelEnableX(dma_rx);
+  dmaChannelEnableX(dma_tx);
+  while (dma_busy(dma_rx)) {
+  }
+}
+
+bool paw3222_bus_transfer(pin_t cs, paw3222_xfer_t *xfers, uint8_t count) {
+  (void)cs;
+  uint32_t tx[PAW3222_BUS_MAX_WORDS];
+  uint32_t rx[PAW3222_BUS_MAX_WORDS];
+  uint8_t words = 0;
+
+  if (paw3222_bus_words(xfers, count) > PAW3222_BUS_MAX_WORDS) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (xfers[i].addr & PAW3222_WRITE) {
+      tx[words++] = (uint32_t)xfers[i].addr << 24;
+      tx[words++] = (uint32_t)xfers[i].data << 24;
+    } else {
+      tx[words++] = ((uint32_t)xfers[i].addr << 24) | CMD_READ;
+    }
+  }
+
+  paw3222_pio_run(tx, rx, words);
+
+  words = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (xfers[i].addr & PAW3222_WRITE) {
+      words += 2;
+    } else {
+      xfers[i].data = (uint8_t)rx[words++];
+    }
+  }
+  return true;
+}
@@ -0,0 +1,204 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "paw3222_core1.h"
+#include "paw3222.h"
+
+#include "hardware/structs/scb.h"
+#include "hardware/structs/sio.h"
+#include "hardware/sync.h"
+#include "pico/platform.h"
+#include "timer_us.h"
+#ifdef TB_TRACE_ENABLE
+#include "tb_trace.h" // keymaps/vial
+#endif
+
+#include <stddef.h>
+
+// One FIFO word carries an (x, y) pair of int16 deltas. The FIFO is eight
+// words deep; while it is full core 1 keeps integrating locally, so nothing
+// is lost however late core 0 drains it.
+#define PACK(x, y) ((uint32_t)(uint16_t)(x) | ((uint32_t)(uint16_t)(y) << 16))
+// A word whose x half is INT16_MIN is not motion (take_i16() stops at
+// -INT16_MAX) but reports the CPI core 1 has just applied, in the y half.
+#define CPI_MARK INT16_MIN
+
+static uint32_t core1_stack[256] __attribute__((aligned(8)));
+static bool running;
+// CPI request from core 0: the value in the low half and a sequence number in
+// the high half. One word, so core 1 gets both from a single load. Core 0 only
+// ever bumps the sequence and core 1 never writes it back, so a request posted
+// while core 1 is programming the previous one is seen on the next pass
+// instead of being cleared along with it.
+static volatile uint32_t cpi_request;
+static volatile bool park_request;    // core 0 is about to write flash
+static volatile bool parked;
+static uint16_t cpi_posted; // core 0: last value handed to core 1
+static uint16_t cpi_seen;   // core 0: last value core 1 reported
+
+static inline bool fifo_readable(void) {
+  return sio_hw->fifo_st & SIO_FIFO_ST_VLD_BITS;
+}
+
+static inline bool fifo_writable(void) {
+  return sio_hw->fifo_st & SIO_FIFO_ST_RDY_BITS;
+}
+
+static inline int16_t take_i16(int32_t *acc) {
+  int32_t v = *acc;
+  if (v > INT16_MAX) v = INT16_MAX;
+  if (v < -INT16_MAX) v = -INT16_MAX;
+  *acc -= v;
+  return (int16_t)v;
+}
+
+// ====== Core 1 ===================================================
+// Runs from RAM: XIP is unavailable while core 0 erases or programs flash.
+static void __not_in_flash_func(core1_park)(void) {
+  parked = true;
+  while (park_request) {
+    __dmb();
+  }
+  parked = false;
+}
+
+static void core1_main(void) {
+  int32_t acc_x = 0, acc_y = 0;
+  uint16_t cpi_seq = 0; // sequence of the last request programmed
+  uint16_t cpi_sent = paw3222_dev_get_cpi(&paw3222_primary);
+
+  for (;;) {
+    if (park_request) {
+      core1_park();
+    }
+
+    // deltas counted at the old CPI go out first, so everything after the
+    // report word is at the new one
+    uint32_t req = cpi_request;
+    if ((uint16_t)(req >> 16) != cpi_seq && !acc_x && !acc_y) {
+      cpi_seq = (uint16_t)(req >> 16);
+      paw3222_write_cpi((uint16_t)req);
+    }
+
+    int16_t x, y;
+    if (paw3222_sampler_due() && paw3222_sample(&x, &y)) {
+      acc_x += x;
+      acc_y += y;
+    }
+    // also catches the CPI restored after a reconnect
+    uint16_t cpi = paw3222_dev_get_cpi(&paw3222_primary);
+    if (cpi != cpi_sent && fifo_writable()) {
+      sio_hw->fifo_wr = PACK(CPI_MARK, cpi);
+      cpi_sent = cpi;
+    }
+    while (cpi == cpi_sent && (acc_x || acc_y) && fifo_writable()) {
+      int16_t px = take_i16(&acc_x);
+      int16_t py = take_i16(&acc_y);
+      sio_hw->fifo_wr = PACK(px, py);
+    }
+  }
+}
+
+// ====== Core 0 ===================================================
+// Boot ROM handshake from the RP2040 datasheet (2.8.2): every word is echoed
+// back by core 1, and any mismatch restarts the sequence.
+void paw3222_core1_start(void) {
+  const uint32_t cmd[] = {
+      0, 0, 1, scb_hw->vtor,
+      (uintptr_t)&core1_stack[sizeof(core1_stack) / sizeof(core1_stack[0])],
+      (uintptr_t)core1_main,
+  };
+
+  // core 1 takes over cpi_cache from here and only reports changes
+  cpi_seen = paw3222_dev_get_cpi(&paw3222_primary);
+
+  size_t seq = 0;
+  while (seq < sizeof(cmd) / sizeof(cmd[0])) {
+    if (cmd[seq] == 0) {
+      while (fifo_readable()) {
+        (void)sio_hw->fifo_rd;
+      }
+      __sev();
+    }
+    while (!fifo_writable()) {
+    }
+    sio_hw->fifo_wr = cmd[seq];
+    __sev();
+    while (!fifo_readable()) {
+      __wfe();
+    }
+    seq = sio_hw->fifo_rd == cmd[seq] ? seq + 1 : 0;
+  }
+  running = true;
+}
+
+bool paw3222_core1_running(void) { return running; }
+
+uint16_t paw3222_core1_cpi(void) { return cpi_seen; }
+
+void paw3222_core1_take(int32_t *x, int32_t *y) {
+  while (fifo_readable()) {
+    uint32_t w = sio_hw->fifo_rd;
+    if ((int16_t)(w & 0xFFFF) == CPI_MARK) {
+      cpi_seen = (uint16_t)(w >> 16);
+      continue;
+    }
+    *x += (int16_t)(w & 0xFFFF);
+    *y += (int16_t)(w >> 16);
+#ifdef TB_TRACE_ENABLE
+    // usually one word per core 1 read with motion (reads merge while the
+    // FIFO is full); stamped when core 0 takes it
+    tb_trace_sample(is_keyboard_left(), (int16_t)(w & 0xFFFF), (int16_t)(w >> 16), true);
+#endif
+  }
+}
+
+void paw3222_core1_post_cpi(uint16_t cpi) {
+  // callers may repeat a request until paw3222_get_cpi() catches up
+  if (cpi == cpi_posted) {
+    return;
+  }
+  cpi_posted = cpi;
+  uint16_t seq = (uint16_t)(cpi_request >> 16) + 1;
+  cpi_request = ((uint32_t)seq << 16) | cpi;
+}
+
+// ====== Flash writes =============================================
+// The wear-leveling driver brackets every erase/program with
+// backing_store_unlock()/lock(); core 1 waits in RAM in between.
+bool __real_backing_store_unlock(void);
+bool __real_backing_store_lock(void);
+
+bool __wrap_backing_store_unlock(void) {
+  if (running) {
+    park_request = true;
+    while (!parked) {
+      __dmb();
+    }
+  }
+  return __real_backing_store_unlock();
+}
+
+bool __wrap_backing_store_lock(void) {
+  bool ok = __real_backing_store_lock();
+  if (running) {
+    park_request = false;
+    while (parked) {
+      __dmb();
+    }
+  }
+  return ok;
+}
@@ -0,0 +1,60 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Optional core 1 sampler (PAW3222_CORE1 = yes in rules.mk).
+//
+// Core 1 polls the sensor every PAW3222_SAMPLE_INTERVAL_US and pushes the accumulated
+// deltas to core 0 through the SIO FIFO, so the pointing task on core 0 only
+// drains a hardware queue and never waits on the sensor bus. Only the bus
+// reads move: the transform (tb_xform_apply()) and everything else that
+// touches QMK state still run on core 0, so the loop time saved is the
+// sensor stage of scripts/scan_prof.py and nothing more.
+// Core 1 owns the sensor state, including the programmed CPI (cpi_cache);
+// core 0 posts requests and learns the result from a report word in the FIFO.
+// Core 1 runs bare metal (no ChibiOS services) and is parked in RAM while
+// core 0 writes flash.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Launches core 1. From here on only core 1 touches the bus,
+ * including the sensor bring-up and reconnects (paw3222_service()).
+ */
+void paw3222_core1_start(void);
+
+bool paw3222_core1_running(void);
+
+/**
+ * @brief Adds everything core 1 has queued since the last call to *x / *y.
+ * Never blocks.
+ */
+void paw3222_core1_take(int32_t *x, int32_t *y);
+
+/**
+ * @brief Asks core 1 to program a new CPI before its next sample. Core 0
+ * only; the latest request always wins, and repeating the pending value is
+ * a no-op.
+ */
+void paw3222_core1_post_cpi(uint16_t cpi);
+
+/**
+ * @brief The CPI core 1 last reported through the FIFO (core 0 only). Deltas
+ * taken before the report word were counted at the previous value.
+ */
+uint16_t paw3222_core1_cpi(void);
@@ -0,0 +1,30 @@
+/* Copyright 2025 sekigon-gonnoc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Free-running microsecond counter. On the RP2040 this is the 1 MHz system
+// timer; other targets fall back to the millisecond timer.
+
+#include <stdint.h>
+
+#if defined(MCU_RP)
+#include "hardware/timer.h"
+static inline uint32_t timer_read_us(void) { return time_us_32(); }
+#else
+#include "timer.h"
+static inline uint32_t timer_read_us(void) { return timer_read32() * 1000; }
+#endif
@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# コンボ索引の比較テストをホスト向けにビルドする。
+# keymaps/vial の keymap.c / combo_index.c をそのままリンクし、rules.mk と同じ -wrap で包む。
+# コンボの数（VIAL_COMBO_ENTRIES）は COMBO_TEST_ENTRIES、既定 32（keymap.c の既定 8 個はそのまま）。
+# 数を変えた時の照合回数は COMBO_TEST_ENTRIES=128 ./build.sh && ./combo_test のように比べる。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+QMK_HOST="$REPO_ROOT/scripts/qmk_host" # keymap.c 用の共通の代替ヘッダ
+CC=${CC:-cc}
+ENTRIES=${COMBO_TEST_ENTRIES:-32}
+
+"$CC" -O2 -Wall -std=gnu11 \
+  -DQMK_KEYBOARD_H='"split_ortho4x6.h"' \
+  -DVIAL_TAP_DANCE_ENTRIES=8 -DVIAL_COMBO_ENTRIES=$ENTRIES -DVIAL_KEY_OVERRIDE_ENTRIES=4 \
+  -I"$QMK_HOST" -I"$KEYMAP_DIR" -I"$KEYBOARD_DIR" \
+  "$HERE/combo_test.c" "$HERE/host/dynamic_keymap.c" "$QMK_HOST/process_combo.c" "$QMK_HOST/keymap_stubs.c" \
+  "$KEYMAP_DIR/keymap.c" "$KEYMAP_DIR/combo_index.c" \
+  -Wl,-wrap=process_combo -Wl,-wrap=dynamic_keymap_set_combo -Wl,-wrap=dynamic_keymap_reset \
+  -o "$HERE/combo_test"
+
+echo "[i] ビルド完了: $HERE/combo_test（コンボ $ENTRIES 個）"
@@ -0,0 +1,217 @@
+// scripts/combo_test/combo_test.c
+// 同じ打鍵列を、combo_index.c の索引を通した process_combo() と通さないもの
+// （__real_process_combo）に流し、出てくるキーイベント列が一致することを確かめる。
+//
+//   ./combo_test              # 各構成 20000 打鍵
+//   ./combo_test 100000 7     # 打鍵数 乱数種
+//
+// 構成は keymap.c の default_combo_entries（8 個）と、隣接キーの同時押しで VIAL_COMBO_ENTRIES
+// （build.sh の COMBO_TEST_ENTRIES、既定 32）まで埋めたもの。
+// 打鍵は keymap.c のキー配置で、レイヤ 0〜7 のどれかを押している前提のキーコード
+// （BTN1+BTN2 はレイヤ 4、LGUI(Z)+LGUI(X) はレイヤ 1）。食い違えば終了コード 1。
+//
+// 照合はコンボ 1 個との比較（process_single_combo()）の回数。索引が省けるのはどのコンボにも
+// 含まれないキーのイベントだけで、本体に渡したイベントは QMK と同じく全エントリを照合する
+// （コンボの数に比例する）。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "quantum.h"
+#include "combo_index.h"
+
+extern const uint16_t   keymaps[][MATRIX_ROWS][MATRIX_COLS];
+extern uint32_t         combo_host_checks;
+void                    combo_host_reset(void);
+void                    combo_task(void);
+bool                    __real_process_combo(uint16_t keycode, keyrecord_t* record);
+
+static uint16_t combo_test_now; // ms
+
+uint16_t timer_read(void) { return combo_test_now; }
+
+// ====== Output log ===============================================
+#define LOG_MAX 400000
+
+typedef struct {
+    uint16_t keycode;
+    bool     pressed;
+} out_t;
+
+static out_t*   g_log;
+static uint32_t g_log_n;
+
+// qmk_host/process_combo.c の出力
+void combo_host_emit(uint16_t keycode, keypos_t key, bool pressed) {
+    if (g_log_n < LOG_MAX) g_log[g_log_n++] = (out_t){keycode, pressed};
+}
+
+// ====== Stroke sequence ==========================================
+typedef struct {
+    uint16_t dt_ms;
+    keypos_t key;
+    uint16_t keycode;
+    bool     pressed;
+} event_t;
+
+static keypos_t g_pos[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t  g_num_pos;
+
+static uint16_t keycode_at(uint8_t layer, keypos_t k) {
+    uint16_t kc = keymaps[layer][k.row][k.col];
+    return kc == KC_TRANSPARENT ? keymaps[0][k.row][k.col] : kc;
+}
+
+static bool in_combo(const vial_combo_entry_t* combos, uint8_t n, uint16_t kc) {
+    for (uint8_t i = 0; i < n; i++) {
+        for (uint8_t k = 0; k < 4; k++) {
+            if (combos[i].input[k] == kc) return true;
+        }
+    }
+    return false;
+}
+
+// 押したキーを 1〜2 個ずつ離していく普通の打鍵に、3 割ほどコンボのキーの同時押しを
+// 混ぜる。間隔は COMBO_TERM をまたぐようにばらつかせる
+static uint32_t make_events(event_t* ev, uint32_t n, const vial_combo_entry_t* combos, uint8_t num_combos) {
+    bool     down[MATRIX_ROWS * MATRIX_COLS] = {0};
+    uint16_t held_kc[MATRIX_ROWS * MATRIX_COLS];
+    uint8_t  num_down = 0;
+    uint8_t  layer    = 0;
+    uint32_t m        = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (num_down == 0 && rand() % 16 == 0) layer = rand() % 8; // 押したキーは押した時のキーコードで離す
+        uint16_t dt = rand() % 8 == 0 ? rand() % 80 : rand() % 20;
+        uint8_t  p;
+        if (num_down > 0 && (num_down >= 3 || rand() % 2)) {
+            do {
+                p = rand() % g_num_pos;
+            } while (!down[p]);
+            ev[m++] = (event_t){dt, g_pos[p], held_kc[p], false};
+            down[p] = false;
+            num_down--;
+            continue;
+        }
+        if (rand() % 64 == 0) {
+            // コンボの有効/無効切り替えも混ぜる
+            ev[m++] = (event_t){dt, {.row = 255, .col = 255}, rand() % 2 ? QK_COMBO_TOGGLE : QK_COMBO_ON, true};
+            continue;
+        }
+        bool want_combo = rand() % 10 < 3;
+        do {
+            p = rand() % g_num_pos;
+        } while (down[p] || (want_combo && !in_combo(combos, num_combos, keycode_at(layer, g_pos[p])) && rand() % 16));
+        held_kc[p] = keycode_at(layer, g_pos[p]);
+        ev[m++]    = (event_t){dt, g_pos[p], held_kc[p], true};
+        down[p]    = true;
+        num_down++;
+    }
+    for (uint8_t p = 0; p < g_num_pos; p++) {
+        if (down[p]) ev[m++] = (event_t){5, g_pos[p], held_kc[p], false};
+    }
+    return m;
+}
+
+static void run(const event_t* ev, uint32_t n, bool (*process)(uint16_t, keyrecord_t*)) {
+    combo_host_reset();
+    g_log_n           = 0;
+    combo_test_now    = 1;
+    combo_host_checks = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint16_t t = 0; t < ev[i].dt_ms; t++) {
+            combo_test_now++;
+            combo_task();
+        }
+        keyrecord_t rec = {.event = {.key = ev[i].key, .pressed = ev[i].pressed, .time = combo_test_now}};
+        if (process(ev[i].keycode, &rec)) combo_host_emit(ev[i].keycode, ev[i].key, ev[i].pressed);
+    }
+    combo_test_now += 1000;
+    combo_task();
+}
+
+// ====== Main =====================================================
+static bool compare(const char* name, const vial_combo_entry_t* combos, uint8_t num_combos, uint32_t strokes) {
+    event_t* ev = malloc((strokes + g_num_pos) * sizeof(*ev));
+    uint32_t n  = make_events(ev, strokes, combos, num_combos);
+
+    run(ev, n, __real_process_combo);
+    out_t*   ref   = malloc(g_log_n * sizeof(*ref));
+    uint32_t ref_n = g_log_n;
+    memcpy(ref, g_log, ref_n * sizeof(*ref));
+    double plain = (double)combo_host_checks / n;
+
+    const combo_index_stats_t* st = combo_index_get_stats();
+    uint32_t events0 = st->events, skipped0 = st->skipped;
+    run(ev, n, process_combo);
+    double indexed = (double)combo_host_checks / n;
+    uint32_t passed = (st->events - events0) - (st->skipped - skipped0);
+
+    uint32_t fired = 0;
+    for (uint32_t i = 0; i < ref_n; i++) {
+        for (uint8_t c = 0; c < num_combos && ref[i].pressed; c++) {
+            if (ref[i].keycode == combos[c].output && combos[c].output != KC_NO) {
+                fired++;
+                break;
+            }
+        }
+    }
+
+    uint32_t diff = ref_n == g_log_n ? ref_n : 0;
+    for (uint32_t i = 0; i < ref_n && i < g_log_n; i++) {
+        if (ref[i].keycode != g_log[i].keycode || ref[i].pressed != g_log[i].pressed) {
+            diff = i;
+            break;
+        }
+    }
+    bool ok = ref_n == g_log_n && diff == ref_n;
+    printf("%-10s  %6u イベント  出力 %6u  コンボ発火 %5u  照合 %6.2f → %6.2f 回/イベント（本体に渡した分 %6.2f）  走査省略 %4.1f%%  %s\n",
+           name, n, ref_n, fired, plain, indexed, passed ? (double)combo_host_checks / passed : 0.0,
+           100.0 * (st->skipped - skipped0) / (st->events - events0), ok ? "一致" : "不一致");
+    if (!ok) printf("[!] %u 番目の出力から食い違い（索引なし %u 件 / あり %u 件）\n", diff, ref_n, g_log_n);
+    free(ev);
+    free(ref);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t strokes = argc > 1 ? strtoul(argv[1], NULL, 0) : 20000;
+    srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+    g_log = malloc(LOG_MAX * sizeof(*g_log));
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            if (keymaps[0][r][c] != KC_NO) g_pos[g_num_pos++] = (keypos_t){.col = c, .row = r};
+        }
+    }
+
+    // keymap.c の既定のコンボ（__wrap_dynamic_keymap_reset() → dynamic_keymap_set_combo()）
+    dynamic_keymap_reset();
+    vial_combo_entry_t combos[VIAL_COMBO_ENTRIES] = {0};
+    uint8_t            num = 0;
+    extern const vial_combo_entry_t default_combo_entries[];
+    for (; num < 8; num++) combos[num] = default_combo_entries[num];
+    bool ok = compare("既定 8 個", combos, num, strokes);
+
+    // 残りはレイヤ 0 か 1 の横に隣り合う 2〜3 キーの同時押しで埋める（Vial から 1 個ずつ
+    // 書き込むのと同じ経路）。出力は発火を数えられるよう QK_USER の範囲で重ならないものにする
+    for (; num < VIAL_COMBO_ENTRIES; num++) {
+        vial_combo_entry_t e = {.output = 0x7F00 + num};
+        uint8_t            layer, len = 2 + rand() % 2;
+        keypos_t           k;
+        do {
+            layer = rand() % 2;
+            k     = g_pos[rand() % g_num_pos];
+        } while (k.col + len > MATRIX_COLS || keymaps[0][k.row][k.col + len - 1] == KC_NO);
+        for (uint8_t j = 0; j < len; j++) e.input[j] = keycode_at(layer, (keypos_t){.row = k.row, .col = k.col + j});
+        combos[num] = e;
+        dynamic_keymap_set_combo(num, &e);
+    }
+    char name[16];
+    snprintf(name, sizeof(name), "%u 個", num);
+    ok &= compare(name, combos, num, strokes);
+
+    if (!ok) return 1;
+    printf("[i] 索引あり/なしで出力一致\n");
+    return 0;
+}
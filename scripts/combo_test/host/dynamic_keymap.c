@@ -0,0 +1,14 @@
+// scripts/combo_test/host/dynamic_keymap.c
+// dynamic_keymap.c のうち keymap.c の __wrap_dynamic_keymap_reset() が呼ぶものの代替。
+// combo_test.c とは別のオブジェクトにしないと -wrap が効かない
+
+#include "quantum.h"
+
+void dynamic_keymap_reset(void) {
+    for (uint8_t i = 0; i < VIAL_COMBO_ENTRIES; i++) dynamic_keymap_set_combo(i, &(vial_combo_entry_t){0});
+}
+
+int      dynamic_keymap_set_tap_dance(uint8_t index, const vial_tap_dance_entry_t* entry) { return 0; }
+int      dynamic_keymap_set_key_override(uint8_t index, const vial_key_override_entry_t* entry) { return 0; }
+uint16_t dynamic_keymap_macro_get_buffer_size(void) { return 0; }
+void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {}
@@ -0,0 +1,20 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# チャタリング試験ツールをホスト向けにビルドする。
+# キーボードの debounce_eager.c をそのままリンクする。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+CC=${CC:-cc}
+
+# しきい値は keymaps/vial/config.h の値を使う（QMK では config.h が全ファイルに適用される）
+"$CC" -O2 -Wall -std=gnu11 \
+  -include "$KEYMAP_DIR/config.h" \
+  -I"$HERE/host" \
+  "$HERE/debounce_sim.c" "$KEYBOARD_DIR/debounce_eager.c" \
+  -o "$HERE/debounce_sim"
+
+echo "[i] ビルド完了: $HERE/debounce_sim"
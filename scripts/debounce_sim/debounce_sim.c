@@ -0,0 +1,200 @@
+// scripts/debounce_sim/debounce_sim.c
+// チャタリングするスイッチ波形を生成し、マトリクススキャン → debounce_eager.c の
+// 経路に流して、押下から報告までの遅延と余分な押下が無いことを確認する。
+//
+//   ./debounce_sim                     # 1000 打鍵、スキャン 200us、チャタリング最大 3000us
+//   ./debounce_sim 5000 100 4000 7     # 打鍵数 スキャン周期[us] チャタリング最大[us] 乱数種
+//
+// 比較のため、QMK 既定の sym_defer_g（全体で DEBOUNCE ms 安定するまで待つ）も同じ
+// 波形で動かす。余分な押下・離し（二重打鍵、押下中の離し）があれば終了コード 1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "debounce.h"
+#include "timer.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// ====== Clock ====================================================
+static uint32_t g_now_us;
+
+fast_timer_t timer_read_fast(void) { return (fast_timer_t)(g_now_us / 1000); }
+
+// ====== Waveform =================================================
+// 1 打鍵ぶんの接点の状態変化（時刻は打鍵の先頭から）
+#define MAX_EDGES 32 // add_bounce() 2 回ぶん
+
+typedef struct {
+    uint8_t  row, col;
+    uint32_t edge_us[MAX_EDGES]; // 偶数番目で閉じ、奇数番目で開く
+    uint8_t  edges;
+    uint32_t release_us; // 離し始め（最初に開いた時刻）
+    uint32_t end_us;
+} stroke_t;
+
+static uint32_t rnd(uint32_t lo, uint32_t hi) { return lo + (uint32_t)rand() % (hi - lo + 1); }
+
+// 閉→開…と交互に、bounce_us 以内で跳ねる（1 回あたり最大 1 + 2 * 7 変化）
+static void add_bounce(stroke_t* s, uint32_t t, uint32_t bounce_us) {
+    uint32_t end   = t + rnd(0, bounce_us);
+    uint8_t  extra = 0;
+    s->edge_us[s->edges++] = t;
+    while (extra < 7) {
+        uint32_t next = t + rnd(50, 400);
+        if (next + 50 >= end) break;
+        s->edge_us[s->edges++] = next;      // 跳ね返り
+        t                      = next + rnd(50, 400);
+        if (t >= end) t = end;
+        s->edge_us[s->edges++] = t;         // 戻り
+        extra++;
+    }
+}
+
+static void make_stroke(stroke_t* s, uint32_t bounce_us) {
+    memset(s, 0, sizeof(*s));
+    s->row = rnd(0, MATRIX_ROWS - 1);
+    s->col = rnd(0, MATRIX_COLS - 1);
+
+    uint32_t t = rnd(1000, 20000);
+    add_bounce(s, t, bounce_us); // 閉じる側のチャタリング（偶数個の変化 + 閉）
+
+    t             = s->edge_us[s->edges - 1] + rnd(20000, 200000); // 押し続ける
+    s->release_us = t;
+    add_bounce(s, t, bounce_us); // 開く側（開 + 偶数個の変化）
+    s->end_us = s->edge_us[s->edges - 1] + 50000;
+}
+
+static bool contact_closed(const stroke_t* s, uint32_t t) {
+    uint8_t n = 0;
+    while (n < s->edges && s->edge_us[n] <= t) n++;
+    return (n & 1) != 0; // 押下側は閉で始まり開で終わるので奇数個なら閉
+}
+
+// ====== Reference: QMK sym_defer_g ===============================
+static matrix_row_t g_ref_cooked[MATRIX_ROWS];
+static fast_timer_t g_ref_since;
+static bool         g_ref_pending;
+
+static bool ref_debounce(matrix_row_t raw[], bool changed) {
+    fast_timer_t now = timer_read_fast();
+    if (changed) {
+        g_ref_pending = true;
+        g_ref_since   = now;
+    } else if (g_ref_pending && TIMER_DIFF_FAST(now, g_ref_since) >= DEBOUNCE) {
+        g_ref_pending = false;
+        memcpy(g_ref_cooked, raw, sizeof(g_ref_cooked));
+        return true;
+    }
+    return false;
+}
+
+// ====== Statistics ===============================================
+typedef struct {
+    uint32_t* v;
+    uint32_t  n;
+} series_t;
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char* name, series_t* s, uint32_t scan_us) {
+    if (s->n == 0) {
+        printf("%-18s  (no data)\n", name);
+        return;
+    }
+    qsort(s->v, s->n, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < s->n; i++) sum += s->v[i];
+    uint32_t p99 = s->v[(s->n * 99) / 100 < s->n ? (s->n * 99) / 100 : s->n - 1];
+    printf("%-18s  min %4u  avg %7.2f  p99 %4u  max %4u scans  (avg %6.0f us)\n", name, s->v[0],
+           (double)sum / s->n, p99, s->v[s->n - 1], (double)sum / s->n * scan_us);
+}
+
+// ====== Main =====================================================
+int main(int argc, char** argv) {
+    uint32_t trials    = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000;
+    uint32_t scan_us   = argc > 2 ? strtoul(argv[2], NULL, 0) : 200;
+    uint32_t bounce_us = argc > 3 ? strtoul(argv[3], NULL, 0) : 3000;
+    srand(argc > 4 ? strtoul(argv[4], NULL, 0) : 1);
+    if (trials == 0 || scan_us == 0) {
+        fprintf(stderr, "usage: %s [trials] [scan_us] [bounce_us] [seed]\n", argv[0]);
+        return 2;
+    }
+
+    series_t press = {calloc(trials, sizeof(uint32_t)), 0};
+    series_t rel   = {calloc(trials, sizeof(uint32_t)), 0};
+    series_t rpres = {calloc(trials, sizeof(uint32_t)), 0};
+    series_t rrel  = {calloc(trials, sizeof(uint32_t)), 0};
+
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t prev[MATRIX_ROWS]   = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+    uint32_t     extra = 0, missed = 0, bounced_strokes = 0;
+
+    debounce_init(MATRIX_ROWS);
+    for (uint32_t i = 0; i < trials; i++) {
+        stroke_t s;
+        make_stroke(&s, bounce_us);
+        if (s.edges > 2) bounced_strokes++;
+
+        matrix_row_t bit      = (matrix_row_t)1 << s.col;
+        uint32_t     start    = g_now_us;
+        uint32_t     presses  = 0, releases = 0, rpresses = 0, rreleases = 0;
+        bool         was_down = false, ref_down = false;
+
+        for (uint32_t t = 0; t < s.end_us; t += scan_us) {
+            g_now_us = start + t;
+
+            // matrix_scan(): 生の状態を読み、前回と違えば changed
+            memset(raw, 0, sizeof(raw));
+            if (contact_closed(&s, t)) raw[s.row] = bit;
+            bool changed = memcmp(raw, prev, sizeof(raw)) != 0;
+            memcpy(prev, raw, sizeof(raw));
+
+            debounce(raw, cooked, MATRIX_ROWS, changed);
+            bool down = (cooked[s.row] & bit) != 0;
+            if (down && !was_down) {
+                if (presses++ == 0) press.v[press.n++] = (t - s.edge_us[0] + scan_us - 1) / scan_us;
+            } else if (!down && was_down) {
+                if (t < s.release_us) extra++; // 押している最中に離しが出た
+                if (releases++ == 0) rel.v[rel.n++] = (t - s.release_us + scan_us - 1) / scan_us;
+            }
+            was_down = down;
+
+            ref_debounce(raw, changed);
+            bool rdown = (g_ref_cooked[s.row] & bit) != 0;
+            if (rdown && !ref_down) {
+                if (rpresses++ == 0) rpres.v[rpres.n++] = (t - s.edge_us[0] + scan_us - 1) / scan_us;
+            } else if (!rdown && ref_down) {
+                if (rreleases++ == 0) rrel.v[rrel.n++] = (t - s.release_us + scan_us - 1) / scan_us;
+            }
+            ref_down = rdown;
+        }
+        g_now_us = start + s.end_us;
+
+        if (presses > 1) extra += presses - 1;
+        if (releases > 1) extra += releases - 1;
+        if (presses == 0 || releases == 0 || was_down) missed++;
+    }
+
+    printf("[i] %u 打鍵（うちチャタリングあり %u）、スキャン %u us、チャタリング最大 %u us\n", trials,
+           bounced_strokes, scan_us, bounce_us);
+    printf("[i] eager: DEBOUNCE_PRESS_MS %d / DEBOUNCE_RELEASE_MS %d、比較: sym_defer_g DEBOUNCE %d\n",
+           DEBOUNCE_PRESS_MS, DEBOUNCE_RELEASE_MS, DEBOUNCE);
+    report("press   eager", &press, scan_us);
+    report("press   defer_g", &rpres, scan_us);
+    report("release eager", &rel, scan_us);
+    report("release defer_g", &rrel, scan_us);
+
+    if (extra || missed) {
+        printf("[!] 余分な押下/離し %u、取りこぼし %u\n", extra, missed);
+        return 1;
+    }
+    printf("[i] 余分な押下/離しなし\n");
+    return 0;
+}
@@ -0,0 +1,7 @@
+// scripts/debounce_sim/host/debounce.h
+// debounce_sim 用の最小限の代替（quantum/debounce.h と同じ宣言）
+#pragma once
+#include "matrix.h"
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+void debounce_init(uint8_t num_rows);
@@ -0,0 +1,10 @@
+// scripts/debounce_sim/host/matrix.h
+// debounce_sim 用の最小限の代替（keyboard.json: 片側 4x7、分割で 8 行）
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 7
+
+typedef uint8_t matrix_row_t;
@@ -0,0 +1,10 @@
+// scripts/debounce_sim/host/timer.h
+// debounce_sim 用の最小限の代替。時刻はシミュレータが進める
+#pragma once
+#include <stdint.h>
+
+typedef uint16_t fast_timer_t;
+
+fast_timer_t timer_read_fast(void);
+
+#define TIMER_DIFF_FAST(a, b) ((uint16_t)((a) - (b)))
@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# レイヤ解決のベンチマークをホスト向けにビルドする。
+# keymaps/vial の keymap.c / layer_cache.c をそのままリンクし、rules.mk と同じ -wrap で包む。
+# host/ の QMK 本体の代替は、-wrap が効く境界が実機と同じになるよう QMK と同じ単位で分けてある。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+QMK_HOST="$REPO_ROOT/scripts/qmk_host" # keymap.c 用の共通の代替ヘッダ
+CC=${CC:-cc}
+
+"$CC" -O2 -Wall -std=gnu11 \
+  -include "$KEYMAP_DIR/config.h" -DQMK_KEYBOARD_H='"split_ortho4x6.h"' -DLAYER_CACHE_ENABLE \
+  -I"$QMK_HOST" -I"$KEYMAP_DIR" -I"$KEYBOARD_DIR" \
+  "$HERE/layer_bench.c" "$HERE/host/action_layer.c" "$HERE/host/keymap_common.c" "$HERE/host/dynamic_keymap.c" \
+  "$QMK_HOST/keymap_stubs.c" "$KEYMAP_DIR/keymap.c" "$KEYMAP_DIR/layer_cache.c" \
+  -Wl,-wrap=action_for_key \
+  -Wl,-wrap=dynamic_keymap_set_keycode -Wl,-wrap=dynamic_keymap_set_buffer \
+  -o "$HERE/layer_bench"
+
+echo "[i] ビルド完了: $HERE/layer_bench"
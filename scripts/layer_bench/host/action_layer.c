@@ -0,0 +1,22 @@
+// scripts/layer_bench/host/action_layer.c
+// QMK 本体の action_layer.c の代替。action_for_key() は keymap_common.c にあり、
+// 別のオブジェクトからの呼び出しなので layer_cache.c の -wrap を通る（QMK と同じ）
+
+#include "quantum.h"
+
+layer_state_t layer_state;
+layer_state_t default_layer_state = 1;
+
+// action_layer.c と同じ
+uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if (layers & ((layer_state_t)1 << i)) {
+            action_t action = action_for_key(i, key);
+            if (action.code != ACTION_TRANSPARENT) return i;
+        }
+    }
+    return get_highest_layer(default_layer_state);
+}
+
+action_t layer_switch_get_action(keypos_t key) { return action_for_key(layer_switch_get_layer(key), key); }
@@ -0,0 +1,36 @@
+// scripts/layer_bench/host/dynamic_keymap.c
+// QMK 本体の dynamic_keymap.c の代替（EEPROM 上のキーマップ）
+
+#include <string.h>
+#include "quantum.h"
+
+static uint8_t g_eeprom[LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2];
+uint32_t       eeprom_reads; // dynamic_keymap_get_keycode() の呼び出し回数
+
+bool is_keyboard_left(void) { return true; }
+
+// dynamic_keymap.c と同じく、1 キー 2 バイト（ビッグエンディアン）
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+    const uint8_t* p = &g_eeprom[((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2];
+    eeprom_reads++;
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    uint8_t* p = &g_eeprom[((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2];
+    p[0]       = keycode >> 8;
+    p[1]       = keycode & 0xFF;
+}
+
+void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {
+    if (offset + size > sizeof(g_eeprom)) return;
+    memcpy(g_eeprom + offset, data, size);
+}
+
+// keymap.c の __wrap_dynamic_keymap_reset() が呼ぶもの
+void __real_dynamic_keymap_reset(void) {}
+int  dynamic_keymap_set_tap_dance(uint8_t index, const vial_tap_dance_entry_t* entry) { return 0; }
+int  dynamic_keymap_set_combo(uint8_t index, const vial_combo_entry_t* entry) { return 0; }
+int  dynamic_keymap_set_key_override(uint8_t index, const vial_key_override_entry_t* entry) { return 0; }
+uint16_t dynamic_keymap_macro_get_buffer_size(void) { return 0; }
+void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {}
@@ -0,0 +1,48 @@
+// scripts/layer_bench/host/keymap_common.c
+// QMK 本体の keymap_common.c の代替。action_for_key() はここから keymap_key_to_keycode() を
+// 呼ぶ（同じオブジェクトなので -wrap では横取りできない。QMK と同じ）
+
+#include "quantum.h"
+
+keymap_config_t keymap_config;
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (layer >= LAYER_COUNT) return KC_TRANSPARENT;
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) return dynamic_keymap_get_keycode(layer, key.row, key.col);
+    return KC_NO;
+}
+
+// keycode_config.c の keycode_config() のうち、左 Alt/GUI の入れ替えだけ
+static uint16_t keycode_config(uint16_t keycode) {
+    if (keymap_config.raw & KEYMAP_CONFIG_SWAP_LALT_LGUI) {
+        if (keycode == KC_LEFT_ALT) return KC_LEFT_GUI;
+        if (keycode == KC_LEFT_GUI) return KC_LEFT_ALT;
+    }
+    return keycode;
+}
+
+// action_code.h の区分ごとの変換（action_for_keycode() の主な分岐だけ）
+static action_t action_for_keycode(uint16_t keycode) {
+    action_t action = {.code = 0};
+    keycode         = keycode_config(keycode);
+    switch (keycode) {
+        case KC_TRANSPARENT:
+            action.code = ACTION_TRANSPARENT;
+            break;
+        case KC_A ... QK_BASIC_MAX:
+            action.code = keycode;
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            action.code = (keycode & 0x1F00) | (keycode & 0xFF);
+            break;
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            action.code = 0x2000 | (keycode & 0x1FFF);
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            action.code = 0xA000 | (keycode & 0x0FFF);
+            break;
+    }
+    return action;
+}
+
+action_t action_for_key(uint8_t layer, keypos_t key) { return action_for_keycode(keymap_key_to_keycode(layer, key)); }
@@ -0,0 +1,160 @@
+// scripts/layer_bench/layer_bench.c
+// keymap.c の keymaps[] を Vial の動的キーマップ（EEPROM 形式）に読み込み、
+// キーイベント 1 回ぶんのアクション解決（action_layer.c の layer_switch_get_action()、
+// layer_switch_get_layer() → action_for_key()）をキャッシュなし/ありで比べる。
+// host/ は QMK と同じく action_layer.c / keymap_common.c / dynamic_keymap.c を別の
+// オブジェクトにしてあり、layer_cache.c は実機と同じ呼び出しだけを横取りする。
+//
+//   ./layer_bench              # 既定 2000000 回
+//   ./layer_bench 10000000
+//
+// 全レイヤ状態の組み合わせで両者の結果が一致すること、キーマップを書き換えた後も
+// 一致することを確かめ、食い違えば終了コード 1。
+// 出力の「EEPROM 読み出し」は dynamic_keymap_get_keycode() の呼び出し回数で、
+// ホストの速さに依存しない指標（実機ではこれが EEPROM キャッシュの読み出しになる）。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "quantum.h"
+#include "layer_cache.h"
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+
+// host/qmk_core.c
+extern uint32_t eeprom_reads;
+
+// ====== Reference / cached lookups ===============================
+// -Wl,-wrap で layer_cache.c を通さない元の関数
+action_t __real_action_for_key(uint8_t layer, keypos_t key);
+
+// キャッシュなし: host/action_layer.c と同じ処理を元の action_for_key() で
+static uint8_t plain_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && __real_action_for_key(i, key).code != ACTION_TRANSPARENT) return i;
+    }
+    return get_highest_layer(default_layer_state);
+}
+
+static uint16_t lookup_plain(keypos_t key) { return __real_action_for_key(plain_get_layer(key), key).code; }
+static uint16_t lookup_cached(keypos_t key) { return layer_switch_get_action(key).code; }
+
+// keymap.c で使っている組み合わせ（LT(1..6) と、LT(4) + LT(5) のような重ね押し）
+static const layer_state_t k_states[] = {0, 1u << 1, 1u << 2, 1u << 3, 1u << 4, 1u << 5, 1u << 6, (1u << 4) | (1u << 5)};
+#define NUM_STATES (sizeof(k_states) / sizeof(k_states[0]))
+
+static keypos_t g_keys[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t  g_num_keys;
+
+static bool check_all(const char* when) {
+    uint32_t bad = 0;
+    for (layer_state_t s = 0; s < (1u << LAYER_COUNT); s++) {
+        layer_state = s;
+        for (uint8_t i = 0; i < g_num_keys; i++) {
+            keypos_t k = g_keys[i];
+            bool same = layer_switch_get_layer(k) == plain_get_layer(k) && lookup_cached(k) == lookup_plain(k);
+            // 離す時は押した時のレイヤで引かれるので、どのレイヤでも元と同じであること
+            for (uint8_t l = 0; l < LAYER_COUNT; l++) same &= action_for_key(l, k).code == __real_action_for_key(l, k).code;
+            if (!same && bad++ < 5) printf("[!] %s: layer_state 0x%02x (%u,%u) 不一致\n", when, s, k.row, k.col);
+        }
+    }
+    layer_state = 0;
+    return bad == 0;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 打鍵列: 半分は素のレイヤ、残りは LT() のどれかを押したまま 1〜8 打鍵
+typedef struct {
+    layer_state_t state;
+    keypos_t      key;
+} stroke_t;
+
+static stroke_t* g_seq;
+
+static void make_sequence(uint32_t n) {
+    g_seq = malloc(n * sizeof(*g_seq));
+    srand(1);
+    layer_state_t state = 0;
+    uint32_t      left  = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (left-- == 0) {
+            state = rand() % 2 ? 0 : k_states[1 + rand() % (NUM_STATES - 1)];
+            left  = rand() % 8;
+        }
+        g_seq[i] = (stroke_t){state, g_keys[rand() % g_num_keys]};
+    }
+}
+
+static volatile uint16_t g_sink;
+
+static void bench(const char* name, uint16_t (*lookup)(keypos_t), uint32_t n) {
+    eeprom_reads = 0;
+    double t0    = now_s();
+    for (uint32_t i = 0; i < n; i++) {
+        layer_state = g_seq[i].state;
+        g_sink      = lookup(g_seq[i].key);
+    }
+    double dt = now_s() - t0;
+    printf("%-8s  %7.1f ns/回  EEPROM 読み出し %5.2f 回/回\n", name, dt * 1e9 / n, (double)eeprom_reads / n);
+    layer_state = 0;
+}
+
+// ====== Main =====================================================
+int main(int argc, char** argv) {
+    uint32_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000000;
+
+    // EEPROM 形式にして dynamic_keymap_set_buffer() で書き込む（Vial の一括書き込みと同じ経路）
+    uint8_t buf[LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2];
+    for (uint8_t l = 0; l < LAYER_COUNT; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+                uint16_t kc = keymaps[l][r][c];
+                size_t   o  = ((l * MATRIX_ROWS + r) * MATRIX_COLS + c) * 2;
+                buf[o]      = kc >> 8;
+                buf[o + 1]  = kc & 0xFF;
+                if (l == 0 && kc != KC_NO) g_keys[g_num_keys++] = (keypos_t){.row = r, .col = c};
+            }
+        }
+    }
+    dynamic_keymap_set_buffer(0, sizeof(buf), buf);
+
+    bool ok = check_all("初期キーマップ");
+    // Vial からの 1 キー書き換え: レイヤ 6 の透過キーに割り当て、元に戻す
+    keypos_t k = g_keys[0];
+    layer_state = 1u << 6;
+    lookup_cached(k); // 書き換え前の値をキャッシュに載せておく
+    dynamic_keymap_set_keycode(6, k.row, k.col, KC_F12);
+    ok &= lookup_cached(k) == KC_F12;
+    ok &= check_all("set_keycode 後");
+    dynamic_keymap_set_keycode(6, k.row, k.col, KC_TRANSPARENT);
+    ok &= check_all("元に戻した後");
+    // Magic のスワップ（keymap_config）でアクションが変わる: 素のレイヤの KC_LEFT_GUI で確かめる
+    layer_state = 0;
+    for (uint8_t i = 0; i < g_num_keys; i++) {
+        if (keymaps[0][g_keys[i].row][g_keys[i].col] == KC_LEFT_GUI) k = g_keys[i];
+    }
+    lookup_cached(k);
+    keymap_config.raw ^= KEYMAP_CONFIG_SWAP_LALT_LGUI;
+    ok &= lookup_cached(k) == lookup_plain(k);
+    ok &= check_all("Alt/GUI 入れ替え後");
+    keymap_config.raw ^= KEYMAP_CONFIG_SWAP_LALT_LGUI;
+
+    make_sequence(n);
+    printf("[i] %u キー x %u レイヤ、%u 回（%u 種類のレイヤ状態）\n", g_num_keys, LAYER_COUNT, n, (unsigned)NUM_STATES);
+    bench("plain", lookup_plain, n);
+    bench("cached", lookup_cached, n);
+
+    if (!ok) {
+        printf("[!] キャッシュの結果が元の解決と一致しない\n");
+        return 1;
+    }
+    printf("[i] 全レイヤ状態で結果一致\n");
+    return 0;
+}
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由でスプリット通信の統計を取得する。
+
+  python3 scripts/link_stats.py enable    # カウンタをクリアして計測開始
+  python3 scripts/link_stats.py show      # 種別ごとの往復時間・失敗・転送量
+  python3 scripts/link_stats.py show -i 2 # 2 秒おきに表示し続ける
+  python3 scripts/link_stats.py disable
+
+show の列:
+  count     トランザクション数
+  fail      失敗（うち timeout は応答なし、それ以外はチェックサム等の不一致）
+  retry     同じ種別の失敗直後の再実行
+  rtt       往復時間 (us) の最小/平均/最大
+  B/s       計測開始からのペイロード転送量
+  hist      往復時間 <64, <128, ..., >=4096us の度数
+
+計測はマスター側（USB 接続側）で行う。
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import struct
+import time
+
+import vial_rawhid
+from vial_rawhid import open_device
+
+LINK_STATS_ENABLE = 0x01
+LINK_STATS_INFO = 0x02
+LINK_STATS_READ = 0x03
+
+NAMES = ["matrix_checksum", "matrix_data", "rpc_info", "rpc_req", "rpc_exec", "rpc_resp"]
+
+
+def command(dev, sub, payload=b""):
+    return vial_rawhid.command(dev, vial_rawhid.CMD_LINK_STATS, sub, payload, "LINK_STATS_ENABLE")
+
+
+def info(dev):
+    body = command(dev, LINK_STATS_INFO)
+    enabled, count, uptime_ms, buckets = struct.unpack_from("<BBIB", body)
+    names = {}
+    for name, tid in zip(NAMES, body[7:13]):
+        if tid != vial_rawhid.ERR:
+            names[tid] = name
+    return dict(enabled=bool(enabled), count=count, uptime_ms=uptime_ms, buckets=buckets, names=names)
+
+
+def read(dev, tid, buckets):
+    count, fails, timeouts, retries, rtt_min, rtt_max, rtt_sum = struct.unpack_from(
+        "<7I", command(dev, LINK_STATS_READ, bytes([tid, 0])), 2)
+    body = command(dev, LINK_STATS_READ, bytes([tid, 1]))
+    (nbytes,) = struct.unpack_from("<I", body, 2)
+    hist = struct.unpack_from(f"<{buckets}H", body, 6)
+    return dict(count=count, fails=fails, timeouts=timeouts, retries=retries,
+                rtt_min=rtt_min, rtt_max=rtt_max, rtt_sum=rtt_sum, bytes=nbytes, hist=hist)
+
+
+def show(dev):
+    st = info(dev)
+    if not st["enabled"]:
+        print("[i] 計測は停止中です（link_stats.py enable）")
+    secs = max(st["uptime_ms"], 1) / 1000
+    print(f"{'id':>3} {'name':<16} {'count':>8} {'fail':>6} {'timeout':>7} {'retry':>6} "
+          f"{'rtt min/avg/max':>18} {'B/s':>8}  hist")
+    for tid in range(st["count"]):
+        s = read(dev, tid, st["buckets"])
+        if s["count"] == 0:
+            continue
+        avg = s["rtt_sum"] // s["count"]
+        rtt = f"{s['rtt_min']}/{avg}/{s['rtt_max']}"
+        print(f"{tid:>3} {st['names'].get(tid, 'user'):<16} {s['count']:>8} {s['fails']:>6} "
+              f"{s['timeouts']:>7} {s['retries']:>6} {rtt:>18} {s['bytes'] / secs:>8.0f}  "
+              + " ".join(str(h) for h in s["hist"]))
+    print(f"[i] 計測時間 {secs:.1f} 秒")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("action", choices=["enable", "disable", "show"])
+    ap.add_argument("-i", "--interval", type=float, help="show: 指定秒ごとに繰り返す")
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        if args.action == "enable":
+            command(dev, LINK_STATS_ENABLE, bytes([1]))
+            print("[i] 計測を開始しました")
+        elif args.action == "disable":
+            command(dev, LINK_STATS_ENABLE, bytes([0]))
+        else:
+            while True:
+                show(dev)
+                if not args.interval:
+                    break
+                time.sleep(args.interval)
+                print()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    main()
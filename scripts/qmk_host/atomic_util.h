@@ -0,0 +1,6 @@
+// scripts/qmk_host/atomic_util.h
+// ホストでは割り込みが無いので保護は要らない
+#pragma once
+#include <stdbool.h>
+
+#define ATOMIC_BLOCK_FORCEON if (true)
@@ -0,0 +1,6 @@
+// scripts/qmk_host/crc.h
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+uint8_t crc8(const void* data, size_t data_len);
@@ -0,0 +1,8 @@
+// scripts/qmk_host/debounce.h
+// quantum/debounce.h と同じ宣言
+#pragma once
+#include <stdbool.h>
+#include "matrix.h"
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+void debounce_init(uint8_t num_rows);
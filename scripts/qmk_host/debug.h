@@ -0,0 +1,4 @@
+// scripts/qmk_host/debug.h
+#pragma once
+
+#define dprintf(...) ((void)0)
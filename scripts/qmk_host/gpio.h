@@ -0,0 +1,21 @@
+// scripts/qmk_host/gpio.h
+// ホストツール用の最小限の代替（paw3222.h が pin_t を使うため）
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint32_t pin_t;
+#define NO_PIN ((pin_t)~0u)
+
+void gpio_set_pin_output(pin_t pin);
+void gpio_set_pin_input_high(pin_t pin);
+void gpio_write_pin_high(pin_t pin);
+void gpio_write_pin_low(pin_t pin);
+bool gpio_read_pin(pin_t pin);
+
+// ChibiOS の PAL（paw3222.c の MOTION 割り込み）
+typedef void (*palcallback_t)(void* arg);
+#define PAL_EVENT_MODE_FALLING_EDGE 2
+
+void palEnableLineEvent(pin_t line, uint32_t mode);
+void palSetLineCallback(pin_t line, palcallback_t cb, void* arg);
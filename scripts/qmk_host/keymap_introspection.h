@@ -0,0 +1,6 @@
+// scripts/qmk_host/keymap_introspection.h
+#pragma once
+#include "quantum.h"
+
+uint16_t combo_count(void);
+combo_t* combo_get(uint16_t combo_idx);
@@ -0,0 +1,16 @@
+// scripts/qmk_host/keymap_stubs.c
+// keymap.c のユーザコード（USER CODE）が参照する関数の空の実装。
+// keymap.c だけをリンクするホストツール用
+
+#include "quantum.h"
+
+void           tb_split_init(void) {}
+void           tb_init(void) {}
+bool           tb_process_record(uint16_t keycode, keyrecord_t* record) { return true; }
+report_mouse_t tb_split_task(report_mouse_t r) { return r; }
+void           paw3222_sampler_task(void) {}
+void           tb_task(void) {}
+void           tb_flush(void) {}
+void           tb_accel_raw_hid(uint8_t* data, uint8_t length) {}
+void           tb_save_raw_hid(uint8_t* data, uint8_t length) {}
+void           tb_split_sensor_raw_hid(uint8_t* data, uint8_t length) {}
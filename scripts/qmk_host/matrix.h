@@ -0,0 +1,11 @@
+// scripts/qmk_host/matrix.h
+// keyboard.json: 片側 4x7、分割で 8 行
+#pragma once
+#include <stdint.h>
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 7
+
+typedef uint8_t matrix_row_t;
+
+matrix_row_t matrix_get_row(uint8_t row);
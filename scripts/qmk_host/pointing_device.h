@@ -0,0 +1,35 @@
+// scripts/qmk_host/pointing_device.h
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int16_t mouse_xy_report_t;
+typedef int16_t mouse_hv_report_t;
+
+// report.h: MOUSE_EXTENDED_REPORT（config.h）の有無で出力範囲が変わる
+#ifdef MOUSE_EXTENDED_REPORT
+#    define XY_REPORT_MIN INT16_MIN
+#    define XY_REPORT_MAX INT16_MAX
+#else
+#    define XY_REPORT_MIN INT8_MIN
+#    define XY_REPORT_MAX INT8_MAX
+#endif
+
+typedef struct {
+    uint8_t           buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
+} report_mouse_t;
+
+typedef struct {
+    void (*init)(void);
+    report_mouse_t (*get_report)(report_mouse_t mouse_report);
+    void (*set_cpi)(uint16_t cpi);
+    uint16_t (*get_cpi)(void);
+} pointing_device_driver_t;
+
+void     pointing_device_set_cpi(uint16_t cpi);
+uint16_t pointing_device_get_cpi(void);
+uint16_t pointing_device_get_hires_scroll_resolution(void);
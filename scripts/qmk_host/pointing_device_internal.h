@@ -0,0 +1,5 @@
+// scripts/qmk_host/pointing_device_internal.h
+#pragma once
+#include "debug.h"
+
+#define pd_dprintf(...) ((void)0)
@@ -0,0 +1,186 @@
+// scripts/qmk_host/process_combo.c
+// QMK の process_combo.c と vial.c のコンボ読み込みの代替。QMK と同じ流れで動かす:
+//   - コンボに含まれるキーの押下は保留し、COMBO_TERM の間に全キーが揃えばコンボを出す
+//   - 保留中にコンボ以外のキーが来たり離されたりしたら、保留分を先に吐き出す
+//   - 出したコンボのキーの離しは飲み込み、最後のキーを離した時にコンボを離す
+// 出力（QMK では process_record() への再投入）は各ツールの combo_host_emit() に渡す。
+// 時刻は timer_read()（ms）。
+
+#include <string.h>
+#include "quantum.h"
+#include "keymap_introspection.h"
+
+#ifndef COMBO_TERM
+#    define COMBO_TERM 50
+#endif
+#define COMBO_KEY_BUFFER_LENGTH 8
+
+void combo_host_emit(uint16_t keycode, keypos_t key, bool pressed);
+
+uint32_t combo_host_checks; // process_single_combo() の呼び出し回数
+
+// ====== Vial combo storage =======================================
+static vial_combo_entry_t g_entries[VIAL_COMBO_ENTRIES];
+static uint16_t           g_keys[VIAL_COMBO_ENTRIES][5];
+static combo_t            g_combos[VIAL_COMBO_ENTRIES];
+
+// vial.c の reload_combo() と同じく、空でない入力だけを COMBO_END 終端で並べる
+static void reload_combo(void) {
+    for (uint8_t i = 0; i < VIAL_COMBO_ENTRIES; i++) {
+        uint8_t n = 0;
+        for (uint8_t k = 0; k < 4; k++) {
+            if (g_entries[i].input[k] != KC_NO) g_keys[i][n++] = g_entries[i].input[k];
+        }
+        g_keys[i][n] = COMBO_END;
+        g_combos[i] = (combo_t){.keys = g_keys[i], .keycode = g_entries[i].output};
+    }
+}
+
+int dynamic_keymap_set_combo(uint8_t index, const vial_combo_entry_t* entry) {
+    if (index >= VIAL_COMBO_ENTRIES) return -1;
+    g_entries[index] = *entry;
+    reload_combo();
+    return 0;
+}
+
+uint16_t combo_count(void) { return VIAL_COMBO_ENTRIES; }
+combo_t* combo_get(uint16_t combo_idx) { return &g_combos[combo_idx]; }
+
+// ====== Engine ===================================================
+static struct {
+    uint16_t keycode;
+    keypos_t key;
+} g_buf[COMBO_KEY_BUFFER_LENGTH];
+static uint8_t  g_buf_n;
+static uint16_t g_timer; // 0 = 保留なし
+static int16_t  g_prepared = -1; // 全キーが揃ったコンボ
+static bool     g_enabled  = true;
+
+void combo_host_reset(void) {
+    g_buf_n    = 0;
+    g_timer    = 0;
+    g_prepared = -1;
+    g_enabled  = true;
+    reload_combo();
+}
+
+static int8_t key_index(const combo_t* c, uint16_t keycode, uint8_t* count) {
+    int8_t idx = -1;
+    uint8_t n  = 0;
+    for (; c->keys[n] != COMBO_END; n++) {
+        if (c->keys[n] == keycode) idx = n;
+    }
+    *count = n;
+    return idx;
+}
+
+static uint8_t combo_len(const combo_t* c) {
+    uint8_t n = 0;
+    while (c->keys[n] != COMBO_END) n++;
+    return n;
+}
+
+static void dump_key_buffer(void) {
+    for (uint8_t i = 0; i < g_buf_n; i++) combo_host_emit(g_buf[i].keycode, g_buf[i].key, true);
+    g_buf_n = 0;
+}
+
+static void clear_combos(void) {
+    for (uint8_t i = 0; i < VIAL_COMBO_ENTRIES; i++) {
+        if (!g_combos[i].active) g_combos[i].state = 0;
+    }
+}
+
+// 揃ったコンボを出す。保留中のうちコンボに含まれないキーは先に吐き出す。
+// コンボ自体は最後に押したキーの位置で出す
+static void apply_combo(void) {
+    combo_t* c = &g_combos[g_prepared];
+    uint8_t  n;
+    for (uint8_t i = 0; i < g_buf_n; i++) {
+        if (key_index(c, g_buf[i].keycode, &n) < 0) combo_host_emit(g_buf[i].keycode, g_buf[i].key, true);
+    }
+    combo_host_emit(c->keycode, g_buf[g_buf_n - 1].key, true);
+    c->active  = true;
+    g_buf_n    = 0;
+    g_timer    = 0;
+    g_prepared = -1;
+    clear_combos();
+}
+
+static bool process_single_combo(combo_t* combo, uint16_t idx, uint16_t keycode, keyrecord_t* record) {
+    uint8_t n;
+    int8_t  ki = key_index(combo, keycode, &n);
+    combo_host_checks++;
+    if (ki < 0) return false;
+
+    uint8_t bit = 1 << ki;
+    if (record->event.pressed) {
+        combo->state |= bit;
+        // 揃ったものが複数あればキーの多い方
+        if (combo->state == (1 << n) - 1 && !combo->active && (g_prepared < 0 || n > combo_len(&g_combos[g_prepared]))) {
+            g_prepared = idx;
+        }
+        return true;
+    }
+    if (combo->active && (combo->state & bit)) {
+        combo->state &= ~bit;
+        if (combo->state == 0) {
+            combo_host_emit(combo->keycode, record->event.key, false);
+            combo->active = false;
+        }
+        return true;
+    }
+    combo->state &= ~bit;
+    return false;
+}
+
+// combo_disable() と同じく、無効にする時は保留分を吐き出して状態を捨てる
+static void combo_disable(void) {
+    g_enabled  = false;
+    g_timer    = 0;
+    g_prepared = -1;
+    clear_combos();
+    dump_key_buffer();
+}
+
+bool process_combo(uint16_t keycode, keyrecord_t* record) {
+    if (keycode >= QK_COMBO_ON && keycode <= QK_COMBO_TOGGLE) {
+        if (record->event.pressed) {
+            if (keycode == QK_COMBO_ON || (keycode == QK_COMBO_TOGGLE && !g_enabled)) {
+                g_enabled = true;
+            } else {
+                combo_disable();
+            }
+        }
+        return true;
+    }
+    if (!g_enabled) return true;
+
+    bool is_combo_key = false;
+    for (uint16_t idx = 0; idx < combo_count(); idx++) {
+        is_combo_key |= process_single_combo(combo_get(idx), idx, keycode, record);
+    }
+
+    if (record->event.pressed && is_combo_key) {
+        if (g_buf_n < COMBO_KEY_BUFFER_LENGTH) g_buf[g_buf_n++] = (typeof(g_buf[0])){keycode, record->event.key};
+        g_timer = timer_read() | 1;
+    } else if (g_prepared >= 0) {
+        apply_combo();
+    } else {
+        dump_key_buffer();
+        g_timer = 0;
+        clear_combos();
+    }
+    return !is_combo_key;
+}
+
+void combo_task(void) {
+    if (!g_timer || (uint16_t)(timer_read() - g_timer) < COMBO_TERM) return;
+    if (g_prepared >= 0) {
+        apply_combo();
+    } else {
+        dump_key_buffer();
+        clear_combos();
+    }
+    g_timer = 0;
+}
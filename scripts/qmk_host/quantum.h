@@ -0,0 +1,159 @@
+// scripts/qmk_host/quantum.h
+// keymap.c をホストでビルドするための最小限の代替ヘッダ（QMK 本体は使わない）。
+// キーコードの値は QMK の keycodes.h と同じ
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "matrix.h"
+#include "pointing_device.h"
+#include "timer.h"
+
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// ====== Keycodes =================================================
+enum {
+    KC_NO = 0x0000, KC_TRANSPARENT = 0x0001,
+    KC_A = 0x0004, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENTER, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE, KC_MINUS, KC_EQUAL,
+    KC_LEFT_BRACKET, KC_RIGHT_BRACKET, KC_BACKSLASH, KC_NONUS_HASH, KC_SEMICOLON, KC_QUOTE,
+    KC_F12      = 0x0045,
+    KC_RIGHT    = 0x004F, KC_LEFT, KC_DOWN, KC_UP,
+    KC_KP_MINUS = 0x0056, KC_KP_PLUS,
+    KC_KP_0     = 0x0062,
+    KC_INTERNATIONAL_1 = 0x0087,
+    KC_LANGUAGE_1 = 0x0090, KC_LANGUAGE_2,
+    KC_MISSION_CONTROL = 0x00C1,
+    KC_MS_BTN1 = 0x00D1, KC_MS_BTN2, KC_MS_BTN3, KC_MS_BTN4, KC_MS_BTN5, KC_MS_BTN6, KC_MS_BTN7, KC_MS_BTN8,
+    KC_LEFT_CTRL = 0x00E0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI,
+    KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI,
+};
+#define KC_COMMA 0x0036
+#define KC_DOT 0x0037
+#define KC_SLASH 0x0038
+#define KC_TRNS KC_TRANSPARENT
+#define KC_INT1 KC_INTERNATIONAL_1
+#define KC_BTN1 KC_MS_BTN1
+#define KC_BTN2 KC_MS_BTN2
+#define KC_BTN3 KC_MS_BTN3
+
+#define QK_BASIC_MAX 0x00FF
+#define QK_MODS 0x0100
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_MODS_MAX 0x1FFF
+#define QK_MOD_TAP 0x2000
+#define QK_MOD_TAP_MAX 0x3FFF
+#define QK_LAYER_TAP 0x4000
+#define QK_LAYER_TAP_MAX 0x4FFF
+#define QK_KB_0 0x7E00
+#define QK_BOOT 0x7C00
+#define QK_COMBO_ON 0x7C50
+#define QK_COMBO_OFF 0x7C51
+#define QK_COMBO_TOGGLE 0x7C52
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define SGUI(kc) (QK_LGUI | QK_LSFT | (kc))
+#define MOD_LSFT 0x02
+#define MOD_RSFT 0x12
+#define MT(mod, kc) (QK_MOD_TAP | (((mod)&0x1F) << 8) | ((kc)&0xFF))
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer)&0xF) << 8) | ((kc)&0xFF))
+
+// ====== Keyboard / layers ========================================
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint16_t time;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+typedef uint32_t layer_state_t;
+#define MAX_LAYER 32
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+#define get_highest_layer(state) ((state) ? (uint8_t)(31 - __builtin_clz(state)) : 0)
+
+uint8_t  layer_switch_get_layer(keypos_t key);
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+// action_code.h / keycode_config.h（アクションの中身は使わないので code だけ）
+typedef union {
+    uint16_t code;
+} action_t;
+#define ACTION_TRANSPARENT 0x0001
+
+typedef union {
+    uint16_t raw;
+} keymap_config_t;
+#define KEYMAP_CONFIG_SWAP_LALT_LGUI (1 << 2) // keymap_config.swap_lalt_lgui
+extern keymap_config_t keymap_config;
+
+action_t action_for_key(uint8_t layer, keypos_t key);
+action_t layer_switch_get_action(keypos_t key);
+bool     is_keyboard_left(void);
+bool     is_keyboard_master(void);
+bool     is_transport_connected(void); // split_util.h
+
+// ====== EEPROM (eeconfig.h) ======================================
+uint32_t eeconfig_read_kb(void);
+void     eeconfig_update_kb(uint32_t val);
+uint32_t eeconfig_read_kb_datablock(void* data, uint32_t offset, uint32_t length);
+uint32_t eeconfig_update_kb_datablock(const void* data, uint32_t offset, uint32_t length);
+
+// ====== Vial dynamic keymap ======================================
+typedef struct {
+    uint16_t on_tap, on_hold, on_double_tap, on_tap_hold, custom_tapping_term;
+} vial_tap_dance_entry_t;
+
+typedef struct {
+    uint16_t input[4];
+    uint16_t output;
+} vial_combo_entry_t;
+
+typedef struct {
+    uint16_t trigger, replacement, layers;
+    uint8_t  trigger_mods, negative_mod_mask, suppressed_mods, options;
+} vial_key_override_entry_t;
+
+#define LAYER_COUNT 8 // keyboard.json: dynamic_keymap.layer_count
+
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column);
+void     dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode);
+void     dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t* data);
+int      dynamic_keymap_set_tap_dance(uint8_t index, const vial_tap_dance_entry_t* entry);
+int      dynamic_keymap_set_combo(uint8_t index, const vial_combo_entry_t* entry);
+int      dynamic_keymap_set_key_override(uint8_t index, const vial_key_override_entry_t* entry);
+void     dynamic_keymap_reset(void);
+uint16_t dynamic_keymap_macro_get_buffer_size(void);
+void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t* data);
+
+// ====== Combos (process_combo.h) =================================
+#define COMBO_END 0
+
+typedef struct {
+    const uint16_t* keys;
+    uint16_t        keycode;
+    uint8_t         state; // 押されているキーのビット
+    bool            active;
+} combo_t;
+
+bool process_combo(uint16_t keycode, keyrecord_t* record);
@@ -0,0 +1,4 @@
+// scripts/qmk_host/raw_hid.h
+#pragma once
+
+#define RAW_EPSIZE 32
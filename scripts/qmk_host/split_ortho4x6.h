@@ -0,0 +1,22 @@
+// scripts/qmk_host/split_ortho4x6.h
+// QMK_KEYBOARD_H の代替。LAYOUT は keyboard.json の "matrix" から作ったもの
+#pragma once
+#include "quantum.h"
+
+#define LAYOUT( \
+    k00, k01, k02, k03, k04, k06, k10, k11, \
+    k12, k13, k14, k16, k20, k21, k22, k23, \
+    k24, k30, k34, k35, k36, k40, k41, k42, \
+    k43, k44, k45, k50, k51, k52, k53, k54, \
+    k55, k61, k62, k63, k64, k65, k70, k71, \
+    k75 \
+) { \
+        { k00, k01, k02, k03, k04, KC_NO, k06 }, \
+        { k10, k11, k12, k13, k14, KC_NO, k16 }, \
+        { k20, k21, k22, k23, k24, KC_NO, KC_NO }, \
+        { k30, KC_NO, KC_NO, KC_NO, k34, k35, k36 }, \
+        { k40, k41, k42, k43, k44, k45, KC_NO }, \
+        { k50, k51, k52, k53, k54, k55, KC_NO }, \
+        { KC_NO, k61, k62, k63, k64, k65, KC_NO }, \
+        { k70, k71, KC_NO, KC_NO, KC_NO, k75, KC_NO } \
+}
@@ -0,0 +1,13 @@
+// scripts/qmk_host/timer.h
+// QMK の timer.h の代替（宣言のみ）。時刻は各ツールが進める
+#pragma once
+#include <stdint.h>
+
+typedef uint32_t fast_timer_t; // 32bit MCU（RP2040）と同じ幅
+
+uint16_t     timer_read(void);
+uint32_t     timer_read32(void);
+uint32_t     timer_elapsed32(uint32_t last);
+fast_timer_t timer_read_fast(void);
+
+#define TIMER_DIFF_FAST(a, b) ((fast_timer_t)((a) - (b)))
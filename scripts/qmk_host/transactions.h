@@ -0,0 +1,33 @@
+// scripts/qmk_host/transactions.h
+// quantum/split_common/transactions.h と transaction_id_define.h の代替。
+// トランザクション ID はこのキーボードの構成（SPLIT_POINTING 等の同期なし）で使うものだけ
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef RPC_M2S_BUFFER_SIZE
+#    define RPC_M2S_BUFFER_SIZE 32
+#endif
+#ifndef RPC_S2M_BUFFER_SIZE
+#    define RPC_S2M_BUFFER_SIZE 32
+#endif
+
+enum serial_transaction_id {
+    GET_SLAVE_MATRIX_CHECKSUM,
+    GET_SLAVE_MATRIX_DATA,
+    PUT_RPC_INFO,
+    PUT_RPC_REQ_DATA,
+    EXECUTE_RPC,
+    GET_RPC_RESP_DATA,
+#ifdef SPLIT_TRANSACTION_IDS_USER
+    SPLIT_TRANSACTION_IDS_USER, // config.h
+#endif
+    NUM_TOTAL_TRANSACTIONS
+};
+
+typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void* initiator2target_buffer,
+                                 uint8_t target2initiator_buffer_size, void* target2initiator_buffer);
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
+bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void* initiator2target_buffer,
+                          uint8_t target2initiator_buffer_size, void* target2initiator_buffer);
@@ -0,0 +1,4 @@
+// scripts/qmk_host/via.h
+#pragma once
+
+enum { id_unhandled = 0xFF };
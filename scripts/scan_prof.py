@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由でメインループの段階別所要時間を取得する。
+
+SCAN_PROFILER_ENABLE=yes でビルドしたファームウェアが必要:
+  make split_ortho4x6:vial SCAN_PROFILER_ENABLE=yes
+（target.json の flags に書けば local_build_vial.sh でも有効になる）
+
+  python3 scripts/scan_prof.py reset      # 集計をクリア
+  python3 scripts/scan_prof.py show       # 段階ごとの min/avg/max とヒストグラム
+  python3 scripts/scan_prof.py show --hist
+  python3 scripts/scan_prof.py show --save fast.json
+  python3 scripts/scan_prof.py compare stock.json fast.json   # 2 回の show --save を比べる
+
+FAST_MATRIX_ENABLE の比較は、yes/no それぞれのビルドで reset -> 同じ時間放置（またはタイプ）
+-> show --save とし、compare で matrix の行を見る（keymaps/vial/readme.md）。
+
+段階:
+  loop       メインループ 1 周（housekeeping_task の間隔）
+  matrix     matrix_scan()（split の分を除く）
+  split      transport_master()
+  split_tb   右トラックボールの RPC
+  sensor     サンプラのバス読み出し 1 回（paw3222_sample()）。PAW3222_CORE1=yes では
+             コア 1 が読むので、コア 0 での FIFO の取り出し
+  xform      tb_task_combined()
+  usb        host_keyboard_send() / host_mouse_send()
+
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import json
+import struct
+
+import vial_rawhid
+from vial_rawhid import open_device
+
+SCAN_PROF_RESET = 0x01
+SCAN_PROF_INFO = 0x02
+SCAN_PROF_READ = 0x03
+
+STAGES = ["loop", "matrix", "split", "split_tb", "sensor", "xform", "usb"]
+FIRST_BUCKET_US = 8
+
+
+def command(dev, sub, payload=b""):
+    return vial_rawhid.command(dev, vial_rawhid.CMD_SCAN_PROF, sub, payload, "SCAN_PROFILER_ENABLE")
+
+
+def bucket_label(i, buckets):
+    if i == buckets - 1:
+        return f">={FIRST_BUCKET_US << (i - 1)}us"
+    return f"<{FIRST_BUCKET_US << i}us"
+
+
+def read(dev, stage, buckets):
+    count, lo, hi, sum_lo, sum_hi = struct.unpack_from("<5I", command(dev, SCAN_PROF_READ, bytes([stage, 0])), 2)
+    hist = []
+    half = buckets // 2
+    for part in (1, 2):
+        hist += struct.unpack_from(f"<{half}I", command(dev, SCAN_PROF_READ, bytes([stage, part])), 2)
+    return dict(count=count, min=lo, max=hi, sum=sum_lo | (sum_hi << 32), hist=hist)
+
+
+def avg(s):
+    return s["sum"] / s["count"] if s["count"] else 0.0
+
+
+def show(dev, with_hist, save):
+    body = command(dev, SCAN_PROF_INFO)
+    stages, buckets = body[0], body[1]
+    (uptime_ms,) = struct.unpack_from("<I", body, 2)
+    result = {}
+    print(f"{'stage':<9} {'count':>9} {'min':>6} {'avg':>8} {'max':>6}   (us)")
+    for i in range(stages):
+        s = read(dev, i, buckets)
+        name = STAGES[i] if i < len(STAGES) else f"stage{i}"
+        result[name] = s
+        if s["count"] == 0:
+            print(f"{name:<9} {0:>9}")
+            continue
+        print(f"{name:<9} {s['count']:>9} {s['min']:>6} {avg(s):>8.1f} {s['max']:>6}")
+        if with_hist:
+            for b, n in enumerate(s["hist"]):
+                if n:
+                    print(f"    {bucket_label(b, buckets):>9} {n:>9} ({100 * n / s['count']:.2f}%)")
+    print(f"[i] 集計時間 {uptime_ms / 1000:.1f} 秒")
+    if save:
+        with open(save, "w") as f:
+            json.dump({"uptime_ms": uptime_ms, "stages": result}, f, indent=1)
+        print(f"[i] {save} に保存しました")
+
+
+def compare(path_a, path_b):
+    with open(path_a) as f:
+        a = json.load(f)["stages"]
+    with open(path_b) as f:
+        b = json.load(f)["stages"]
+    print(f"{'stage':<9} {'avg A':>8} {'avg B':>8} {'max A':>6} {'max B':>6}   (us)")
+    for name in STAGES:
+        if name not in a or name not in b or not (a[name]["count"] and b[name]["count"]):
+            continue
+        sa, sb = a[name], b[name]
+        print(f"{name:<9} {avg(sa):>8.1f} {avg(sb):>8.1f} {sa['max']:>6} {sb['max']:>6}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("action", choices=["reset", "show", "compare"])
+    ap.add_argument("files", nargs="*", help="compare: show --save で保存した 2 つのファイル")
+    ap.add_argument("--hist", action="store_true", help="show: ヒストグラムも表示")
+    ap.add_argument("--save", metavar="FILE", help="show: 結果を JSON で保存")
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+
+    if args.action == "compare":
+        if len(args.files) != 2:
+            ap.error("compare には 2 つのファイルが必要")
+        compare(*args.files)
+        return
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        if args.action == "reset":
+            command(dev, SCAN_PROF_RESET)
+            print("[i] 集計をクリアしました")
+        else:
+            show(dev, args.hist, args.save)
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    main()
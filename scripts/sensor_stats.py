@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由で左右のセンサのサンプリング統計を取得する。
+
+  python3 scripts/sensor_stats.py          # 1 秒間の差分からレートを計算
+  python3 scripts/sensor_stats.py -t 5     # 5 秒間
+
+列:
+  target    設定されたサンプリングレート（PAW3222_SAMPLE_INTERVAL_US）
+  sample/s  実際にサンプリングできたレート
+  report/s  ポインティングタスクへ渡したレポートのレート
+  late      呼び出しが遅れて飛ばしたサンプリング枠
+  saturated X/Y が int8 の上限に張り付いた読み出し（動きを取りこぼした可能性）
+  state     センサの状態（reset / boot / ready / offline）と最後に読んだ PID
+  inits     初期化に成功した回数（起動時を含む）
+  lost      動作中に抜けた、またはリセットされていて再初期化した回数
+
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import struct
+import time
+
+import vial_rawhid
+from vial_rawhid import open_device
+
+TB_SENSOR_STATS = 0x01
+
+STATS = struct.Struct("<HIIIIIBBHH")  # interval_us, ticks, late, saturated, reports, now_ms, state, pid, inits, lost
+STATES = ("reset", "boot", "ready", "offline")  # paw3222_state_t
+
+
+def read(dev, side):
+    body = vial_rawhid.command(dev, vial_rawhid.CMD_SENSOR, TB_SENSOR_STATS, bytes([side]), "センサ統計対応のファームウェア")
+    interval_us, ticks, late, saturated, reports, now_ms, state, pid, inits, lost = STATS.unpack_from(body, 2)
+    return dict(interval_us=interval_us, ticks=ticks, late=late, saturated=saturated, reports=reports, now_ms=now_ms,
+                state=STATES[state] if state < len(STATES) else str(state), pid=pid, inits=inits, lost=lost)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("-t", "--time", type=float, default=1.0, help="計測時間（秒）")
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        before = [read(dev, side) for side in (0, 1)]
+        time.sleep(args.time)
+        after = [read(dev, side) for side in (0, 1)]
+    finally:
+        dev.close()
+
+    print(f"{'side':<6} {'target':>8} {'sample/s':>9} {'report/s':>9} {'late':>8} {'saturated':>9} "
+          f"{'state':>12} {'inits':>6} {'lost':>5}")
+    for name, a, b in zip(("left", "right"), before, after):
+        secs = max(b["now_ms"] - a["now_ms"], 1) / 1000
+        target = 1e6 / b["interval_us"]
+        state = f"{b['state']}/{b['pid']:02X}"
+        print(f"{name:<6} {target:>8.0f} {(b['ticks'] - a['ticks']) / secs:>9.0f} "
+              f"{(b['reports'] - a['reports']) / secs:>9.0f} {b['late'] - a['late']:>8} "
+              f"{b['saturated'] - a['saturated']:>9} {state:>12} {b['inits']:>6} {b['lost']:>5}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# スプリットのシミュレータをホスト向けにビルドする。
+# keymaps/vial の keymap.c / tb*.c / layer_cache.c / combo_index.c とキーボードの
+# paw3222.c（モックのバス）/ debounce_eager.c をそのまま 1 台ぶんの共有ライブラリにし、
+# split_sim が左右 2 つ読み込む。-wrap は rules.mk と同じで、host/ の QMK 本体の代替は
+# -wrap が効く境界が実機と同じになるよう QMK と同じ単位で分けてある。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+QMK_HOST="$REPO_ROOT/scripts/qmk_host" # keymap.c 用の共通の代替ヘッダとコンボの動作モデル
+CC=${CC:-cc}
+
+# config.h は QMK と同じく全ファイルに適用する。MCU_RP で timer_us.h は host/hardware/timer.h を使う
+CFLAGS=(-O2 -Wall -std=gnu11
+  -include "$KEYMAP_DIR/config.h" -DQMK_KEYBOARD_H='"split_ortho4x6.h"'
+  -DMCU_RP -DMOUSEKEY_ENABLE -DLAYER_CACHE_ENABLE
+  -I"$HERE/host" -I"$QMK_HOST" -I"$KEYMAP_DIR" -I"$KEYBOARD_DIR")
+
+"$CC" "${CFLAGS[@]}" -fPIC -shared -Wl,-Bsymbolic \
+  "$HERE/host/qmk_core.c" "$HERE/host/qmk_action.c" "$HERE/host/qmk_action_layer.c" "$HERE/host/qmk_keymap.c" "$QMK_HOST/process_combo.c" \
+  "$KEYMAP_DIR/keymap.c" "$KEYMAP_DIR/tb.c" "$KEYMAP_DIR/tb_xform.c" "$KEYMAP_DIR/tb_split.c" \
+  "$KEYMAP_DIR/layer_cache.c" "$KEYMAP_DIR/combo_index.c" \
+  "$KEYBOARD_DIR/paw3222.c" "$KEYBOARD_DIR/paw3222_bus_mock.c" "$KEYBOARD_DIR/debounce_eager.c" \
+  -Wl,-wrap=action_for_key \
+  -Wl,-wrap=dynamic_keymap_set_keycode -Wl,-wrap=dynamic_keymap_set_buffer \
+  -Wl,-wrap=process_combo -Wl,-wrap=dynamic_keymap_set_combo -Wl,-wrap=dynamic_keymap_reset \
+  -Wl,-wrap=tb_task_combined \
+  -lm -o "$HERE/split_sim_fw.so"
+
+"$CC" "${CFLAGS[@]}" "$HERE/split_sim.c" -ldl -lm -o "$HERE/split_sim"
+
+echo "[i] ビルド完了: $HERE/split_sim"
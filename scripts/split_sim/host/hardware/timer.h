@@ -0,0 +1,6 @@
+// scripts/split_sim/host/hardware/timer.h
+// pico-sdk の代替。timer_us.h（MCU_RP）から使う。時刻はシミュレータが進める
+#pragma once
+#include <stdint.h>
+
+uint32_t time_us_32(void);
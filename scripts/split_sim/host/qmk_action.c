@@ -0,0 +1,210 @@
+// scripts/split_sim/host/qmk_action.c
+// QMK の action.c / action_tapping.c のうち、このキーマップで使う部分の代替:
+//   - LT() / MT() のタップ/ホールド（TAPPING_TERM、判定待ちの間の他のキーは待たせる）
+//   - 押した時のレイヤで離す（action_layer.c の source layer cache）
+//   - コンボ（qmk_host/process_combo.c）→ process_record_user() → レポート
+// 出したレポートには、どのキーイベントが原因かを付けてシミュレータに渡す。
+
+#include <string.h>
+#include "quantum.h"
+#include "sim_fw.h"
+
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200
+#endif
+#define TAPPING_QUEUE_SIZE 16
+
+bool process_record_user(uint16_t keycode, keyrecord_t* record);
+
+// ====== Reports ==================================================
+static sim_kb_report_t g_report;
+static uint8_t         g_mod_refs[8]; // 同じ修飾を複数のキーが押している時のため
+static uint8_t         g_buttons;
+static sim_cause_t     g_cause; // 処理中のイベント
+
+static void mods_update(uint8_t mods, bool pressed) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (!(mods & (1 << i))) continue;
+        if (pressed) {
+            g_mod_refs[i]++;
+        } else if (g_mod_refs[i]) {
+            g_mod_refs[i]--;
+        }
+        if (g_mod_refs[i]) {
+            g_report.mods |= 1 << i;
+        } else {
+            g_report.mods &= ~(1 << i);
+        }
+    }
+}
+
+// keycode の 5 ビットの修飾（bit4 = 右手側）を HID の 8 ビットに
+static uint8_t mod_config_to_hid(uint8_t m) { return m & 0x10 ? (uint8_t)((m & 0x0F) << 4) : (m & 0x0F); }
+
+static void key_update(uint8_t code, bool pressed) {
+    if (pressed) {
+        g_report.keys[code >> 3] |= 1 << (code & 7);
+    } else {
+        g_report.keys[code >> 3] &= ~(1 << (code & 7));
+    }
+}
+
+static void send_keyboard_report(void) {
+    static sim_kb_report_t sent;
+    if (memcmp(&sent, &g_report, sizeof(sent)) == 0) return;
+    sent = g_report;
+    sim_send_keyboard(&g_report, &g_cause);
+}
+
+// register_code16() / unregister_code16()
+static void process_keycode(uint16_t keycode, keyrecord_t* record) {
+    if (!process_record_user(keycode, record)) return;
+
+    bool pressed = record->event.pressed;
+    switch (keycode) {
+        case KC_A ... 0x00A4: // キーボードのページ（メディアキーなどは扱わない）
+            key_update(keycode, pressed);
+            break;
+        case KC_MS_BTN1 ... KC_MS_BTN8: // MOUSEKEY_ENABLE
+            if (pressed) {
+                g_buttons |= 1 << (keycode - KC_MS_BTN1);
+            } else {
+                g_buttons &= ~(1 << (keycode - KC_MS_BTN1));
+            }
+            sim_set_buttons(g_buttons, &g_cause);
+            return;
+        case KC_LEFT_CTRL ... KC_RIGHT_GUI:
+            mods_update(1 << (keycode - KC_LEFT_CTRL), pressed);
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            mods_update(mod_config_to_hid((keycode >> 8) & 0x1F), pressed);
+            if ((keycode & 0xFF) >= KC_A) key_update(keycode & 0xFF, pressed);
+            break;
+        default:
+            return;
+    }
+    send_keyboard_report();
+}
+
+// ====== Combos ===================================================
+// qmk_host/process_combo.c の出力（保留していたキーとコンボのキーコード）
+void combo_host_emit(uint16_t keycode, keypos_t key, bool pressed) {
+    sim_cause_t saved = g_cause;
+    g_cause           = (sim_cause_t){SIM_CAUSE_COMBO, key, pressed};
+    keyrecord_t rec   = {.event = {.key = key, .pressed = pressed, .time = timer_read()}};
+    process_keycode(keycode, &rec);
+    g_cause = saved;
+}
+
+static void process_record(uint16_t keycode, keypos_t key, bool pressed, uint8_t kind) {
+    g_cause         = (sim_cause_t){kind, key, pressed};
+    keyrecord_t rec = {.event = {.key = key, .pressed = pressed, .time = timer_read()}};
+    if (!process_combo(keycode, &rec)) return;
+    process_keycode(keycode, &rec);
+}
+
+// ====== Tap / hold ===============================================
+static bool is_tap_hold(uint16_t keycode) { return keycode >= QK_MOD_TAP && keycode <= QK_LAYER_TAP_MAX; }
+
+static struct {
+    bool     active; // 判定待ち
+    keypos_t key;
+    uint16_t keycode;
+    uint16_t since;
+} g_tap;
+
+static struct {
+    keypos_t key;
+    bool     pressed;
+} g_queue[TAPPING_QUEUE_SIZE];
+static uint8_t g_queue_n;
+
+static uint8_t  g_src_layer[MATRIX_ROWS][MATRIX_COLS]; // 押した時のレイヤ
+static uint16_t g_held[MATRIX_ROWS][MATRIX_COLS];      // ホールドとして効いている LT()/MT()
+
+static bool same_key(keypos_t a, keypos_t b) { return a.row == b.row && a.col == b.col; }
+
+static void hold_update(uint16_t keycode, keypos_t key, bool pressed) {
+    if (keycode >= QK_LAYER_TAP) {
+        uint8_t layer = (keycode >> 8) & 0x0F;
+        if (pressed) {
+            layer_state |= (layer_state_t)1 << layer;
+        } else {
+            layer_state &= ~((layer_state_t)1 << layer);
+        }
+        return;
+    }
+    mods_update(mod_config_to_hid((keycode >> 8) & 0x1F), pressed);
+    send_keyboard_report();
+}
+
+static void process_event(keypos_t key, bool pressed, uint8_t kind) {
+    uint16_t* held = &g_held[key.row][key.col];
+    if (!pressed && *held) {
+        g_cause = (sim_cause_t){kind, key, pressed};
+        hold_update(*held, key, false);
+        *held = 0;
+        return;
+    }
+    if (pressed) g_src_layer[key.row][key.col] = layer_switch_get_layer(key);
+    uint16_t keycode = keymap_key_to_keycode(g_src_layer[key.row][key.col], key);
+    if (pressed && is_tap_hold(keycode)) {
+        g_tap = (typeof(g_tap)){true, key, keycode, timer_read()};
+        return;
+    }
+    if (!pressed && is_tap_hold(keycode)) return; // 判定済み（ここには来ない）
+    process_record(keycode, key, pressed, kind);
+}
+
+// 判定待ちのキーが TAPPING_TERM 内に離された: タップとして押して離す
+static void tap_release(uint8_t kind) {
+    uint16_t tap = g_tap.keycode & 0xFF;
+    g_tap.active = false;
+    process_record(tap, g_tap.key, true, kind);
+    process_record(tap, g_tap.key, false, kind);
+}
+
+// 待たせていたイベントを順に流す。途中で新しい判定待ちが始まったら、その離しが
+// 既に来ているかを探し、来ていなければ残りは待たせたまま
+static void flush_queue(void) {
+    while (g_queue_n) {
+        if (g_tap.active) {
+            uint8_t i = 0;
+            while (i < g_queue_n && (g_queue[i].pressed || !same_key(g_queue[i].key, g_tap.key))) i++;
+            if (i == g_queue_n) return;
+            memmove(&g_queue[i], &g_queue[i + 1], (g_queue_n - i - 1) * sizeof(g_queue[0]));
+            g_queue_n--;
+            tap_release(SIM_CAUSE_QUEUED);
+            continue;
+        }
+        keypos_t key     = g_queue[0].key;
+        bool     pressed = g_queue[0].pressed;
+        memmove(&g_queue[0], &g_queue[1], (g_queue_n - 1) * sizeof(g_queue[0]));
+        g_queue_n--;
+        process_event(key, pressed, SIM_CAUSE_QUEUED);
+    }
+}
+
+void action_exec(keypos_t key, bool pressed) {
+    if (!g_tap.active) {
+        process_event(key, pressed, SIM_CAUSE_KEY);
+        return;
+    }
+    if (!pressed && same_key(key, g_tap.key)) {
+        tap_release(SIM_CAUSE_TAP);
+    } else if (g_queue_n < TAPPING_QUEUE_SIZE) {
+        g_queue[g_queue_n++] = (typeof(g_queue[0])){key, pressed};
+        return;
+    }
+    flush_queue();
+}
+
+// TAPPING_TERM を過ぎた判定待ちはホールド
+void action_task(void) {
+    if (!g_tap.active || (uint16_t)(timer_read() - g_tap.since) < TAPPING_TERM) return;
+    g_tap.active                         = false;
+    g_held[g_tap.key.row][g_tap.key.col] = g_tap.keycode;
+    g_cause                              = (sim_cause_t){SIM_CAUSE_TAP, g_tap.key, true};
+    hold_update(g_tap.keycode, g_tap.key, true);
+    flush_queue();
+}
@@ -0,0 +1,18 @@
+// scripts/split_sim/host/qmk_action_layer.c
+// QMK 本体の action_layer.c のうち、レイヤの解決の代替。action_for_key() は
+// qmk_keymap.c（keymap_common.c）にあり、実機と同じく別のオブジェクトからの
+// 呼び出しになるので layer_cache.c の -wrap を通る。
+
+#include "quantum.h"
+
+layer_state_t layer_state;
+layer_state_t default_layer_state = 1;
+
+// action_layer.c と同じ（透過キーだけを飛ばす）
+uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && action_for_key(i, key).code != ACTION_TRANSPARENT) return i;
+    }
+    return get_highest_layer(default_layer_state);
+}
@@ -0,0 +1,375 @@
+// scripts/split_sim/host/qmk_core.c
+// QMK 本体のうち、片手ぶんのメインループ（keyboard_task → housekeeping_task）と
+// スプリット転送（split_common/transactions.c）の代替。キー処理は qmk_action.c、
+// キーマップは qmk_keymap.c。-wrap を効かせるため、包まれる関数の定義と呼び出しは
+// 別のオブジェクトに分けてある。
+
+#include <string.h>
+#include "quantum.h"
+#include "gpio.h"
+#include "crc.h"
+#include "debounce.h"
+#include "transactions.h"
+#include "hardware/timer.h"
+#include "paw3222.h"
+#include "paw3222_bus_mock.h"
+#include "tb.h"
+#include "tb_split.h"
+#include "sim_fw.h"
+
+// quantum/split_common の既定値
+#define FORCED_SYNC_THROTTLE_MS 100
+#define SPLIT_MAX_CONNECTION_ERRORS 10
+#define SPLIT_CONNECTION_CHECK_TIMEOUT 500
+
+// keymap.c
+void           keyboard_post_init_user(void);
+bool           process_record_user(uint16_t keycode, keyrecord_t* record);
+report_mouse_t pointing_device_task_user(report_mouse_t mouse_report);
+void           housekeeping_task_user(void);
+
+// POINTING_DEVICE_DRIVER = custom（paw3222.c）
+void           pointing_device_driver_init(void);
+report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report);
+uint16_t       pointing_device_driver_get_cpi(void);
+void           pointing_device_driver_set_cpi(uint16_t cpi);
+
+// qmk_host/process_combo.c
+void combo_task(void);
+
+const sim_host_t* sim_host;
+
+static bool g_left, g_master;
+
+// ====== Clock ====================================================
+// シミュレータが渡す µs の仮想時刻。リンク待ちの分だけループの途中でも進む
+static uint32_t g_now_us;
+
+uint32_t     time_us_32(void) { return g_now_us; }
+uint32_t     timer_read32(void) { return g_now_us / 1000; }
+uint16_t     timer_read(void) { return (uint16_t)timer_read32(); }
+uint32_t     timer_elapsed32(uint32_t last) { return timer_read32() - last; }
+fast_timer_t timer_read_fast(void) { return timer_read32(); }
+
+// ====== Platform stand-ins =======================================
+void gpio_set_pin_output(pin_t pin) {}
+void gpio_set_pin_input_high(pin_t pin) {}
+void gpio_write_pin_high(pin_t pin) {}
+void gpio_write_pin_low(pin_t pin) {}
+bool gpio_read_pin(pin_t pin) { return true; }
+void palEnableLineEvent(pin_t line, uint32_t mode) {}
+void palSetLineCallback(pin_t line, palcallback_t cb, void* arg) {}
+
+bool is_keyboard_left(void) { return g_left; }
+bool is_keyboard_master(void) { return g_master; }
+
+// EEPROM は毎回消去した状態から始める（tb.c は既定値を読み込む）
+static uint32_t g_ee_kb;
+static uint8_t  g_ee_block[EECONFIG_KB_DATA_SIZE];
+
+uint32_t eeconfig_read_kb(void) { return g_ee_kb; }
+void     eeconfig_update_kb(uint32_t val) { g_ee_kb = val; }
+
+uint32_t eeconfig_read_kb_datablock(void* data, uint32_t offset, uint32_t length) {
+    if (offset + length > sizeof(g_ee_block)) return 0;
+    memcpy(data, g_ee_block + offset, length);
+    return length;
+}
+
+uint32_t eeconfig_update_kb_datablock(const void* data, uint32_t offset, uint32_t length) {
+    if (offset + length > sizeof(g_ee_block)) return 0;
+    memcpy(g_ee_block + offset, data, length);
+    return length;
+}
+
+// QMK の crc8（多項式 0x31、初期値 0xFF）
+uint8_t crc8(const void* data, size_t data_len) {
+    const uint8_t* p   = data;
+    uint8_t        crc = 0xFF;
+    for (size_t i = 0; i < data_len; i++) {
+        crc ^= p[i];
+        for (uint8_t b = 0; b < 8; b++) crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x31 : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+void     pointing_device_set_cpi(uint16_t cpi) { pointing_device_driver_set_cpi(cpi); }
+uint16_t pointing_device_get_cpi(void) { return pointing_device_driver_get_cpi(); }
+uint16_t pointing_device_get_hires_scroll_resolution(void) { return 120; } // POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+
+// ====== Split transport ==========================================
+// トランザクション表の大きさ（ワイヤ上のバイト数）。RPC はペイロードの長さに
+// 関係なくバッファ全体を送る
+typedef struct __attribute__((packed)) {
+    struct __attribute__((packed)) {
+        int8_t  transaction_id;
+        uint8_t m2s_length;
+        uint8_t s2m_length;
+    } payload;
+    uint8_t checksum;
+} rpc_sync_info_t;
+
+static const struct {
+    uint8_t m2s, s2m;
+} k_trans_size[NUM_TOTAL_TRANSACTIONS] = {
+    [GET_SLAVE_MATRIX_CHECKSUM] = {0, 1},
+    [GET_SLAVE_MATRIX_DATA]     = {0, ROWS_PER_HAND * sizeof(matrix_row_t)},
+    [PUT_RPC_INFO]              = {sizeof(rpc_sync_info_t), 0},
+    [PUT_RPC_REQ_DATA]          = {RPC_M2S_BUFFER_SIZE, 0},
+    [EXECUTE_RPC]               = {1, 0}, // rpc_info.payload.transaction_id
+    [GET_RPC_RESP_DATA]         = {0, RPC_S2M_BUFFER_SIZE},
+};
+
+#define TRANS_MAX RPC_M2S_BUFFER_SIZE
+
+// split_shmem。マスタは受信側、スレーブは送信側として使う
+static struct {
+    matrix_row_t    smatrix[ROWS_PER_HAND];
+    rpc_sync_info_t rpc_info;
+    uint8_t         rpc_m2s[RPC_M2S_BUFFER_SIZE];
+    uint8_t         rpc_s2m[RPC_S2M_BUFFER_SIZE];
+} g_shmem;
+
+static slave_callback_t g_rpc[NUM_TOTAL_TRANSACTIONS];
+static uint8_t          g_connection_errors;
+
+static bool transport_exec(uint8_t id, const void* m2s_data, uint8_t m2s_len, void* s2m_data, uint8_t s2m_len) {
+    uint8_t  m2s[TRANS_MAX] = {0}, s2m[TRANS_MAX] = {0};
+    uint32_t cost_us        = 0;
+    if (m2s_data) memcpy(m2s, m2s_data, m2s_len);
+    bool ok = sim_host->transaction(id, g_now_us, m2s, k_trans_size[id].m2s, s2m, k_trans_size[id].s2m, &cost_us);
+    g_now_us += cost_us;
+    if (ok && s2m_data) memcpy(s2m_data, s2m, s2m_len);
+    return ok;
+}
+
+bool is_transport_connected(void) { return g_connection_errors <= SPLIT_MAX_CONNECTION_ERRORS; }
+
+// transactions.c の read_if_checksum_mismatch() / slave_matrix_handlers_master()
+static bool slave_matrix_handlers_master(matrix_row_t slave_matrix[]) {
+    static uint32_t     last_update;
+    static matrix_row_t last_matrix[ROWS_PER_HAND];
+
+    uint8_t curr_checksum;
+    bool    okay = transport_exec(GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &curr_checksum, sizeof(curr_checksum));
+    if (okay && (timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS ||
+                 curr_checksum != crc8(g_shmem.smatrix, sizeof(g_shmem.smatrix)))) {
+        okay &= transport_exec(GET_SLAVE_MATRIX_DATA, NULL, 0, g_shmem.smatrix, sizeof(g_shmem.smatrix));
+        okay &= curr_checksum == crc8(g_shmem.smatrix, sizeof(g_shmem.smatrix));
+        if (okay) last_update = timer_read32();
+    }
+    if (okay) memcpy(last_matrix, g_shmem.smatrix, sizeof(last_matrix));
+    memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+    return okay;
+}
+
+// split_util.c の transport_master_if_connected()
+static bool transport_master_if_connected(matrix_row_t slave_matrix[]) {
+    static uint16_t connection_check_timer;
+    if (!is_transport_connected() && (uint16_t)(timer_read() - connection_check_timer) < SPLIT_CONNECTION_CHECK_TIMEOUT) {
+        return false;
+    }
+    if (!slave_matrix_handlers_master(slave_matrix)) {
+        if (g_connection_errors < UINT8_MAX) g_connection_errors++;
+        bool connected = is_transport_connected();
+        if (!connected) connection_check_timer = timer_read();
+        return connected;
+    }
+    g_connection_errors = 0;
+    return true;
+}
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback) {
+    if (transaction_id >= 0 && transaction_id < NUM_TOTAL_TRANSACTIONS) g_rpc[transaction_id] = callback;
+}
+
+bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void* initiator2target_buffer,
+                          uint8_t target2initiator_buffer_size, void* target2initiator_buffer) {
+    if (!is_transport_connected()) return false;
+    if (initiator2target_buffer_size > RPC_M2S_BUFFER_SIZE || target2initiator_buffer_size > RPC_S2M_BUFFER_SIZE) return false;
+
+    rpc_sync_info_t info = {.payload = {transaction_id, initiator2target_buffer_size, target2initiator_buffer_size}};
+    info.checksum        = crc8(&info.payload, sizeof(info.payload));
+    if (!transport_exec(PUT_RPC_INFO, &info, sizeof(info), NULL, 0)) return false;
+    if (initiator2target_buffer_size > 0 &&
+        !transport_exec(PUT_RPC_REQ_DATA, initiator2target_buffer, initiator2target_buffer_size, NULL, 0)) {
+        return false;
+    }
+    if (!transport_exec(EXECUTE_RPC, &info.payload.transaction_id, 1, NULL, 0)) return false;
+    if (target2initiator_buffer_size > 0 &&
+        !transport_exec(GET_RPC_RESP_DATA, NULL, 0, target2initiator_buffer, target2initiator_buffer_size)) {
+        return false;
+    }
+    return true;
+}
+
+// スレーブ側（QMK では転送の割り込みの中）
+static void slave_rpc_exec(void) {
+    if (g_shmem.rpc_info.checksum != crc8(&g_shmem.rpc_info.payload, sizeof(g_shmem.rpc_info.payload))) return;
+    int8_t id = g_shmem.rpc_info.payload.transaction_id;
+    if (id >= 0 && id < NUM_TOTAL_TRANSACTIONS && g_rpc[id]) {
+        g_rpc[id](g_shmem.rpc_info.payload.m2s_length, g_shmem.rpc_m2s, g_shmem.rpc_info.payload.s2m_length, g_shmem.rpc_s2m);
+    }
+}
+
+static void sim_target_transaction(uint8_t id, const uint8_t* m2s, uint8_t* s2m) {
+    switch (id) {
+        case GET_SLAVE_MATRIX_CHECKSUM:
+            s2m[0] = crc8(g_shmem.smatrix, sizeof(g_shmem.smatrix));
+            break;
+        case GET_SLAVE_MATRIX_DATA:
+            memcpy(s2m, g_shmem.smatrix, sizeof(g_shmem.smatrix));
+            break;
+        case PUT_RPC_INFO:
+            memcpy(&g_shmem.rpc_info, m2s, sizeof(g_shmem.rpc_info));
+            break;
+        case PUT_RPC_REQ_DATA:
+            memcpy(g_shmem.rpc_m2s, m2s, sizeof(g_shmem.rpc_m2s));
+            break;
+        case EXECUTE_RPC:
+            g_shmem.rpc_info.payload.transaction_id = (int8_t)m2s[0];
+            slave_rpc_exec();
+            break;
+        case GET_RPC_RESP_DATA:
+            memcpy(s2m, g_shmem.rpc_s2m, sizeof(g_shmem.rpc_s2m));
+            break;
+    }
+}
+
+// ====== Matrix ===================================================
+static matrix_row_t g_contacts[ROWS_PER_HAND]; // 接点の状態（シミュレータが設定）
+static matrix_row_t g_raw[ROWS_PER_HAND];
+matrix_row_t        matrix[MATRIX_ROWS]; // デバウンス後、右手は ROWS_PER_HAND から（matrix_common.c と同じく公開）
+static matrix_row_t g_matrix_prev[MATRIX_ROWS];
+static bool         g_last_connected;
+
+matrix_row_t matrix_get_row(uint8_t row) { return matrix[row]; }
+
+// split_common/matrix.c の matrix_scan() と keyboard.c の matrix_task()
+static void matrix_task(void) {
+    uint8_t this_hand = g_left ? 0 : ROWS_PER_HAND;
+    uint8_t that_hand = ROWS_PER_HAND - this_hand;
+
+    bool changed = memcmp(g_raw, g_contacts, sizeof(g_raw)) != 0;
+    memcpy(g_raw, g_contacts, sizeof(g_raw));
+    debounce(g_raw, matrix + this_hand, ROWS_PER_HAND, changed);
+
+    if (!g_master) {
+        memcpy(g_shmem.smatrix, matrix + this_hand, sizeof(g_shmem.smatrix)); // transport_slave()
+        return;
+    }
+    matrix_row_t slave_matrix[ROWS_PER_HAND] = {0};
+    if (transport_master_if_connected(slave_matrix)) {
+        memcpy(matrix + that_hand, slave_matrix, sizeof(slave_matrix));
+        g_last_connected = true;
+    } else if (g_last_connected) {
+        // 切断されたら相手側は全部離したことにする
+        memset(matrix + that_hand, 0, sizeof(slave_matrix));
+        g_last_connected = false;
+    }
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t diff = matrix[r] ^ g_matrix_prev[r];
+        for (uint8_t c = 0; c < MATRIX_COLS && diff; c++) {
+            matrix_row_t bit = (matrix_row_t)1 << c;
+            if (!(diff & bit)) continue;
+            diff &= ~bit;
+            g_matrix_prev[r] ^= bit;
+            action_exec((keypos_t){.col = c, .row = r}, (matrix[r] & bit) != 0);
+        }
+    }
+}
+
+// ====== Reports ==================================================
+static uint8_t        g_buttons;
+static report_mouse_t g_mouse_sent;
+
+void sim_send_keyboard(const sim_kb_report_t* report, const sim_cause_t* cause) {
+    g_now_us += sim_host->keyboard_report(g_now_us, report, cause);
+}
+
+static void mouse_send(report_mouse_t* r, const sim_cause_t* cause) {
+    g_now_us += sim_host->mouse_report(g_now_us, r, cause);
+    g_mouse_sent = *r;
+}
+
+void sim_set_buttons(uint8_t buttons, const sim_cause_t* cause) {
+    if (buttons == g_buttons) return;
+    g_buttons        = buttons;
+    report_mouse_t r = {.buttons = buttons};
+    mouse_send(&r, cause);
+}
+
+// pointing_device.c の pointing_device_task()（スロットルなし）
+static void pointing_device_task(void) {
+    report_mouse_t r = pointing_device_driver_get_report((report_mouse_t){0});
+    r                = pointing_device_task_user(r);
+    if (!g_master) return;
+
+    r.buttons = g_buttons;
+    if (r.x || r.y || r.h || r.v || r.buttons != g_mouse_sent.buttons) {
+        mouse_send(&r, &(sim_cause_t){SIM_CAUSE_NONE});
+    }
+}
+
+// tb_split.c → tb.c。左右それぞれの到着をシミュレータに知らせる
+report_mouse_t __real_tb_task_combined(report_mouse_t left, report_mouse_t right, uint32_t dt_us);
+report_mouse_t __wrap_tb_task_combined(report_mouse_t left, report_mouse_t right, uint32_t dt_us) {
+    if (left.x || left.y || right.x || right.y) sim_host->pointing_input(g_now_us, left, right);
+    return __real_tb_task_combined(left, right, dt_us);
+}
+
+// ====== Firmware interface =======================================
+static void sim_init(const sim_host_t* host, bool left, bool master, uint32_t now_us) {
+    sim_host = host;
+    g_left   = left;
+    g_master = master;
+    g_now_us = now_us;
+
+    paw3222_mock_attach(0, PAW3222_CS_PIN);
+    paw3222_mock_reset();
+    dynamic_keymap_reset(); // EEPROM 初期化時と同じく keymap.c の既定値を書き込む
+    debounce_init(ROWS_PER_HAND);
+    pointing_device_driver_init();
+    keyboard_post_init_user();
+}
+
+static uint32_t sim_task(uint32_t now_us) {
+    g_now_us = now_us;
+    matrix_task();
+    if (g_master) {
+        action_task();
+        combo_task();
+    }
+    pointing_device_task();
+    housekeeping_task_user();
+    return g_now_us;
+}
+
+static void sim_set_key(uint8_t row, uint8_t col, bool closed) {
+    if (row >= ROWS_PER_HAND || col >= MATRIX_COLS) return;
+    if (closed) {
+        g_contacts[row] |= (matrix_row_t)1 << col;
+    } else {
+        g_contacts[row] &= ~((matrix_row_t)1 << col);
+    }
+}
+
+static void sim_move_ball(int16_t dx, int16_t dy) { paw3222_mock_move(dx, dy); }
+
+static void sim_tap_keycode(uint16_t keycode) {
+    keyrecord_t rec = {.event = {.key = {.col = 255, .row = 255}, .pressed = true, .time = timer_read()}};
+    process_record_user(keycode, &rec);
+    rec.event.pressed = false;
+    process_record_user(keycode, &rec);
+}
+
+const sim_fw_t sim_fw = {
+    .init               = sim_init,
+    .task               = sim_task,
+    .set_key            = sim_set_key,
+    .move_ball          = sim_move_ball,
+    .target_transaction = sim_target_transaction,
+    .tap_keycode        = sim_tap_keycode,
+    .split_stats        = tb_split_get_stats,
+};
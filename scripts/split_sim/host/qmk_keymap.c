@@ -0,0 +1,59 @@
+// scripts/split_sim/host/qmk_keymap.c
+// QMK 本体（keymap_common.c / dynamic_keymap.c）のうち、キーコード/アクションの解決と
+// 動的キーマップの代替。action_for_key() は layer_cache.c に包まれ（呼び出し元は
+// qmk_action_layer.c）、dynamic_keymap_reset() は keymap.c に包まれる。
+
+#include <string.h>
+#include "quantum.h"
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+
+keymap_config_t keymap_config;
+
+// ====== Dynamic keymap ===========================================
+// dynamic_keymap.c と同じく、1 キー 2 バイト（ビッグエンディアン）
+static uint8_t g_eeprom[LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2];
+
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+    const uint8_t* p = &g_eeprom[((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2];
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    uint8_t* p = &g_eeprom[((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2];
+    p[0]       = keycode >> 8;
+    p[1]       = keycode & 0xFF;
+}
+
+void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {
+    if (offset + size > sizeof(g_eeprom)) return;
+    memcpy(g_eeprom + offset, data, size);
+}
+
+// keymaps[] を書き込み、コンボなどは空にする（keymap.c の __wrap_ が既定値を入れる）
+void dynamic_keymap_reset(void) {
+    for (uint8_t l = 0; l < LAYER_COUNT; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            for (uint8_t c = 0; c < MATRIX_COLS; c++) dynamic_keymap_set_keycode(l, r, c, keymaps[l][r][c]);
+        }
+    }
+    for (uint8_t i = 0; i < VIAL_COMBO_ENTRIES; i++) dynamic_keymap_set_combo(i, &(vial_combo_entry_t){0});
+}
+
+int      dynamic_keymap_set_tap_dance(uint8_t index, const vial_tap_dance_entry_t* entry) { return 0; }
+int      dynamic_keymap_set_key_override(uint8_t index, const vial_key_override_entry_t* entry) { return 0; }
+uint16_t dynamic_keymap_macro_get_buffer_size(void) { return 0; }
+void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t* data) {}
+
+// ====== Keycode / action lookup ==================================
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (layer >= LAYER_COUNT) return KC_TRANSPARENT;
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) return dynamic_keymap_get_keycode(layer, key.row, key.col);
+    return KC_NO;
+}
+
+// 使うのはレイヤ解決の透過かどうかだけなので、アクションの中身はキーコードのまま
+action_t action_for_key(uint8_t layer, keypos_t key) {
+    uint16_t keycode = keymap_key_to_keycode(layer, key);
+    return (action_t){.code = keycode == KC_TRANSPARENT ? ACTION_TRANSPARENT : keycode};
+}
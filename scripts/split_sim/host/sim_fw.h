@@ -0,0 +1,70 @@
+// scripts/split_sim/host/sim_fw.h
+// split_sim.c（左右の結線とスクリプト）と、ファームウェア 1 台分の共有ライブラリ
+// （split_sim_fw.so）の境界。共有ライブラリは左右で別々に読み込み、静的変数を
+// 片手ずつ持たせる。時刻はどちらも µs で、シミュレータが各ループの開始時刻を渡す。
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantum.h"
+#include "tb_split.h"
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+// レポートを出すきっかけになったイベント（遅延をどの操作に付けるか）
+typedef enum {
+    SIM_CAUSE_NONE,   // トラックボール
+    SIM_CAUSE_KEY,    // キーイベントをそのまま処理した
+    SIM_CAUSE_TAP,    // LT() / MT() のタップかホールドが決まった
+    SIM_CAUSE_QUEUED, // タップ/ホールドの判定待ちの間、待たされていた
+    SIM_CAUSE_COMBO,  // コンボの保留から出た
+} sim_cause_kind_t;
+
+typedef struct {
+    uint8_t  kind;    // sim_cause_kind_t
+    keypos_t key;     // 全体のマトリクス位置（右手は ROWS_PER_HAND から）
+    bool     pressed;
+} sim_cause_t;
+
+typedef struct {
+    uint8_t mods;
+    uint8_t keys[32]; // NKRO のビット列
+} sim_kb_report_t;
+
+// ====== Simulator side ===========================================
+// マスタの共有ライブラリから呼ばれる
+typedef struct {
+    // マスタ→スレーブのトランザクション 1 回（id は transactions.h）。m2s/s2m の長さは
+    // トランザクション表の大きさ。失敗（タイムアウト）なら false。所要時間を *cost_us に返す
+    bool (*transaction)(uint8_t id, uint32_t now_us, uint8_t* m2s, uint8_t m2s_len, uint8_t* s2m, uint8_t s2m_len,
+                        uint32_t* cost_us);
+    // レポートを 1 つ送る。送信バッファが空くまで待たされた時間（µs）を返す
+    uint32_t (*keyboard_report)(uint32_t now_us, const sim_kb_report_t* report, const sim_cause_t* cause);
+    uint32_t (*mouse_report)(uint32_t now_us, const report_mouse_t* report, const sim_cause_t* cause);
+    // tb_task_combined() に入る左右のデルタ（センサ → 転送の到着）
+    void (*pointing_input)(uint32_t now_us, report_mouse_t left, report_mouse_t right);
+} sim_host_t;
+
+// ====== Firmware side ============================================
+// 共有ライブラリが sim_fw として公開する（dlsym で引く）
+typedef struct {
+    void (*init)(const sim_host_t* host, bool left, bool master, uint32_t now_us);
+    // メインループ 1 周。終わった時刻（リンクと USB の待ちを含み、CPU 時間は含まない）を返す
+    uint32_t (*task)(uint32_t now_us);
+    void (*set_key)(uint8_t row, uint8_t col, bool closed); // 片手のマトリクス位置
+    void (*move_ball)(int16_t dx, int16_t dy);
+    // スレーブ側でトランザクションを受ける（QMK では割り込みの中）
+    void (*target_transaction)(uint8_t id, const uint8_t* m2s, uint8_t* s2m);
+    // process_record_user() にキーコードを直接渡す（TB_SCR_TOG などの設定用）
+    void (*tap_keycode)(uint16_t keycode);
+    const tb_split_stats_t* (*split_stats)(void);
+} sim_fw_t;
+
+// ====== Inside the firmware library ==============================
+// qmk_core.c
+extern const sim_host_t* sim_host;
+void sim_send_keyboard(const sim_kb_report_t* report, const sim_cause_t* cause);
+void sim_set_buttons(uint8_t buttons, const sim_cause_t* cause); // マウスキーのボタン
+
+// qmk_action.c
+void action_exec(keypos_t key, bool pressed);
+void action_task(void); // タップ/ホールドの時間切れ
@@ -0,0 +1,668 @@
+// scripts/split_sim/split_sim.c
+// 左右 2 台ぶんのファームウェア（keymap.c / tb.c / tb_split.c / paw3222.c とセンサの
+// モック）を 1 プロセスで動かし、スプリットのシリアルリンク（遅延・ビット誤り）で
+// つないで、キーとトラックボールの入力から USB レポートまでの遅延分布を測る。
+//
+//   ./split_sim                         # 生成した操作 2000 打鍵ぶん
+//   ./split_sim -e 1e-5 -l 50           # ビット誤り率 1e-5、トランザクションごとに 50us 遅延
+//   ./split_sim -f ops.txt              # スクリプトを再生
+//   ./split_sim -n 500 -s 3 -o ops.txt  # 生成した操作を書き出す
+//   ./split_sim -R 30000000             # 30 s の時点でスレーブを再起動する
+//
+// スクリプトは 1 行 1 イベント（時刻は µs、行/列は片手のマトリクス位置 0..3 / 0..6）:
+//   <t_us> key L|R <row> <col> d|u
+//   <t_us> ball L|R <dx> <dy>
+//   # コメント
+// センサの起動に数 ms かかるので、最初のイベントは 100000 us 以降にすること。
+//
+// キーの遅延は押下/離しから、そのイベントが原因のレポート（キーボードかマウスボタン）が
+// USB でホストに届くまで。トラックボールは動き始め（BURST_GAP_US 止まっていた側の最初の
+// 移動）から最初の移動レポートが届くまでで、「到着」はマスタの tb_task_combined() に
+// 入るまで。p99 が -K / -B を超えたら、キーやボタンが押されたまま終わったら、左右の
+// カウントが tb_task_combined() までに増減したら終了コード 1。
+//
+// 既定では左のボールをカーソルにする（TB_SCR_TOG）。スクロールのまま測るなら -S
+// （スクロールは sc_div カウント溜まるまで出ないので、ボールの上限は別に指定すること）。
+// -e のデータビットの化けは、RPC の中身にはチェックサムがないので tb_split のフレームに
+// そのまま届き、ボールのカウントが合わなくなることがある。
+// -R はスレーブを読み込み直して起動からやり直す（リセットや電圧低下）。その時点で
+// スレーブに溜まっていたカウントは失われたものとして数え、センサが立ち上がるまで
+// （WARMUP_US）その側のボールは動かさない。以降のカウントは一致しなければならない。
+
+#include <dlfcn.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sim_fw.h"
+#include "tb.h"
+#include "transactions.h"
+
+#define SERIAL_USART_TIMEOUT_MS 20 // 失敗したトランザクションは応答待ちで終わる
+#define WARMUP_US 100000
+#define TAIL_US 500000      // 最後のイベントの後、タップの判定やリンクの再送が落ち着くまで
+#define BURST_GAP_US 50000  // これだけ止まっていたら次の移動を動き始めとする
+#define MAX_DURATION_US 4000000000u
+
+// ====== Options ==================================================
+static uint32_t g_baud       = 921600; // SERIAL_USART_SPEED
+static uint32_t g_latency_us = 0;
+static double   g_ber        = 0;
+static uint32_t g_cpu_us     = 100; // リンク待ちを除いたメインループ 1 周
+static uint32_t g_usb_us     = 1000; // USB のポーリング間隔
+// 既定の構成（p99 はキーの離し 7 ms = DEBOUNCE_RELEASE_MS + USB、ボール 5〜6 ms）に 1 ms の余裕
+static uint32_t g_key_limit  = 8000;
+static uint32_t g_ball_limit = 6000;
+static uint32_t g_restart_us = 0; // スレーブを再起動する時刻（0 = しない）
+
+// ====== Statistics ===============================================
+typedef struct {
+    const char* name;
+    uint32_t*   v;
+    uint32_t    n, cap;
+} series_t;
+
+// S_TAP まではゲート（-K）の対象。待たされたキーとコンボは保留の長さがそのまま出るので対象外
+enum {
+    S_KEY_L_UP, S_KEY_L_DOWN, S_KEY_R_UP, S_KEY_R_DOWN, S_TAP,
+    S_QUEUED, S_COMBO,
+    S_BALL_L, S_BALL_R, S_ARRIVE_L, S_ARRIVE_R,
+    NUM_SERIES
+};
+
+static series_t g_series[NUM_SERIES] = {
+    [S_KEY_L_UP] = {"key L release"}, [S_KEY_L_DOWN] = {"key L press"},   [S_KEY_R_UP] = {"key R release"},
+    [S_KEY_R_DOWN] = {"key R press"}, [S_TAP] = {"tap/hold"},             [S_QUEUED] = {"queued"},
+    [S_COMBO] = {"combo"},            [S_BALL_L] = {"ball L"},            [S_BALL_R] = {"ball R"},
+    [S_ARRIVE_L] = {"ball L arrive"}, [S_ARRIVE_R] = {"ball R arrive"},
+};
+
+static void add_sample(uint8_t s, uint32_t v) {
+    series_t* p = &g_series[s];
+    if (p->n == p->cap) {
+        p->cap = p->cap ? p->cap * 2 : 256;
+        p->v   = realloc(p->v, p->cap * sizeof(uint32_t));
+    }
+    p->v[p->n++] = v;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// p99 を返す（データなしは 0）
+static uint32_t report(series_t* s) {
+    if (s->n == 0) {
+        printf("%-13s  (no data)\n", s->name);
+        return 0;
+    }
+    qsort(s->v, s->n, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < s->n; i++) sum += s->v[i];
+    uint32_t p99 = s->v[(s->n * 99) / 100 < s->n ? (s->n * 99) / 100 : s->n - 1];
+    printf("%-13s  %6u  min %6u  p50 %6u  avg %8.1f  p99 %6u  max %6u us\n", s->name, s->n, s->v[0], s->v[s->n / 2],
+           (double)sum / s->n, p99, s->v[s->n - 1]);
+    return p99;
+}
+
+// ====== Operations ===============================================
+enum { EV_KEY, EV_BALL };
+
+typedef struct {
+    uint32_t t_us;
+    uint8_t  kind;
+    uint8_t  side; // 0 = 左, 1 = 右
+    uint8_t  row, col;
+    bool     down;
+    int16_t  dx, dy;
+    uint32_t seq; // 同時刻は生成/記述順
+} event_t;
+
+static event_t* g_ev;
+static uint32_t g_ev_n, g_ev_cap, g_ev_next;
+
+static void push_event(event_t e) {
+    if (g_ev_n == g_ev_cap) {
+        g_ev_cap = g_ev_cap ? g_ev_cap * 2 : 1024;
+        g_ev     = realloc(g_ev, g_ev_cap * sizeof(*g_ev));
+    }
+    e.seq          = g_ev_n;
+    g_ev[g_ev_n++] = e;
+}
+
+static int cmp_event(const void* a, const void* b) {
+    const event_t *x = a, *y = b;
+    if (x->t_us != y->t_us) return (x->t_us > y->t_us) - (x->t_us < y->t_us);
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static bool load_script(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    char     line[256];
+    uint32_t lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char* p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+
+        event_t e = {0};
+        char    kind[8], side, ud;
+        int     a, b;
+        if (sscanf(p, "%u %7s %c %d %d %c", &e.t_us, kind, &side, &a, &b, &ud) >= 5 && (side == 'L' || side == 'R')) {
+            e.side = side == 'R';
+            if (strcmp(kind, "key") == 0 && (ud == 'd' || ud == 'u') && a >= 0 && a < ROWS_PER_HAND && b >= 0 && b < MATRIX_COLS) {
+                e.kind = EV_KEY;
+                e.row  = a;
+                e.col  = b;
+                e.down = ud == 'd';
+                push_event(e);
+                continue;
+            }
+            if (strcmp(kind, "ball") == 0) {
+                e.kind = EV_BALL;
+                e.dx   = a;
+                e.dy   = b;
+                push_event(e);
+                continue;
+            }
+        }
+        fprintf(stderr, "[!] %s:%u: 読めない行: %s", path, lineno, line);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool save_script(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "# split_sim: <t_us> key L|R <row> <col> d|u / <t_us> ball L|R <dx> <dy>\n");
+    for (uint32_t i = 0; i < g_ev_n; i++) {
+        const event_t* e = &g_ev[i];
+        if (e->kind == EV_KEY) {
+            fprintf(f, "%u key %c %u %u %c\n", e->t_us, "LR"[e->side], e->row, e->col, e->down ? 'd' : 'u');
+        } else {
+            fprintf(f, "%u ball %c %d %d\n", e->t_us, "LR"[e->side], e->dx, e->dy);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static uint32_t rnd(uint32_t lo, uint32_t hi) { return lo + (uint32_t)rand() % (hi - lo + 1); }
+
+// 打鍵は TAPPING_TERM より短く押し、4 回に 1 回は前のキーを離す前に次を押す（LT()/MT() の
+// 判定待ちやコンボの保留に他のキーが重なる）。トラックボールは左右ばらばらに、
+// 5〜60 ms 動かしては 150〜800 ms 止める
+static void make_workload(const uint16_t (*keymap)[MATRIX_COLS], uint32_t strokes) {
+    struct {
+        uint8_t side, row, col;
+    } pos[MATRIX_ROWS * MATRIX_COLS];
+    uint32_t up_at[MATRIX_ROWS * MATRIX_COLS] = {0};
+    uint8_t  num_pos = 0;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            uint16_t kc = keymap[r][c];
+            if (kc == KC_NO || kc == QK_BOOT) continue;
+            pos[num_pos].side = r >= ROWS_PER_HAND;
+            pos[num_pos].row  = r % ROWS_PER_HAND;
+            pos[num_pos].col  = c;
+            num_pos++;
+        }
+    }
+
+    uint32_t t = WARMUP_US, end = t;
+    for (uint32_t i = 0; i < strokes; i++) {
+        uint8_t p;
+        do {
+            p = rand() % num_pos;
+        } while (up_at[p] >= t);
+        uint32_t hold = rnd(30, 150) * 1000;
+        push_event((event_t){t, EV_KEY, pos[p].side, pos[p].row, pos[p].col, true});
+        push_event((event_t){t + hold, EV_KEY, pos[p].side, pos[p].row, pos[p].col, false});
+        up_at[p] = t + hold;
+        if (up_at[p] > end) end = up_at[p];
+        t += (rand() % 4 == 0 ? rnd(10, 60) : rnd(80, 300)) * 1000;
+    }
+
+    for (uint8_t side = 0; side < 2; side++) {
+        for (uint32_t tb = WARMUP_US + rnd(0, 300) * 1000; tb < end;) {
+            uint32_t len = rnd(5, 60);
+            for (uint32_t k = 0; k < len; k++) {
+                int16_t dx = (int16_t)rnd(0, 12) - 6, dy = (int16_t)rnd(0, 12) - 6;
+                if (k == 0 && dx == 0 && dy == 0) dx = 1;
+                push_event((event_t){.t_us = tb + k * 1000, .kind = EV_BALL, .side = side, .dx = dx, .dy = dy});
+            }
+            tb += len * 1000 + rnd(150, 800) * 1000;
+        }
+    }
+}
+
+// ====== Firmware instances =======================================
+typedef struct {
+    const sim_fw_t* fw;
+    uint32_t        next_us; // 次のループの開始時刻
+    uint32_t        loops;
+} half_t;
+
+static half_t   g_half[2]; // [0] = 左, [1] = 右
+static uint8_t  g_master_side;
+static uint32_t g_mute_until[2]; // 再起動したスレーブのセンサが立ち上がるまで、ボールを動かさない
+
+// 同じ共有ライブラリを 2 回 dlopen() しても同じものが返るので、コピーを読み込む
+static const sim_fw_t* load_instance(const char* so, const uint16_t (**keymap)[MATRIX_COLS]) {
+    char  tmp[] = "/tmp/split_sim_fw_XXXXXX";
+    int   fd    = mkstemp(tmp);
+    FILE* in    = fopen(so, "rb");
+    if (fd < 0 || !in) {
+        fprintf(stderr, "[!] %s を読めない（build.sh でビルドしたか）\n", so);
+        return NULL;
+    }
+    char   buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        if (write(fd, buf, n) != (ssize_t)n) break;
+    }
+    fclose(in);
+    close(fd);
+    void* dl = dlopen(tmp, RTLD_NOW | RTLD_LOCAL);
+    unlink(tmp);
+    if (!dl) {
+        fprintf(stderr, "[!] %s\n", dlerror());
+        return NULL;
+    }
+    *keymap = dlsym(dl, "keymaps");
+    return dlsym(dl, "sim_fw");
+}
+
+// ====== Link =====================================================
+static struct {
+    uint32_t transactions;
+    uint64_t bytes;
+    uint32_t failures;  // フレーミングエラー/ヘッダ化け（タイムアウト）
+    uint32_t corrupted; // データビットだけが化けて届いた
+    uint32_t loop_max_us;
+    uint64_t loop_total_us;
+} g_link;
+
+static uint64_t g_rng = 0x9E3779B97F4A7C15ull;
+
+static double rnd_unit(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (g_rng >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// 1 バイト 10 ビット（スタート + 8 + ストップ）。スタート/ストップが化けたら
+// そのバイトは届かず false、データビットはそのまま化ける
+static bool wire(uint8_t* buf, uint8_t len) {
+    bool ok = true;
+    if (g_ber <= 0) return ok;
+    for (uint8_t i = 0; i < len; i++) {
+        for (uint8_t b = 0; b < 10; b++) {
+            if (rnd_unit() >= g_ber) continue;
+            if (b == 0 || b == 9) {
+                ok = false;
+            } else {
+                buf[i] ^= 1 << (b - 1);
+            }
+        }
+    }
+    return ok;
+}
+
+static void run_loop(uint8_t side);
+
+static void apply_events(uint32_t now_us);
+
+static bool link_transaction(uint8_t id, uint32_t now_us, uint8_t* m2s, uint8_t m2s_len, uint8_t* s2m, uint8_t s2m_len,
+                             uint32_t* cost_us) {
+    // スレーブはマスタの待ちと並行して動いている
+    half_t* slave = &g_half[!g_master_side];
+    while (slave->next_us <= now_us) run_loop(!g_master_side);
+    apply_events(now_us);
+
+    g_link.transactions++;
+    g_link.bytes += 1 + m2s_len + s2m_len;
+    uint8_t sent[RPC_M2S_BUFFER_SIZE], reply[RPC_S2M_BUFFER_SIZE];
+    uint8_t hdr = id;
+    memcpy(sent, m2s, m2s_len);
+    // ヘッダが化けると相手は別のトランザクションとして受けるので、応答待ちで終わる扱い
+    bool ok = wire(&hdr, 1) && hdr == id && wire(m2s, m2s_len);
+    if (ok) {
+        slave->fw->target_transaction(id, m2s, s2m);
+        memcpy(reply, s2m, s2m_len);
+        ok = wire(s2m, s2m_len);
+    }
+    if (!ok) {
+        g_link.failures++;
+        *cost_us = SERIAL_USART_TIMEOUT_MS * 1000;
+        return false;
+    }
+    if (memcmp(sent, m2s, m2s_len) || memcmp(reply, s2m, s2m_len)) g_link.corrupted++;
+    *cost_us = (uint32_t)ceil((1 + m2s_len + s2m_len) * 10 * 1e6 / g_baud) + g_latency_us;
+    return true;
+}
+
+// ====== Reports ==================================================
+typedef struct {
+    uint32_t t_us;
+    bool     pending;
+} edge_t;
+
+static edge_t   g_edges[MATRIX_ROWS][MATRIX_COLS][2]; // [.][.][押下]
+static uint32_t g_key_edges, g_unreported;
+
+typedef struct {
+    uint32_t last_us; // 最後に動かした時刻（0 = まだ）
+    uint32_t start_us;
+    bool     waiting; // 動き始めのレポート待ち
+    bool     arrived; // tb_task_combined() に届いた
+    uint32_t bursts;
+    int64_t  in_x, in_y, seen_x, seen_y;
+} ball_t;
+
+static ball_t g_ball[2];
+
+static sim_kb_report_t g_kb_last;
+static uint8_t         g_buttons_last;
+
+// エンドポイントごとに、1 ポーリングで 1 レポート。ChibiOS の usb_endpoint_in_send() は
+// 送信待ちのバッファ（USB_DEFAULT_BUFFER_CAPACITY）が埋まっていると空くまで待つので、
+// その間はファームウェアのループも止まる（*wait_us に返す）
+#define USB_IN_CAPACITY 4
+
+typedef struct {
+    uint32_t t_us[USB_IN_CAPACITY]; // 直近のレポートが届く時刻（0 = なし）
+    uint8_t  head;                  // いちばん古いもの
+} usb_ep_t;
+
+static uint32_t usb_deliver(usb_ep_t* ep, uint32_t now_us, uint32_t* wait_us) {
+    uint32_t oldest = ep->t_us[ep->head];
+    uint32_t last   = ep->t_us[(ep->head + USB_IN_CAPACITY - 1) % USB_IN_CAPACITY];
+    *wait_us        = oldest > now_us ? oldest - now_us : 0;
+    now_us += *wait_us;
+
+    uint32_t t = (now_us + g_usb_us - 1) / g_usb_us * g_usb_us;
+    if (last && t < last + g_usb_us) t = last + g_usb_us;
+    ep->t_us[ep->head] = t;
+    ep->head           = (ep->head + 1) % USB_IN_CAPACITY;
+    return t;
+}
+
+static void key_sample(const sim_cause_t* cause, uint32_t at_us) {
+    if (cause->kind == SIM_CAUSE_NONE || cause->key.row >= MATRIX_ROWS || cause->key.col >= MATRIX_COLS) return;
+    edge_t* edges = g_edges[cause->key.row][cause->key.col];
+    edge_t* e     = &edges[cause->pressed];
+    if (cause->kind == SIM_CAUSE_TAP && cause->pressed && edges[0].pending && edges[0].t_us >= edges[1].t_us) {
+        // タップは離した時に決まるので、タップの押下レポートを離しから測る
+        edges[1].pending = false;
+        e                = &edges[0];
+    }
+    if (!e->pending) return;
+    e->pending = false;
+
+    uint8_t s = cause->kind == SIM_CAUSE_TAP      ? S_TAP
+              : cause->kind == SIM_CAUSE_QUEUED   ? S_QUEUED
+              : cause->kind == SIM_CAUSE_COMBO    ? S_COMBO
+              : cause->key.row < ROWS_PER_HAND    ? S_KEY_L_UP + cause->pressed
+                                                  : S_KEY_R_UP + cause->pressed;
+    add_sample(s, at_us - e->t_us);
+}
+
+static uint32_t on_keyboard_report(uint32_t now_us, const sim_kb_report_t* report, const sim_cause_t* cause) {
+    static usb_ep_t ep;
+    uint32_t        wait_us;
+    g_kb_last = *report;
+    key_sample(cause, usb_deliver(&ep, now_us, &wait_us));
+    return wait_us;
+}
+
+static uint32_t on_mouse_report(uint32_t now_us, const report_mouse_t* report, const sim_cause_t* cause) {
+    static usb_ep_t ep;
+    uint32_t        wait_us;
+    uint32_t        at = usb_deliver(&ep, now_us, &wait_us);
+    g_buttons_last     = report->buttons;
+    key_sample(cause, at);
+    if (!(report->x || report->y || report->h || report->v)) return wait_us;
+    for (uint8_t side = 0; side < 2; side++) {
+        ball_t* b = &g_ball[side];
+        if (b->waiting && b->arrived) {
+            add_sample(S_BALL_L + side, at - b->start_us);
+            b->waiting = false;
+        }
+    }
+    return wait_us;
+}
+
+static void on_pointing_input(uint32_t now_us, report_mouse_t left, report_mouse_t right) {
+    const report_mouse_t* in[2] = {&left, &right};
+    for (uint8_t side = 0; side < 2; side++) {
+        ball_t* b = &g_ball[side];
+        b->seen_x += in[side]->x;
+        b->seen_y += in[side]->y;
+        if (b->waiting && !b->arrived && (in[side]->x || in[side]->y)) {
+            b->arrived = true;
+            add_sample(S_ARRIVE_L + side, now_us - b->start_us);
+        }
+    }
+}
+
+static const sim_host_t k_host = {
+    .transaction     = link_transaction,
+    .keyboard_report = on_keyboard_report,
+    .mouse_report    = on_mouse_report,
+    .pointing_input  = on_pointing_input,
+};
+
+// ====== Scheduler ================================================
+static void apply_events(uint32_t now_us) {
+    for (; g_ev_next < g_ev_n && g_ev[g_ev_next].t_us <= now_us; g_ev_next++) {
+        const event_t* e = &g_ev[g_ev_next];
+        if (e->kind == EV_KEY) {
+            uint8_t row = e->row + (e->side ? ROWS_PER_HAND : 0);
+            edge_t* edge = &g_edges[row][e->col][e->down];
+            if (edge->pending) g_unreported++;
+            *edge = (edge_t){e->t_us, true};
+            g_key_edges++;
+            g_half[e->side].fw->set_key(e->row, e->col, e->down);
+            continue;
+        }
+        if (e->t_us < g_mute_until[e->side]) continue;
+        ball_t* b = &g_ball[e->side];
+        if (!b->waiting && (b->last_us == 0 || e->t_us - b->last_us >= BURST_GAP_US)) {
+            b->start_us = e->t_us;
+            b->waiting  = true;
+            b->arrived  = false;
+            b->bursts++;
+        }
+        b->last_us = e->t_us;
+        b->in_x += e->dx;
+        b->in_y += e->dy;
+        g_half[e->side].fw->move_ball(e->dx, e->dy);
+    }
+}
+
+// ループは開始時刻の順に回す。マスタのリンク待ちの間はスレーブが先に進む
+static void run_loop(uint8_t side) {
+    half_t*  h     = &g_half[side];
+    uint32_t start = h->next_us;
+    apply_events(start);
+    uint32_t end = h->fw->task(start) + g_cpu_us;
+    h->next_us   = end;
+    h->loops++;
+    if (side == g_master_side) {
+        g_link.loop_total_us += end - start;
+        if (end - start > g_link.loop_max_us) g_link.loop_max_us = end - start;
+    }
+}
+
+// 新しいコピーを読み込み直して静的変数を初期状態に戻す。溜まっていたカウントは失われる
+static bool restart_slave(const char* so, uint32_t now_us, int64_t lost[2]) {
+    uint8_t side                         = !g_master_side;
+    const uint16_t(*keymap)[MATRIX_COLS] = NULL;
+    const sim_fw_t* fw                   = load_instance(so, &keymap);
+    if (!fw) return false;
+    ball_t* b  = &g_ball[side];
+    lost[0]    = b->in_x - b->seen_x;
+    lost[1]    = b->in_y - b->seen_y;
+    b->in_x    = b->seen_x;
+    b->in_y    = b->seen_y;
+    b->waiting = false;
+
+    g_half[side].fw      = fw;
+    g_half[side].next_us = now_us;
+    g_mute_until[side]   = now_us + WARMUP_US;
+    fw->init(&k_host, side == 0, false, now_us);
+    return true;
+}
+
+// ====== Main =====================================================
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-f script | -n strokes] [-s seed] [-o out] [-l latency_us] [-e ber] [-b baud]\n"
+            "          [-c loop_us] [-u usb_us] [-r] [-R restart_us] [-S] [-K key_p99_us] [-B ball_p99_us]\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* script = NULL;
+    const char* out    = NULL;
+    uint32_t    strokes = 2000, seed = 1;
+    bool        left_scroll = false;
+    int         opt;
+    g_master_side = 0;
+    while ((opt = getopt(argc, argv, "f:n:s:o:l:e:b:c:u:rR:SK:B:h")) != -1) {
+        switch (opt) {
+            case 'f': script = optarg; break;
+            case 'n': strokes = strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoul(optarg, NULL, 0); break;
+            case 'o': out = optarg; break;
+            case 'l': g_latency_us = strtoul(optarg, NULL, 0); break;
+            case 'e': g_ber = strtod(optarg, NULL); break;
+            case 'b': g_baud = strtoul(optarg, NULL, 0); break;
+            case 'c': g_cpu_us = strtoul(optarg, NULL, 0); break;
+            case 'u': g_usb_us = strtoul(optarg, NULL, 0); break;
+            case 'r': g_master_side = 1; break;
+            case 'R': g_restart_us = strtoul(optarg, NULL, 0); break;
+            case 'S': left_scroll = true; break;
+            case 'K': g_key_limit = strtoul(optarg, NULL, 0); break;
+            case 'B': g_ball_limit = strtoul(optarg, NULL, 0); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (g_baud == 0 || g_usb_us == 0 || g_cpu_us == 0 || g_ber < 0 || g_ber >= 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // 共有ライブラリは実行ファイルと同じディレクトリ
+    char        so[4096];
+    const char* slash = strrchr(argv[0], '/');
+    snprintf(so, sizeof(so), "%.*s/split_sim_fw.so", slash ? (int)(slash - argv[0]) : 1, slash ? argv[0] : ".");
+    const uint16_t(*keymap)[MATRIX_COLS] = NULL;
+    for (uint8_t side = 0; side < 2; side++) {
+        g_half[side].fw = load_instance(so, &keymap);
+        if (!g_half[side].fw) return 2;
+    }
+
+    srand(seed);
+    g_rng ^= (uint64_t)seed * 0xD1B54A32D192ED03ull;
+    if (script) {
+        if (!load_script(script)) return 2;
+    } else {
+        make_workload(keymap, strokes);
+    }
+    qsort(g_ev, g_ev_n, sizeof(*g_ev), cmp_event);
+    if (out && !save_script(out)) return 2;
+    uint32_t end_us = (g_ev_n ? g_ev[g_ev_n - 1].t_us : 0) + TAIL_US;
+    if (end_us > MAX_DURATION_US) {
+        fprintf(stderr, "[!] 長すぎる（時刻は 32 ビットの µs で、%u s まで）\n", MAX_DURATION_US / 1000000);
+        return 2;
+    }
+
+    // 起動。左右のループの位相はずらしておく
+    for (uint8_t side = 0; side < 2; side++) {
+        g_half[side].fw->init(&k_host, side == 0, side == g_master_side, 0);
+        g_half[side].next_us = side == g_master_side ? 0 : 37;
+    }
+    if (!left_scroll) g_half[g_master_side].fw->tap_keycode(TB_SCR_TOG);
+
+    bool    restarted          = false;
+    int64_t lost_at_restart[2] = {0};
+    for (;;) {
+        uint8_t side = g_half[0].next_us <= g_half[1].next_us ? 0 : 1;
+        if (g_half[side].next_us >= end_us) break;
+        if (g_restart_us && !restarted && g_half[side].next_us >= g_restart_us) {
+            if (!restart_slave(so, g_half[side].next_us, lost_at_restart)) return 2;
+            restarted = true;
+            continue;
+        }
+        run_loop(side);
+    }
+
+    // ====== Results ==================================================
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            g_unreported += g_edges[r][c][0].pending + g_edges[r][c][1].pending;
+        }
+    }
+    const half_t*           master = &g_half[g_master_side];
+    const tb_split_stats_t* st     = master->fw->split_stats();
+
+    printf("[i] リンク %u Bd、トランザクション遅延 %u us、ビット誤り率 %g、ループ %u us + リンク待ち、USB %u us、マスタ %s\n",
+           g_baud, g_latency_us, g_ber, g_cpu_us, g_usb_us, g_master_side ? "右" : "左");
+    printf("[i] キー %u エッジ、トラックボール 左 %u 回 / 右 %u 回（%s、%.1f s）\n", g_key_edges, g_ball[0].bursts,
+           g_ball[1].bursts, left_scroll ? "左スクロール" : "左右カーソル", end_us / 1e6);
+    uint32_t key_p99 = 0, ball_p99 = 0;
+    for (uint8_t s = 0; s < NUM_SERIES; s++) {
+        uint32_t p99 = report(&g_series[s]);
+        if (s <= S_TAP && p99 > key_p99) key_p99 = p99;
+        if ((s == S_BALL_L || s == S_BALL_R) && p99 > ball_p99) ball_p99 = p99;
+    }
+    printf("[i] トランザクション %u 回（%.1f kB）、失敗 %u、検出されない化け %u、マスタのループ 平均 %.0f us / 最大 %u us\n",
+           g_link.transactions, g_link.bytes / 1000.0, g_link.failures, g_link.corrupted,
+           (double)g_link.loop_total_us / master->loops, g_link.loop_max_us);
+    printf("[i] tb_split: ポーリング %u、フレーム %u、再送 %u、欠落 %u、相手側の再起動 %u、失敗 %u\n", st->polls, st->frames,
+           st->dups, st->lost, st->restarts, st->failures);
+    if (restarted) {
+        printf("[i] スレーブの再起動で失ったカウント (%lld, %lld)\n", (long long)lost_at_restart[0],
+               (long long)lost_at_restart[1]);
+    }
+    printf("[i] レポートの出なかったキーエッジ %u（コンボに含まれるキーの離し、リンク切れで消えた短い打鍵など）\n",
+           g_unreported);
+
+    bool ok = true;
+    if (key_p99 > g_key_limit || ball_p99 > g_ball_limit) {
+        printf("[!] p99 が上限を超えた（キー %u > %u us、ボール %u > %u us のどちらか）\n", key_p99, g_key_limit, ball_p99,
+               g_ball_limit);
+        ok = false;
+    }
+    static const sim_kb_report_t empty;
+    if (memcmp(&g_kb_last, &empty, sizeof(empty)) || g_buttons_last) {
+        printf("[!] 押されたままのキー/ボタンがある\n");
+        ok = false;
+    }
+    for (uint8_t side = 0; side < 2; side++) {
+        const ball_t* b = &g_ball[side];
+        if (b->in_x != b->seen_x || b->in_y != b->seen_y) {
+            printf("[!] %s のボール: 入力 (%lld, %lld) に対し tb_task_combined() へ (%lld, %lld)\n", side ? "右" : "左",
+                   (long long)b->in_x, (long long)b->in_y, (long long)b->seen_x, (long long)b->seen_y);
+            ok = false;
+        }
+    }
+    if (!ok) return 1;
+    printf("[i] 遅延は上限内、キーの押しっぱなしなし、ボールのカウント一致\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由でトラックボールの加速カーブを読み書きする。
+
+  python3 scripts/tb_accel.py get                              # 左右のカーブを表示
+  python3 scripts/tb_accel.py set left 0:0.75,20:2.25          # 左を書き換える
+  python3 scripts/tb_accel.py set right 0:1,5:1,15:3,30:4      # 折れ線で指定
+  python3 scripts/tb_accel.py reset right                      # 既定値に戻す
+
+点は「速度:倍率」をカンマ区切りで最大 8 点、速度の昇順で指定する。
+  速度  入力の速さ（カウント/ms、0.25 刻み、最大 63.75）
+  倍率  その速さでの出力倍率（1/32 刻み、最大 7.97）
+点の間は直線で補間し、両端より外は端の倍率のまま。CPI の違いは別途補正される。
+変更はすぐに反映され、EEPROM への保存は少し遅れて行われる。
+
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import sys
+
+import vial_rawhid
+from vial_rawhid import open_device
+
+TB_ACCEL_GET = 0x01
+TB_ACCEL_SET = 0x02
+TB_ACCEL_RESET = 0x03
+
+TB_ACCEL_POINTS = 8
+SIDES = {"left": 0, "right": 1}
+
+
+def command(dev, sub, side, payload=b""):
+    body = vial_rawhid.command(dev, vial_rawhid.CMD_TB_ACCEL, sub, bytes([side]) + payload, "加速カーブ対応のファームウェア")
+    n = body[1]
+    return [(body[2 + 2 * i] / 4, body[3 + 2 * i] / 32) for i in range(n)]
+
+
+def parse_points(text):
+    pts = []
+    for item in text.split(","):
+        try:
+            speed, gain = (float(v) for v in item.split(":"))
+        except ValueError:
+            sys.exit(f"[!] 点の形式が不正です: {item!r}（速度:倍率）")
+        s, g = round(speed * 4), round(gain * 32)
+        if not (0 <= s <= 255 and 0 <= g <= 255):
+            sys.exit(f"[!] 範囲外です: {item!r}")
+        pts.append((s, g))
+    if len(pts) > TB_ACCEL_POINTS:
+        sys.exit(f"[!] 点は最大 {TB_ACCEL_POINTS} 個です")
+    if any(b[0] <= a[0] for a, b in zip(pts, pts[1:])):
+        sys.exit("[!] 速度は昇順で、重複させないでください")
+    return pts
+
+
+def show(name, pts):
+    print(f"{name:<6} " + ", ".join(f"{s:g}:{g:.3g}" for s, g in pts))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("action", choices=["get", "set", "reset"])
+    ap.add_argument("side", nargs="?", choices=list(SIDES))
+    ap.add_argument("points", nargs="?", help="速度:倍率,速度:倍率,...")
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+    if args.action != "get" and args.side is None:
+        ap.error("side を指定してください")
+    if args.action == "set" and args.points is None:
+        ap.error("points を指定してください")
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        if args.action == "get":
+            for name in ([args.side] if args.side else SIDES):
+                show(name, command(dev, TB_ACCEL_GET, SIDES[name]))
+        elif args.action == "set":
+            pts = parse_points(args.points)
+            payload = bytes([len(pts)]) + b"".join(bytes(p) for p in pts)
+            show(args.side, command(dev, TB_ACCEL_SET, SIDES[args.side], payload))
+        else:
+            show(args.side, command(dev, TB_ACCEL_RESET, SIDES[args.side]))
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    main()
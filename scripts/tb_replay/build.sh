@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# トレース再生ツールをホスト向けにビルドする。
+# keymaps/vial の tb.c / tb_xform.c をそのままリンクする。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+CC=${CC:-cc}
+
+# config.h は QMK と同じく全ファイルに適用する（出力範囲と EECONFIG_KB_DATA_SIZE を揃える）。
+# 高解像度スクロールは HIRES_SCROLL_ENABLE=yes 相当にし、どちらのビルドのトレースも
+# 保存された sc_hires に従って再生する
+"$CC" -O2 -Wall -std=gnu11 -DPOINTING_DEVICE_HIRES_SCROLL_ENABLE \
+  -include "$KEYMAP_DIR/config.h" \
+  -I"$HERE/host" -I"$KEYMAP_DIR" -I"$KEYBOARD_DIR" \
+  "$HERE/tb_replay.c" "$KEYMAP_DIR/tb.c" "$KEYMAP_DIR/tb_xform.c" \
+  -lm -o "$HERE/tb_replay"
+
+echo "[i] ビルド完了: $HERE/tb_replay"
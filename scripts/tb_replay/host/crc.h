@@ -0,0 +1,6 @@
+// scripts/tb_replay/host/crc.h
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+uint8_t crc8(uint8_t* data, size_t data_len);
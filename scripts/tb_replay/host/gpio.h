@@ -0,0 +1,7 @@
+// scripts/tb_replay/host/gpio.h
+// tb_replay 用の最小限の代替（paw3222.h が pin_t を使うため）
+#pragma once
+#include <stdint.h>
+
+typedef uint32_t pin_t;
+#define NO_PIN ((pin_t)~0u)
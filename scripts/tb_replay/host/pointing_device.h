@@ -0,0 +1,25 @@
+// scripts/tb_replay/host/pointing_device.h
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int16_t mouse_xy_report_t;
+typedef int16_t mouse_hv_report_t;
+
+typedef struct {
+    uint8_t           buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
+} report_mouse_t;
+
+typedef struct {
+    void (*init)(void);
+    report_mouse_t (*get_report)(report_mouse_t mouse_report);
+    void (*set_cpi)(uint16_t cpi);
+    uint16_t (*get_cpi)(void);
+} pointing_device_driver_t;
+
+void     pointing_device_set_cpi(uint16_t cpi);
+uint16_t pointing_device_get_hires_scroll_resolution(void);
@@ -0,0 +1,30 @@
+// scripts/tb_replay/host/quantum.h
+// tb.c をホストでビルドするための最小限の代替ヘッダ（QMK 本体は使わない）
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pointing_device.h"
+
+// MOUSE/WHEEL_EXTENDED_REPORT は tb_xform.c も参照するので build.sh で与える
+// マウスボタンのフォールバック処理は再生に関係しないので外す
+#define MOUSEKEY_ENABLE
+
+#define QK_KB_0 0x7E00
+
+typedef struct {
+    struct {
+        bool     pressed;
+        uint16_t time;
+    } event;
+} keyrecord_t;
+
+bool is_keyboard_left(void);
+
+uint32_t timer_read32(void);
+uint32_t timer_elapsed32(uint32_t last);
+
+uint32_t eeconfig_read_kb(void);
+void     eeconfig_update_kb(uint32_t val);
+uint32_t eeconfig_read_kb_datablock(void* data, uint32_t offset, uint32_t length);
+uint32_t eeconfig_update_kb_datablock(const void* data, uint32_t offset, uint32_t length);
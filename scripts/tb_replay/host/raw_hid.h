@@ -0,0 +1,5 @@
+// scripts/tb_replay/host/raw_hid.h
+// tb_replay 用の最小限の代替（tb.c の raw HID 処理はリンクされるが呼ばれない）
+#pragma once
+
+#define RAW_EPSIZE 32
@@ -0,0 +1,220 @@
+// scripts/tb_replay/tb_replay.c
+// tb_trace_dump.py で取得したトレースを tb_task_combined() に再投入し、
+// 生成される HID レポートを 1 ティック 1 行で出力する。センサの読み出し（L/R レコード）は
+// 次のティック（T レコード）まで積算し、ファームウェアと同じく 1 レポートにまとめて渡す。
+// 旧形式（1 行 1 ティック、t_us repeat lx ly rx ry）も読める。
+//
+//   ./tb_replay trace.txt              # トレース取得時の設定で再生
+//   ./tb_replay trace.txt 1315...      # 設定（tb_config_t の 16 進ダンプ）を差し替え
+//   ./tb_replay trace.txt 0x12345678   # 旧 32bit 形式の設定（移行処理を通す）
+//   ./tb_replay -i                     # 回帰確認: 止めた後にカーソル/スクロールが這わないこと
+//
+// 出力: t_us lx ly rx ry -> x y h v
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include "quantum.h"
+#include "pointing_device.h"
+#include "tb.h"
+
+// ====== QMK stand-ins ============================================
+
+static uint32_t g_ee;
+static uint8_t  g_kbdata[EECONFIG_KB_DATA_SIZE];
+
+uint32_t eeconfig_read_kb(void) { return g_ee; }
+void     eeconfig_update_kb(uint32_t val) { g_ee = val; }
+
+uint32_t eeconfig_read_kb_datablock(void* data, uint32_t offset, uint32_t length) {
+    memcpy(data, g_kbdata + offset, length);
+    return length;
+}
+
+uint32_t eeconfig_update_kb_datablock(const void* data, uint32_t offset, uint32_t length) {
+    memcpy(g_kbdata + offset, data, length);
+    return length;
+}
+
+// quantum/crc.c（CRC_ENABLE, 多項式 0x31）と同じ値になること
+uint8_t crc8(uint8_t* data, size_t data_len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < data_len; ++i) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; ++b) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// "# kbdata" の 16 進ダンプ、または旧形式 "0x........" を読み込む
+static bool load_config(const char* s) {
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        g_ee = (uint32_t)strtoul(s, NULL, 0);
+        memset(g_kbdata, 0, sizeof(g_kbdata));
+        return true;
+    }
+    memset(g_kbdata, 0, sizeof(g_kbdata));
+    for (size_t i = 0; i < EECONFIG_KB_DATA_SIZE && isxdigit((unsigned char)s[2 * i]) && isxdigit((unsigned char)s[2 * i + 1]); ++i) {
+        unsigned byte;
+        if (sscanf(&s[2 * i], "%2x", &byte) != 1) return false;
+        g_kbdata[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+// トレースの値は既にセンサの CPI で取得されているので、設定は捨ててよい
+bool is_keyboard_left(void) { return true; }
+void pointing_device_set_cpi(uint16_t cpi) { (void)cpi; }
+// QMK の既定値（POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER）。sc_hires の時は h/v がこの単位になる
+uint16_t pointing_device_get_hires_scroll_resolution(void) { return 120; }
+void tb_split_set_remote_cpi(uint16_t cpi) { (void)cpi; }
+
+// 再生中は設定を変更しないので、遅延保存のタイマは動かなくてよい
+uint32_t timer_read32(void) { return 0; }
+uint32_t timer_elapsed32(uint32_t last) { return 0 - last; }
+
+// ====== Idle creep check =========================================
+// 各フィルタで左カーソル/左スクロール/右カーソルのそれぞれに、1ms 周期で (3, -2) を
+// 50 ティック入れてから 10 秒間 0 を入れる。平滑の尾は数十 ms で消えるはずなので、
+// 止めて IDLE_SETTLE_MS 以降に 1 カウントでも出たら失敗（平滑の状態が 0 に戻っていない）。
+#define IDLE_SETTLE_MS 200
+
+static bool idle_check(void) {
+    static const char* const k_filter_names[] = {"iir", "one-euro", "none"};
+    static const char* const k_case_names[]   = {"L cursor", "L scroll", "R cursor"};
+    bool                     ok               = true;
+
+    for (uint8_t f = 0; f < TB_FILTER_COUNT; ++f) {
+        for (uint8_t k = 0; k < 3; ++k) {
+            memset(g_kbdata, 0, sizeof(g_kbdata));
+            g_ee = 0;
+            tb_init(); // 既定値が g_kbdata に書かれる
+            tb_config_t c = *tb_get_config();
+            c.filter[0] = c.filter[1] = f;
+            c.side[0].scroll_mode     = k == 1;
+            c.crc = crc8((uint8_t*)&c.side, sizeof(c) - offsetof(tb_config_t, side));
+            memcpy(g_kbdata, &c, sizeof(c));
+            tb_init();
+
+            long moved = 0, creep_x = 0, creep_y = 0, creep_h = 0, creep_v = 0;
+            for (uint32_t t = 0; t < 50 + 10000; ++t) {
+                report_mouse_t in = t < 50 ? (report_mouse_t){.x = 3, .y = -2} : (report_mouse_t){0};
+                report_mouse_t o  = k == 2 ? tb_task_combined((report_mouse_t){0}, in, 1000) : tb_task_combined(in, (report_mouse_t){0}, 1000);
+                if (t < 50 + IDLE_SETTLE_MS) {
+                    moved += abs(o.x) + abs(o.y) + abs(o.h) + abs(o.v);
+                    continue;
+                }
+                creep_x += o.x; creep_y += o.y; creep_h += o.h; creep_v += o.v;
+            }
+            bool pass = moved > 0 && creep_x == 0 && creep_y == 0 && creep_h == 0 && creep_v == 0;
+            printf("%-8s %-8s  moved %4ld  creep x %ld y %ld h %ld v %ld  %s\n", k_filter_names[f], k_case_names[k], moved,
+                   creep_x, creep_y, creep_h, creep_v, pass ? "ok" : "NG");
+            ok &= pass;
+        }
+    }
+    return ok;
+}
+
+// ====== Replay ===================================================
+// 読み出しの積算。レポートの範囲を超えた分は paw3222_get_report() と同じく次へ持ち越す
+static int32_t g_acc[2][2]; // [右][x/y]
+
+static int16_t take_report(int32_t* acc) {
+    int32_t v = *acc < INT16_MIN ? INT16_MIN : (*acc > INT16_MAX ? INT16_MAX : *acc);
+    *acc -= v;
+    return (int16_t)v;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s TRACE [CONFIG] | -i\n", argv[0]);
+        return 2;
+    }
+    if (strcmp(argv[1], "-i") == 0) return idle_check() ? 0 : 1;
+    FILE* fp = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+    if (!fp) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    char line[512];
+    bool have_cfg = false;
+    if (argc > 2) {
+        if (!load_config(argv[2])) {
+            fprintf(stderr, "bad config: %s\n", argv[2]);
+            return 2;
+        }
+        have_cfg = true;
+    }
+
+    bool     started = false;
+    uint32_t clock_us = 0, tick_us = 1000; // 再生中の時刻と直近のティック間隔
+    long    ticks = 0, reads[2] = {0}, motion_reads[2] = {0};
+    long    sum_x = 0, sum_y = 0, sum_h = 0, sum_v = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char cfg_line[2 * EECONFIG_KB_DATA_SIZE + 1];
+        if (sscanf(line, "# kbdata %128s", cfg_line) == 1 || sscanf(line, "# config %128s", cfg_line) == 1) {
+            if (!have_cfg && !load_config(cfg_line)) {
+                fprintf(stderr, "bad config line: %s", line);
+                return 1;
+            }
+            have_cfg = true;
+            continue;
+        }
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        unsigned long t_us;
+        unsigned      repeat;
+        char          kind;
+        int           motion, x, y, rx, ry;
+        if (sscanf(line, "%lu %u %c %d %d %d", &t_us, &repeat, &kind, &motion, &x, &y) == 6 && (kind == 'L' || kind == 'R' || kind == 'T')) {
+            if (kind != 'T') {
+                uint8_t side = kind == 'R';
+                g_acc[side][0] += x;
+                g_acc[side][1] += y;
+                reads[side] += repeat;
+                motion_reads[side] += motion ? repeat : 0;
+                continue;
+            }
+        } else if (sscanf(line, "%lu %u %d %d %d %d", &t_us, &repeat, &x, &y, &rx, &ry) == 6) {
+            // 旧形式: 1 行が 1 ティックぶんの左右のデルタ
+            g_acc[0][0] += x;
+            g_acc[0][1] += y;
+            g_acc[1][0] += rx;
+            g_acc[1][1] += ry;
+        } else {
+            fprintf(stderr, "bad line: %s", line);
+            return 1;
+        }
+        if (!started) {
+            if (!have_cfg) fprintf(stderr, "warning: no config in trace, using defaults\n");
+            tb_init();
+            started = true;
+        }
+        // 畳み込まれた無入力ティックの時刻は記録されないので、直前の間隔で進める。
+        // 次のレコードの時刻で合わせ直す（dt は平滑の時定数に効く）
+        uint32_t gap = (uint32_t)t_us - clock_us;
+        if (ticks > 0 && gap > 0 && gap < 100000) tick_us = gap;
+        clock_us = (uint32_t)t_us;
+        for (unsigned i = 0; i < repeat; ++i) {
+            report_mouse_t l = {.x = take_report(&g_acc[0][0]), .y = take_report(&g_acc[0][1])};
+            report_mouse_t r = {.x = take_report(&g_acc[1][0]), .y = take_report(&g_acc[1][1])};
+            report_mouse_t o = tb_task_combined(l, r, i == 0 && ticks > 0 ? gap : tick_us);
+            if (i > 0) clock_us += tick_us;
+            printf("%lu %d %d %d %d -> %d %d %d %d\n", t_us, l.x, l.y, r.x, r.y, o.x, o.y, o.h, o.v);
+            sum_x += o.x; sum_y += o.y; sum_h += o.h; sum_v += o.v;
+            ticks++;
+        }
+    }
+    if (fp != stdin) fclose(fp);
+
+    if (reads[0] || reads[1]) {
+        fprintf(stderr, "reads L %ld (motion %ld) R %ld (motion %ld)\n", reads[0], motion_reads[0], reads[1], motion_reads[1]);
+    }
+    fprintf(stderr, "%ld ticks, total x %ld y %ld h %ld v %ld\n", ticks, sum_x, sum_y, sum_h, sum_v);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由でトラックボール設定の保存カウンタを取得する（tb.c の遅延保存）。
+
+  python3 scripts/tb_save_stats.py
+
+列:
+  changes    設定を変えた回数（キー操作・加速カーブの書き込み）
+  coalesced  未保存の変更に重なったため、書き込み 1 回にまとめた回数
+  unchanged  保存時に EEPROM と同じ内容だったため書かなかった回数
+  writes     実際に EEPROM（フラッシュ）へ書いた回数
+  pending    まだ書いていない変更があるか（操作が途切れて数秒後に書く）
+
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import struct
+
+import vial_rawhid
+from vial_rawhid import open_device
+
+TB_SAVE_STATS = 0x01
+
+STATS = struct.Struct("<IIIIB")  # requests, coalesced, unchanged, writes, dirty
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        body = vial_rawhid.command(dev, vial_rawhid.CMD_TB_SAVE, TB_SAVE_STATS, b"", "保存カウンタ対応のファームウェア")
+    finally:
+        dev.close()
+
+    requests, coalesced, unchanged, writes, dirty = STATS.unpack_from(body)
+    print(f"changes={requests} coalesced={coalesced} unchanged={unchanged} writes={writes} pending={bool(dirty)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# トラックボールのテスト/ベンチマークをホスト向けにビルドする。
+# keymaps/vial の tb.c / tb_xform.c / tb_float_ref.c とキーボードの paw3222.c（モックのバス）を
+# そのままリンクする。
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO_ROOT=$(cd "$HERE/../.." && pwd)
+KEYBOARD_DIR="$REPO_ROOT/qmk_firmware/keyboards/split_ortho4x6"
+KEYMAP_DIR="$KEYBOARD_DIR/keymaps/vial"
+QMK_HOST="$REPO_ROOT/scripts/qmk_host" # 共通の代替ヘッダ
+CC=${CC:-cc}
+
+# config.h は QMK と同じく全ファイルに適用する。MCU_RP で timer_us.h は host/hardware/timer.h を使う。
+# 高解像度スクロールの経路も試すため HIRES_SCROLL_ENABLE=yes 相当でビルドする
+"$CC" -O2 -Wall -std=gnu11 \
+  -include "$KEYMAP_DIR/config.h" -DPOINTING_DEVICE_HIRES_SCROLL_ENABLE -DMCU_RP -DMOUSEKEY_ENABLE -DTB_TRACE_ENABLE -DTB_TEST_GOLDEN="\"$HERE/golden.txt\"" \
+  -I"$HERE/host" -I"$QMK_HOST" -I"$KEYMAP_DIR" -I"$KEYBOARD_DIR" \
+  "$HERE/tb_test.c" "$KEYMAP_DIR/tb.c" "$KEYMAP_DIR/tb_xform.c" "$KEYMAP_DIR/tb_float_ref.c" \
+  "$KEYMAP_DIR/tb_trace.c" \
+  "$KEYBOARD_DIR/paw3222.c" "$KEYBOARD_DIR/paw3222_bus_mock.c" \
+  -lm -o "$HERE/tb_test"
+
+echo "[i] ビルド完了: $HERE/tb_test"
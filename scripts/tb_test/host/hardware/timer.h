@@ -0,0 +1,6 @@
+// scripts/tb_test/host/hardware/timer.h
+// pico-sdk の代替。timer_us.h（MCU_RP）から使う。時刻はテストが進める
+#pragma once
+#include <stdint.h>
+
+uint32_t time_us_32(void);
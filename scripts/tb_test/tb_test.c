@@ -0,0 +1,875 @@
+// scripts/tb_test/tb_test.c
+// tb.c / tb_xform.c と paw3222.c（モックのバス）をホストでそのまま動かし、次を確かめる。
+//   1. tb_task_combined() のゴールデン出力（カーソル: フィルタ x CPI x 回転、
+//      スクロール: 分割 x ゲイン x ガンマ x 高解像度）。golden.txt と 1 ティックでも
+//      違えば失敗
+//   2. PAW3222 のレジスタ操作（paw3222_bus_mock.c のレジスタマップ）、抜き差しと電圧低下、
+//      1 本のバスに複数のセンサ、設定の遅延保存、読み出しごとのトレース（tb_trace.c）、
+//      センサの CPI を変えても加速とスクロールが変更前（float 版）と同じこと
+//   3. 変換 1 回あたりの時間（tb_apply_transform_side() の中身の tb_xform_apply()）。
+//      固定小数点化する前の float 版（keymaps/vial/tb_float_ref.c）と並べる
+//
+//   ./tb_test         # 確認 + ベンチマーク。食い違いがあれば終了コード 1
+//   ./tb_test -u      # golden.txt を今の出力で書き直す（変換を意図して変えた時だけ）
+//
+// 時間はこのホスト（FPU と libm がある）のもので、M0+ の値ではない。実機の値は
+// keymaps/vial/tb_bench.c（TB_BENCH_ENABLE）で測る。
+//
+// 入力はティック間隔 500..2000us の固定の擬似乱数列（停止・低速・高速・往復を含む）なので、
+// 結果はホストによらない。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "quantum.h"
+#include "crc.h"
+#include "pointing_device.h"
+#include "tb.h"
+#include "tb_xform.h"
+#include "tb_float_ref.h"
+#include "gpio.h"
+#include "paw3222.h"
+#include "paw3222_bus_mock.h"
+#include "raw_hid.h"
+#include "rawhid_cmd.h"
+#include "tb_trace.h"
+
+// ====== QMK stand-ins ============================================
+static uint32_t g_now_us;
+static uint32_t g_ee;
+static uint8_t  g_kbdata[EECONFIG_KB_DATA_SIZE];
+static uint16_t g_remote_cpi;
+static uint32_t g_cs_windows; // paw3222_primary の CS を下げた回数
+
+uint32_t time_us_32(void) { return g_now_us; }
+uint32_t timer_read32(void) { return g_now_us / 1000; }
+uint32_t timer_elapsed32(uint32_t last) { return timer_read32() - last; }
+
+void gpio_set_pin_output(pin_t pin) {}
+void gpio_set_pin_input_high(pin_t pin) {}
+void gpio_write_pin_high(pin_t pin) {}
+void gpio_write_pin_low(pin_t pin) { g_cs_windows += pin == PAW3222_CS_PIN; }
+bool gpio_read_pin(pin_t pin) { return true; }
+void palEnableLineEvent(pin_t line, uint32_t mode) {}
+void palSetLineCallback(pin_t line, palcallback_t cb, void* arg) {}
+
+uint32_t eeconfig_read_kb(void) { return g_ee; }
+void     eeconfig_update_kb(uint32_t val) { g_ee = val; }
+
+uint32_t eeconfig_read_kb_datablock(void* data, uint32_t offset, uint32_t length) {
+    memcpy(data, g_kbdata + offset, length);
+    return length;
+}
+
+uint32_t eeconfig_update_kb_datablock(const void* data, uint32_t offset, uint32_t length) {
+    memcpy(g_kbdata + offset, data, length);
+    return length;
+}
+
+// QMK の crc8（多項式 0x31、初期値 0xFF）
+uint8_t crc8(const void* data, size_t data_len) {
+    const uint8_t* p   = data;
+    uint8_t        crc = 0xFF;
+    for (size_t i = 0; i < data_len; ++i) {
+        crc ^= p[i];
+        for (uint8_t b = 0; b < 8; ++b) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+bool is_keyboard_left(void) { return true; }
+
+// pointing_device.c と同じくドライバへそのまま渡す（左のセンサ）。右は tb_split 経由
+void pointing_device_set_cpi(uint16_t cpi) { paw3222_set_cpi(cpi); }
+uint16_t pointing_device_get_hires_scroll_resolution(void) { return 120; }
+void tb_split_set_remote_cpi(uint16_t cpi) { g_remote_cpi = cpi; }
+
+// ====== Input trace ==============================================
+// 乱数はホストの rand() に依存しないよう xorshift32
+static uint32_t g_rng;
+
+static uint32_t rnd(uint32_t lo, uint32_t hi) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return lo + g_rng % (hi - lo + 1);
+}
+
+#define TRACE_TICKS 4000
+
+typedef struct {
+    uint16_t dt_us;
+    int16_t  lx, ly, rx, ry;
+} tick_t;
+
+static tick_t g_trace[TRACE_TICKS];
+static tick_t g_stress[TRACE_TICKS]; // 最短の間隔で入力上限を超える一方向の動き
+
+// 区間ごとに「止まる / 低速 / 高速 / 往復」のどれかを選び、左右は独立に動かす
+static void make_side(uint32_t seed, bool right) {
+    g_rng = seed;
+    for (uint32_t t = 0; t < TRACE_TICKS;) {
+        uint32_t len = rnd(20, 200), kind = rnd(0, 3);
+        int32_t  vx = 0, vy = 0;
+        if (kind == 1) { vx = rnd(0, 6) - 3; vy = rnd(0, 6) - 3; }
+        if (kind >= 2) { vx = rnd(0, 120) - 60; vy = rnd(0, 120) - 60; }
+        for (uint32_t i = 0; i < len && t < TRACE_TICKS; ++i, ++t) {
+            int32_t x = vx + (int32_t)rnd(0, 2) - 1, y = vy + (int32_t)rnd(0, 2) - 1;
+            if (kind == 0) x = y = 0;
+            if (kind == 3 && (i / 10) % 2) { x = -x; y = -y; }
+            if (right) { g_trace[t].rx = x; g_trace[t].ry = y; }
+            else       { g_trace[t].lx = x; g_trace[t].ly = y; }
+        }
+    }
+}
+
+static void make_trace(void) {
+    make_side(0x1234567u, false);
+    make_side(0x89abcdeu, true);
+    g_rng = 0x2468aceu;
+    for (uint32_t t = 0; t < TRACE_TICKS; ++t) g_trace[t].dt_us = rnd(500, 2000);
+
+    // dt は TB_DT_MIN_US まで切り上げられ、入力は TB_IN_LIMIT で切られる。
+    // 速度・スクロール量が最大になり、途中の値が int32 に収まるかを見る
+    for (uint32_t t = 0; t < TRACE_TICKS; ++t) {
+        g_stress[t] = (tick_t){.dt_us = 1, .lx = 2 * TB_IN_LIMIT, .ly = 2 * TB_IN_LIMIT, .rx = -2 * TB_IN_LIMIT, .ry = -2 * TB_IN_LIMIT};
+    }
+}
+
+// ====== Config ===================================================
+// 既定値から始めて一部を書き換え、EEPROM 経由で tb_init() に読ませる（起動時と同じ経路）
+static void apply_config(const tb_config_t* c) {
+    tb_config_t s = *c;
+    s.crc         = crc8((uint8_t*)&s.side, sizeof(s) - offsetof(tb_config_t, side));
+    memset(g_kbdata, 0, sizeof(g_kbdata));
+    memcpy(g_kbdata, &s, sizeof(s));
+    tb_init();
+}
+
+static tb_config_t default_config(void) {
+    memset(g_kbdata, 0, sizeof(g_kbdata));
+    g_ee = 0;
+    tb_init(); // 既定値が書き込まれる
+    return *tb_get_config();
+}
+
+// ====== Golden grid ==============================================
+static const char* const k_filter_names[] = {"iir", "euro", "none"};
+static const uint16_t    k_cpis[]         = {200, 400, 800, 1600, 3200};
+static const int16_t     k_rots[]         = {-180, -135, -90, -30, 0, 45, 90, 165};
+static const uint8_t     k_divs[]         = {2, 4, 8, 16, 32, 64};
+static const uint16_t    k_gains[]        = {50, 125, 200};
+static const uint16_t    k_gammas[]       = {50, 75, 100, 150};
+
+#define LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    char     name[64];
+    long     x, y, h, v;
+    uint32_t hash;     // 全ティックの出力の FNV-1a
+    uint8_t  signs[4]; // x/y/h/v の出力に現れた符号（bit0: 正、bit1: 負）
+} result_t;
+
+#define MAX_RESULTS 512
+static result_t g_results[MAX_RESULTS];
+static uint32_t g_num_results;
+
+static void run_case(const char* name, const tb_config_t* c, const tick_t* trace) {
+    apply_config(c);
+    result_t* r = &g_results[g_num_results++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->hash = 2166136261u;
+    for (uint32_t t = 0; t < TRACE_TICKS; ++t) {
+        const tick_t*  k = &trace[t];
+        report_mouse_t o = tb_task_combined((report_mouse_t){.x = k->lx, .y = k->ly}, (report_mouse_t){.x = k->rx, .y = k->ry}, k->dt_us);
+        int16_t        v[4] = {o.x, o.y, o.h, o.v};
+        for (uint8_t i = 0; i < 8; ++i) r->hash = (r->hash ^ ((uint8_t*)v)[i]) * 16777619u;
+        for (uint8_t i = 0; i < 4; ++i) r->signs[i] |= v[i] > 0 ? 1 : v[i] < 0 ? 2 : 0;
+        r->x += o.x; r->y += o.y; r->h += o.h; r->v += o.v;
+    }
+}
+
+static void run_grid(void) {
+    tb_config_t base = default_config();
+    char        name[64];
+
+    // カーソル: 左右とも同じ設定（右は tb_split 経由の CPI）
+    for (uint8_t f = 0; f < TB_FILTER_COUNT; ++f) {
+        for (uint8_t i = 0; i < LEN(k_cpis); ++i) {
+            for (uint8_t j = 0; j < LEN(k_rots); ++j) {
+                tb_config_t c         = base;
+                c.side[0].scroll_mode = false;
+                c.filter[0] = c.filter[1] = f;
+                c.side[0].cpi = c.side[1].cpi = k_cpis[i];
+                c.side[0].rot_deg = c.side[1].rot_deg = k_rots[j];
+                snprintf(name, sizeof(name), "cursor/%s/cpi%u/rot%d", k_filter_names[f], k_cpis[i], k_rots[j]);
+                run_case(name, &c, g_trace);
+            }
+        }
+    }
+    // スクロール: 左のみ（右は既定のカーソル）
+    for (uint8_t hires = 0; hires < 2; ++hires) {
+        for (uint8_t i = 0; i < LEN(k_divs); ++i) {
+            for (uint8_t j = 0; j < LEN(k_gains); ++j) {
+                for (uint8_t k = 0; k < LEN(k_gammas); ++k) {
+                    tb_config_t c         = base;
+                    c.side[0].scroll_mode = true;
+                    c.sc_div              = k_divs[i];
+                    c.sc_gain             = k_gains[j];
+                    c.sc_gamma            = k_gammas[k];
+                    c.sc_hires            = hires;
+                    snprintf(name, sizeof(name), "scroll/%s/div%u/gain%u/gamma%u", hires ? "hires" : "tick", k_divs[i],
+                             k_gains[j], k_gammas[k]);
+                    run_case(name, &c, g_trace);
+                }
+            }
+        }
+    }
+    // 極端な入力（g_stress）: 速度の補正が最大になる CPI 200 と、スクロールの量が最大になる設定
+    for (uint8_t f = 0; f < TB_FILTER_COUNT; ++f) {
+        tb_config_t c = base;
+        c.filter[0] = c.filter[1] = f;
+        c.side[0].cpi = c.side[1].cpi = 200;
+        snprintf(name, sizeof(name), "stress/cursor/%s", k_filter_names[f]);
+        run_case(name, &c, g_stress);
+    }
+    for (uint8_t hires = 0; hires < 2; ++hires) {
+        tb_config_t c         = base;
+        c.side[0].scroll_mode = true;
+        c.side[0].cpi         = 200;
+        c.sc_div              = k_divs[0];
+        c.sc_gain             = k_gains[LEN(k_gains) - 1];
+        c.sc_gamma            = k_gammas[LEN(k_gammas) - 1];
+        c.sc_hires            = hires;
+        snprintf(name, sizeof(name), "stress/scroll/%s", hires ? "hires" : "tick");
+        run_case(name, &c, g_stress);
+    }
+}
+
+static bool write_golden(const char* path) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    fprintf(fp, "# scripts/tb_test: tb_task_combined() の合計出力とハッシュ（./tb_test -u で生成）\n");
+    fprintf(fp, "# name x y h v hash\n");
+    for (uint32_t i = 0; i < g_num_results; ++i) {
+        const result_t* r = &g_results[i];
+        fprintf(fp, "%s %ld %ld %ld %ld %08x\n", r->name, r->x, r->y, r->h, r->v, r->hash);
+    }
+    fclose(fp);
+    printf("[i] %s に %u 件書き込み\n", path, g_num_results);
+    return true;
+}
+
+static bool check_golden(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        printf("[!] ゴールデンがない（./tb_test -u で作る）\n");
+        return false;
+    }
+    char     line[256];
+    uint32_t n = 0, bad = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        result_t g = {0};
+        if (sscanf(line, "%63s %ld %ld %ld %ld %x", g.name, &g.x, &g.y, &g.h, &g.v, &g.hash) != 6) {
+            printf("[!] ゴールデンの行が不正: %s", line);
+            bad++;
+            continue;
+        }
+        const result_t* r = NULL;
+        for (uint32_t i = 0; i < g_num_results && !r; ++i) {
+            if (strcmp(g_results[i].name, g.name) == 0) r = &g_results[i];
+        }
+        n++;
+        if (!r) {
+            if (bad++ < 10) printf("[!] %s: 今の格子にない\n", g.name);
+        } else if (r->x != g.x || r->y != g.y || r->h != g.h || r->v != g.v || r->hash != g.hash) {
+            if (bad++ < 10) {
+                printf("[!] %s: 合計 (%ld, %ld, %ld, %ld) %08x、ゴールデン (%ld, %ld, %ld, %ld) %08x\n", g.name, r->x, r->y, r->h,
+                       r->v, r->hash, g.x, g.y, g.h, g.v, g.hash);
+            }
+        }
+    }
+    fclose(fp);
+    if (n != g_num_results) {
+        printf("[!] ゴールデン %u 件、格子 %u 件\n", n, g_num_results);
+        bad++;
+    }
+    if (bad) {
+        printf("[!] ゴールデンと %u 件食い違い\n", bad);
+        return false;
+    }
+    printf("[i] ゴールデン %u 件一致（%u ティック/件）\n", n, TRACE_TICKS);
+    return true;
+}
+
+// ====== PAW3222 on the mock bus ==================================
+static uint32_t g_failures;
+
+#define EXPECT(cond, ...)                    \
+    do {                                     \
+        if (!(cond)) {                       \
+            printf("[!] %s: ", __func__);    \
+            printf(__VA_ARGS__);             \
+            printf("\n");                    \
+            g_failures++;                    \
+        }                                    \
+    } while (0)
+
+#define REG_PID1    0x00
+#define REG_STAT    0x02
+#define REG_CONFIG  0x06
+#define REG_PROTECT 0x09
+#define REG_CPI_X   0x0D
+#define REG_CPI_Y   0x0E
+
+static void advance_us(uint32_t us) { g_now_us += us; }
+
+// 1 スロットぶん時間を進めてサンプラを回す
+static void sampler_slot(void) {
+    advance_us(PAW3222_SAMPLE_INTERVAL_US);
+    paw3222_sampler_task();
+}
+
+// センサとドライバの状態を電源投入時に戻す（ゴールデンの実行で CPI が設定されている）
+static void power_on(void) {
+    paw3222_mock_reset();
+    paw3222_mock_attach(0, PAW3222_CS_PIN);
+    paw3222_primary = (paw3222_t)PAW3222_INSTANCE(PAW3222_CS_PIN, NO_PIN);
+}
+
+// リセット → 待ち → PID 確認まで進める
+static void bring_up(void) {
+    paw3222_init();
+    for (uint8_t i = 0; i < 8 && paw3222_get_status()->state != PAW3222_STATE_READY; ++i) sampler_slot();
+}
+
+static void test_bring_up(void) {
+    power_on();
+    paw3222_init();
+    EXPECT(paw3222_mock.windows == 0, "paw3222_init() がバスに触れた（%u 回）", paw3222_mock.windows);
+    EXPECT(!paw3222_service(), "リセット前に ready");
+    EXPECT(paw3222_mock.log_len == 2 && paw3222_mock.log[0] == (0x80 | REG_CONFIG) && paw3222_mock.log[1] == 0x80,
+           "最初の操作がソフトリセットでない");
+    advance_us(PAW3222_RESET_WAIT_US - 1);
+    EXPECT(!paw3222_service() && paw3222_mock.windows == 1, "リセット待ちの間にバスに触れた");
+    advance_us(1);
+    EXPECT(paw3222_service(), "リセット待ちの後に ready にならない");
+    const paw3222_status_t* st = paw3222_get_status();
+    EXPECT(st->state == PAW3222_STATE_READY && st->pid == PAW3222_PID1 && st->inits == 1, "状態 %u PID 0x%02X 起動 %u",
+           st->state, st->pid, st->inits);
+    EXPECT(paw3222_get_cpi() == 0x15 * PAW3222_CPI_STEP, "電源投入時の CPI を読んでいない（%u）", paw3222_get_cpi());
+}
+
+static void test_cpi(void) {
+    static const struct {
+        uint16_t cpi;
+        uint8_t  reg;
+    } k_cases[] = {{1600, 42}, {800, 21}, {100, 16}, {PAW3222_CPI_MIN, 16}, {9999, 127}, {PAW3222_CPI_MAX, 127}, {1000, 26}};
+
+    power_on();
+    bring_up();
+    for (uint8_t i = 0; i < LEN(k_cases); ++i) {
+        uint32_t windows = paw3222_mock.windows;
+        paw3222_set_cpi(k_cases[i].cpi);
+        const uint8_t* r = paw3222_mock.regs;
+        EXPECT(r[REG_CPI_X] == k_cases[i].reg && r[REG_CPI_Y] == k_cases[i].reg, "CPI %u: レジスタ 0x%02X/0x%02X（期待 0x%02X）",
+               k_cases[i].cpi, r[REG_CPI_X], r[REG_CPI_Y], k_cases[i].reg);
+        EXPECT(r[REG_PROTECT] == 0, "CPI %u: 書き込み保護が戻っていない", k_cases[i].cpi);
+        EXPECT(paw3222_mock.windows == windows + 1, "CPI %u: CS %u 回", k_cases[i].cpi, paw3222_mock.windows - windows);
+        EXPECT(paw3222_get_cpi() == k_cases[i].reg * PAW3222_CPI_STEP, "CPI %u: get_cpi %u", k_cases[i].cpi, paw3222_get_cpi());
+    }
+
+    // ready になる前の設定は覚えておき、立ち上げ時に書く
+    power_on();
+    paw3222_init();
+    paw3222_set_cpi(1600);
+    EXPECT(paw3222_mock.regs[REG_CPI_X] == 0x15, "立ち上げ前に CPI を書いた");
+    bring_up();
+    EXPECT(paw3222_mock.regs[REG_CPI_X] == 42 && paw3222_mock.regs[REG_CPI_Y] == 42, "立ち上げ時に CPI を書いていない（0x%02X）",
+           paw3222_mock.regs[REG_CPI_X]);
+}
+
+static void test_motion(void) {
+    power_on();
+    bring_up();
+    paw3222_get_report((report_mouse_t){0}); // 立ち上げ時の残りを捨てる
+    paw3222_reset_bus_stats();
+
+    // 動きがあれば STAT/X/Y を 1 回の CS で読む
+    paw3222_mock_move(5, -3);
+    uint32_t windows = g_cs_windows, reads = paw3222_mock.reads;
+    int16_t  x = 0, y = 0;
+    EXPECT(paw3222_sample(&x, &y) && x == 5 && y == -3, "(5, -3) が (%d, %d)", x, y);
+    EXPECT(g_cs_windows == windows + 1 && paw3222_mock.reads == reads + 3, "CS %u 回、読み出し %u 回", g_cs_windows - windows,
+           paw3222_mock.reads - reads);
+    EXPECT(!(paw3222_mock.regs[REG_STAT] & 0x80), "読んだ後も motion が立っている");
+
+    // 動きがなければ STAT だけ
+    windows = g_cs_windows, reads = paw3222_mock.reads;
+    EXPECT(!paw3222_sample(&x, &y), "動きがないのに motion");
+    EXPECT(g_cs_windows == windows + 1 && paw3222_mock.reads == reads + 1, "動きがない時に STAT 以外を読んだ");
+
+    const paw3222_bus_stats_t* st = paw3222_get_bus_stats();
+    EXPECT(st->polls == 2 && st->motion_polls == 1, "polls %u motion_polls %u", st->polls, st->motion_polls);
+
+    // int8 で飽和したら数える
+    uint32_t saturated = paw3222_get_sampler_stats()->saturated;
+    paw3222_mock_move(300, 0);
+    EXPECT(paw3222_sample(&x, &y) && x == 127, "飽和した X が %d", x);
+    EXPECT(paw3222_get_sampler_stats()->saturated == saturated + 1, "飽和を数えていない");
+
+    // スロットごとに読んだ分は次のレポートにまとめて出る。前の値は出さない
+    report_mouse_t rep = paw3222_get_report((report_mouse_t){.x = 9, .y = 9});
+    EXPECT(rep.x == 0 && rep.y == 0, "動きがないのに (%d, %d)", rep.x, rep.y);
+    long sum_x = 0, sum_y = 0;
+    for (uint8_t i = 0; i < 6; ++i) {
+        paw3222_mock_move(40 + i, -20 - i);
+        sum_x += 40 + i;
+        sum_y -= 20 + i;
+        sampler_slot();
+    }
+    rep = paw3222_get_report((report_mouse_t){0});
+    EXPECT(rep.x == sum_x && rep.y == sum_y, "6 スロットぶん (%ld, %ld) が (%d, %d)", sum_x, sum_y, rep.x, rep.y);
+    rep = paw3222_get_report((report_mouse_t){0});
+    EXPECT(rep.x == 0 && rep.y == 0, "出した後に (%d, %d) が残った", rep.x, rep.y);
+}
+
+// tb.c の設定が左のセンサ（レジスタ）と右（tb_split）へ届くこと
+static void test_tb_cpi(void) {
+    power_on();
+    bring_up();
+    tb_config_t c = default_config();
+    c.side[0].cpi = 3200;
+    c.side[1].cpi = 400;
+    apply_config(&c);
+    EXPECT(paw3222_mock.regs[REG_CPI_X] == 84, "左 CPI 3200 がレジスタ 0x%02X", paw3222_mock.regs[REG_CPI_X]);
+    EXPECT(g_remote_cpi == PAW3222_CPI_MIN, "右 CPI 400 が %u（センサの下限に丸めてゲインで補う）", g_remote_cpi);
+}
+
+// ====== CPI and the curves ========================================
+// 変更前はセンサを電源投入時の約 800 CPI のまま使い、CPI の設定は float 版の cpi / 800 の
+// 掛け算だった。今はセンサの CPI を変えるため、同じ手の動きでもカウントが cpi / 800 倍になる。
+// 800 CPI で一定速度の動きをセンサの CPI に換算して入れ、加速の折れ目の前後とスクロールの
+// 出力が float 版（変更前）と 1%（スクロールは 1 ステップ）以内で一致すること。
+// ティック間隔は float 版に合わせて 1ms
+#define CURVE_TICKS 500
+
+static void test_curve_cpi(void) {
+    static const uint16_t k_cpis[]   = {800, 1600, 3200};
+    static const int16_t  k_speeds[] = {2, 5, 10, 15, 20, 40}; // 800 CPI のカウント/ms
+    for (uint8_t i = 0; i < LEN(k_cpis); ++i) {
+        for (uint8_t j = 0; j < LEN(k_speeds); ++j) {
+            for (uint8_t scroll = 0; scroll < 2; ++scroll) {
+                uint16_t    cpi = k_cpis[i];
+                uint16_t    hw  = (cpi + PAW3222_CPI_STEP / 2) / PAW3222_CPI_STEP * PAW3222_CPI_STEP;
+                tb_xform_t  xf  = {.rot = tb_rot_from_deg(0), .gain_q8 = tb_cpi_gain_q8(cpi, hw),
+                                   .speed_q8 = tb_speed_norm_q8(hw), .scroll = scroll, .filter = TB_FILTER_IIR};
+                tb_scroll_t sc;
+                tb_accel_build(&xf.accel, (const tb_accel_pt_t[])TB_ACCEL_DEFAULT, TB_ACCEL_DEFAULT_N);
+                tb_xform_reset(&xf);
+                tb_scroll_build(&sc, 1.25f, 0.75f);
+                sc.unit  = 32 * TB_ONE;
+                sc.hires = 1;
+                sc.inv   = false;
+
+                tb_float_state_t fs = {0};
+                tb_float_cfg_t   fc = {.cpi = cpi, .scroll = scroll, .div_shift = 5, .sc_gain = 1.25f, .sc_gamma = 0.75f};
+
+                int32_t got = 0, want = 0, carry = 0; // carry: センサ CPI へ換算した時の端数
+                for (uint32_t t = 0; t < CURVE_TICKS; ++t) {
+                    carry += k_speeds[j] * hw;
+                    int16_t in = carry / TB_CURVE_CPI;
+                    carry -= in * TB_CURVE_CPI;
+
+                    tb_xform_out_t out;
+                    tb_xform_apply(&xf, &sc, in, 0, 1000, &out);
+                    got += out.x + out.h;
+
+                    int16_t x = k_speeds[j], y = 0, h = 0, v = 0;
+                    tb_float_apply(&fs, &fc, &x, &y, &h, &v);
+                    want += x + h;
+                }
+                EXPECT(abs(got - want) <= (abs(want) < 100 ? 1 : abs(want) / 100), "CPI %u %s %d カウント/ms: %d、変更前 %d（%+.1f%%）", cpi,
+                       scroll ? "スクロール" : "カーソル", k_speeds[j], got, want, (got - want) * 100.0 / want);
+            }
+        }
+    }
+}
+
+// ====== Extreme input ============================================
+// g_stress は左右とも一方向に動かし続けるので、出力の符号は軸ごとに 1 種類のはず。
+// 途中の値が int32 をあふれると符号が反転する
+static void test_stress(void) {
+    static const char k_axes[] = "xyhv";
+    uint32_t          n        = 0;
+    for (uint32_t i = 0; i < g_num_results; ++i) {
+        const result_t* r = &g_results[i];
+        if (strncmp(r->name, "stress/", 7) != 0) continue;
+        n++;
+        for (uint8_t a = 0; a < 4; ++a) {
+            EXPECT(r->signs[a] != 3, "%s: %c の出力に正負の両方が出た", r->name, k_axes[a]);
+        }
+    }
+    EXPECT(n == TB_FILTER_COUNT + 2, "stress のケースが %u 件", n);
+}
+
+// ====== Hot plug =================================================
+// 抜く・挿し直す・電圧低下でのリセット・別のチップ。浮いたバスを動きにせず、定期確認
+// （PID と CPI）で気づいて立ち上げ直し、設定していた CPI を書き戻す
+#define REINIT_MS (PAW3222_RESET_WAIT_US / 1000 + 10) // 見失ってから立ち上がるまでの余裕
+
+// ms の間サンプラを回し、その間に出たレポートの合計を返す
+static report_mouse_t run_ms(uint32_t ms) {
+    report_mouse_t sum = {0};
+    for (uint32_t t = 0; t < ms * 1000; t += PAW3222_SAMPLE_INTERVAL_US) {
+        sampler_slot();
+        report_mouse_t r = paw3222_get_report((report_mouse_t){0});
+        sum.x += r.x;
+        sum.y += r.y;
+    }
+    return sum;
+}
+
+static void test_hotplug(void) {
+    power_on();
+    bring_up();
+    paw3222_set_cpi(1600);
+    (void)paw3222_get_report((report_mouse_t){0});
+    const paw3222_status_t* st = paw3222_get_status();
+    const uint8_t*          r  = paw3222_mock.regs;
+
+    // 抜くとバスはプルアップで 0xFF。STAT の 0xFF は動きにせず、次のスロットで確かめる
+    paw3222_mock.unplugged = true;
+    int16_t x = 0, y = 0;
+    EXPECT(!paw3222_sample(&x, &y), "浮いた STAT を動きにした（%d, %d）", x, y);
+    sampler_slot();
+    EXPECT(st->lost == 1 && st->state != PAW3222_STATE_READY, "抜けたのに気づかない（状態 %u 見失い %u）", st->state, st->lost);
+    report_mouse_t m = run_ms(1000);
+    EXPECT(m.x == 0 && m.y == 0, "抜けている間に (%d, %d)", m.x, m.y);
+    EXPECT(st->state != PAW3222_STATE_READY && st->inits == 1 && st->pid == 0xFF, "抜けたまま立ち上がった（状態 %u 起動 %u）", st->state,
+           st->inits);
+
+    // 挿し直すと電源投入時の状態から立ち上げ直し、CPI を書き戻す
+    paw3222_mock_reset();
+    run_ms(PAW3222_RETRY_INTERVAL_MS + REINIT_MS);
+    EXPECT(st->state == PAW3222_STATE_READY && st->inits == 2 && st->pid == PAW3222_PID1, "挿し直し: 状態 %u 起動 %u PID 0x%02X",
+           st->state, st->inits, st->pid);
+    EXPECT(r[REG_CPI_X] == 42 && r[REG_CPI_Y] == 42 && paw3222_get_cpi() == 42 * PAW3222_CPI_STEP, "挿し直し: CPI 0x%02X（期待 0x2A）",
+           r[REG_CPI_X]);
+
+    // 電圧低下: つながったまま電源投入時の CPI に戻る。PID は正しいので CPI の確認で気づく
+    paw3222_mock_reset();
+    run_ms(PAW3222_PROBE_INTERVAL_MS + REINIT_MS);
+    EXPECT(st->lost == 2 && st->inits == 3 && st->state == PAW3222_STATE_READY, "電圧低下: 見失い %u 起動 %u 状態 %u", st->lost,
+           st->inits, st->state);
+    EXPECT(r[REG_CPI_X] == 42 && r[REG_CPI_Y] == 42, "電圧低下: CPI 0x%02X（期待 0x2A）", r[REG_CPI_X]);
+
+    // 動いている間も PID を確かめ続ける（答えるのが別のチップなら立ち上げ直す）
+    paw3222_mock.regs[REG_PID1] = 0x31;
+    run_ms(PAW3222_PROBE_INTERVAL_MS);
+    EXPECT(st->lost == 3, "PID の変化に気づかない（見失い %u PID 0x%02X）", st->lost, st->pid);
+    run_ms(REINIT_MS);
+    EXPECT(st->inits == 4 && st->state == PAW3222_STATE_READY && r[REG_CPI_X] == 42, "PID 変化の後: 起動 %u 状態 %u CPI 0x%02X",
+           st->inits, st->state, r[REG_CPI_X]);
+}
+
+// ====== Several sensors on one bus ================================
+// paw3222_dev_read_batch() で 3 つのセンサを読む。CPI はセンサごとに別で、どのセンサも
+// 答えない CS（配線違い）は OFFLINE のまま他のセンサを邪魔しない
+#define BATCH_SENSORS     3
+#define BATCH_MISWIRED_CS 8 // どのモックもつながっていない
+
+static const pin_t k_batch_cs[BATCH_SENSORS] = {5, 6, 7};
+
+static uint8_t batch_slot(paw3222_t* const* devs, uint8_t n, report_paw3222_t* out) {
+    advance_us(PAW3222_SAMPLE_INTERVAL_US);
+    return paw3222_dev_read_batch(devs, n, out);
+}
+
+static void test_batch(void) {
+    static const uint16_t k_cpi[BATCH_SENSORS] = {800, 1600, 3200};
+    static const uint8_t  k_reg[BATCH_SENSORS] = {21, 42, 84};
+    paw3222_t             dev[BATCH_SENSORS + 1];
+    paw3222_t*            devs[BATCH_SENSORS + 1];
+    report_paw3222_t      out[BATCH_SENSORS + 1];
+    const uint8_t         n = BATCH_SENSORS + 1;
+
+    paw3222_mock_reset();
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) {
+        paw3222_mock_attach(i, k_batch_cs[i]);
+        dev[i] = (paw3222_t)PAW3222_INSTANCE(k_batch_cs[i], NO_PIN);
+    }
+    dev[BATCH_SENSORS] = (paw3222_t)PAW3222_INSTANCE(BATCH_MISWIRED_CS, NO_PIN);
+    for (uint8_t i = 0; i < n; ++i) {
+        devs[i] = &dev[i];
+        paw3222_dev_init(&dev[i]);
+    }
+    // ready になる前の設定は立ち上げ時にそれぞれのセンサへ書く
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) paw3222_dev_write_cpi(&dev[i], k_cpi[i]);
+    for (uint8_t i = 0; i < 8; ++i) batch_slot(devs, n, out);
+
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) {
+        const paw3222_status_t* st = paw3222_dev_get_status(&dev[i]);
+        const uint8_t*          r  = paw3222_mocks[i].regs;
+        EXPECT(st->state == PAW3222_STATE_READY && st->inits == 1, "センサ %u: 状態 %u 起動 %u", i, st->state, st->inits);
+        EXPECT(r[REG_CPI_X] == k_reg[i] && r[REG_CPI_Y] == k_reg[i], "センサ %u: CPI %u がレジスタ 0x%02X/0x%02X", i, k_cpi[i],
+               r[REG_CPI_X], r[REG_CPI_Y]);
+        EXPECT(paw3222_dev_get_cpi(&dev[i]) == k_reg[i] * PAW3222_CPI_STEP, "センサ %u: get_cpi %u", i, paw3222_dev_get_cpi(&dev[i]));
+    }
+    const paw3222_status_t* bad = paw3222_dev_get_status(&dev[BATCH_SENSORS]);
+    EXPECT(bad->state == PAW3222_STATE_OFFLINE && bad->pid == 0xFF && bad->inits == 0, "配線違いの CS: 状態 %u PID 0x%02X 起動 %u",
+           bad->state, bad->pid, bad->inits);
+
+    // 動いたセンサだけがビットと値を返し、値は取り違えない。動きのないセンサは STAT だけ
+    paw3222_mock_move_sensor(&paw3222_mocks[0], 5, -1);
+    paw3222_mock_move_sensor(&paw3222_mocks[2], -7, 3);
+    uint32_t reads[BATCH_SENSORS];
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) reads[i] = paw3222_mocks[i].reads;
+    uint8_t moved = batch_slot(devs, n, out);
+    EXPECT(moved == 0x05, "動いたセンサ 0x%02X（期待 0x05）", moved);
+    EXPECT(out[0].x == 5 && out[0].y == -1 && out[2].x == -7 && out[2].y == 3, "(5, -1) / (-7, 3) が (%d, %d) / (%d, %d)", out[0].x,
+           out[0].y, out[2].x, out[2].y);
+    EXPECT(!out[1].isMotion && out[1].x == 0 && out[1].y == 0 && !out[3].isMotion && out[3].x == 0 && out[3].y == 0,
+           "動いていないセンサが値を返した");
+    EXPECT(paw3222_mocks[0].reads == reads[0] + 3 && paw3222_mocks[1].reads == reads[1] + 1 && paw3222_mocks[2].reads == reads[2] + 3,
+           "読み出し %u/%u/%u", paw3222_mocks[0].reads - reads[0], paw3222_mocks[1].reads - reads[1], paw3222_mocks[2].reads - reads[2]);
+
+    // 定期確認をまたいでも、つながっているセンサは見失わず、配線違いは立ち上がらない
+    for (uint32_t t = 0; t < PAW3222_PROBE_INTERVAL_MS * 1000; t += PAW3222_SAMPLE_INTERVAL_US) batch_slot(devs, n, out);
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) {
+        const paw3222_status_t* st = paw3222_dev_get_status(&dev[i]);
+        EXPECT(st->state == PAW3222_STATE_READY && st->lost == 0 && paw3222_mocks[i].regs[REG_CPI_X] == k_reg[i],
+               "定期確認の後 センサ %u: 状態 %u 見失い %u CPI 0x%02X", i, st->state, st->lost, paw3222_mocks[i].regs[REG_CPI_X]);
+    }
+    EXPECT(bad->inits == 0 && bad->state != PAW3222_STATE_READY, "配線違いの CS が立ち上がった");
+
+    for (uint8_t i = 0; i < BATCH_SENSORS; ++i) paw3222_mock_attach(i, NO_PIN);
+}
+
+// PAW3222_BUS_MAX_WORDS を超える窓はどのバックエンドでも丸ごと断る（途中で切らない）
+static void test_bus_limit(void) {
+    power_on();
+    bring_up();
+    paw3222_xfer_t xfers[PAW3222_BUS_MAX_WORDS / 2 + 1]; // 書き込みは 2 語
+    for (uint8_t i = 0; i < LEN(xfers); ++i) xfers[i] = (paw3222_xfer_t){.addr = PAW3222_WRITE | REG_CPI_X, .data = 0x7F};
+    uint32_t windows = paw3222_mock.windows, writes = paw3222_mock.writes;
+    EXPECT(!paw3222_bus_transfer(PAW3222_CS_PIN, xfers, LEN(xfers)), "%u 語の転送を受け付けた",
+           paw3222_bus_words(xfers, LEN(xfers)));
+    EXPECT(paw3222_mock.windows == windows && paw3222_mock.writes == writes, "断った転送がセンサに届いた");
+    EXPECT(paw3222_bus_transfer(PAW3222_CS_PIN, xfers, LEN(xfers) - 1), "上限ちょうどの転送を断った");
+}
+
+// ====== Trace ====================================================
+// paw3222.c のサンプラは読み出しごとに tb_trace_sample() を呼ぶ。動きの無い読み出しと
+// ティックは動きが来るまでそれぞれ 1 レコードに畳まれる
+static void trace_cmd(uint8_t* data, uint8_t sub) {
+    data[0] = RAWHID_CMD_TB_TRACE;
+    data[1] = sub;
+    tb_trace_raw_hid(data, RAW_EPSIZE);
+}
+
+static void test_trace(void) {
+    power_on();
+    bring_up();
+    paw3222_get_report((report_mouse_t){0});
+    uint8_t data[RAW_EPSIZE] = {0};
+    trace_cmd(data, TB_TRACE_ARM);
+
+    uint32_t t0 = g_now_us;
+    sampler_slot();
+    sampler_slot();
+    tb_trace_tick();
+    sampler_slot();
+    tb_trace_tick();
+    paw3222_mock_move(5, -3);
+    sampler_slot();
+    uint32_t t1 = g_now_us;
+    tb_trace_tick();
+    trace_cmd(data, TB_TRACE_STOP);
+
+    static const tb_trace_rec_t k_want[] = {
+        {.repeat = 3, .kind = TB_TRACE_LEFT},
+        {.repeat = 2, .kind = TB_TRACE_TICK},
+        {.repeat = 1, .kind = TB_TRACE_LEFT, .motion = 1, .x = 5, .y = -3},
+        {.repeat = 1, .kind = TB_TRACE_TICK},
+    };
+    memset(data, 0, sizeof(data));
+    trace_cmd(data, TB_TRACE_INFO);
+    uint16_t count = data[4] | data[5] << 8;
+    EXPECT(data[3] == sizeof(tb_trace_rec_t) && count == LEN(k_want), "レコード %u 件（期待 %u）", count, (unsigned)LEN(k_want));
+    for (uint16_t i = 0; i < count && i < LEN(k_want); ++i) {
+        tb_trace_rec_t r;
+        memset(data, 0, sizeof(data));
+        data[2] = (uint8_t)i;
+        trace_cmd(data, TB_TRACE_READ);
+        memcpy(&r, &data[2], sizeof(r));
+        const tb_trace_rec_t* w = &k_want[i];
+        EXPECT(r.repeat == w->repeat && r.kind == w->kind && r.motion == w->motion && r.x == w->x && r.y == w->y,
+               "レコード %u: 種類 %u 数 %u 動き %u (%d, %d)", i, r.kind, r.repeat, r.motion, r.x, r.y);
+        if (i == 0) EXPECT(r.t_us == t0 + PAW3222_SAMPLE_INTERVAL_US, "最初の読み出しの時刻 %u", r.t_us - t0);
+        if (i == 3) EXPECT(r.t_us == t1, "ティックの時刻 %u", r.t_us - t0);
+    }
+}
+
+// ====== Deferred save ============================================
+// 保存のカウンタは RAWHID_CMD_TB_SAVE で読む（TB_TRACE_ENABLE が無くても読めること）
+static void read_save_stats(uint32_t v[4], bool* dirty) {
+    uint8_t data[RAW_EPSIZE] = {RAWHID_CMD_TB_SAVE, 0x01};
+    tb_save_raw_hid(data, sizeof(data));
+    for (uint8_t i = 0; i < 4; ++i) v[i] = data[2 + 4 * i] | data[3 + 4 * i] << 8 | data[4 + 4 * i] << 16 | (uint32_t)data[5 + 4 * i] << 24;
+    *dirty = data[18];
+}
+
+static void test_save_stats(void) {
+    default_config();
+    keyrecord_t press = {.event = {.pressed = true}};
+    uint32_t    a[4], b[4]; // requests, coalesced, unchanged, writes
+    bool        dirty;
+    read_save_stats(a, &dirty);
+
+    // 続けて 3 回変えても書き込みは操作が途切れた後の 1 回
+    for (uint8_t i = 0; i < 3; ++i) tb_process_record(TB_SC_GAIN_UP, &press);
+    read_save_stats(b, &dirty);
+    EXPECT(b[0] == a[0] + 3 && b[1] == a[1] + 2 && b[3] == a[3] && dirty, "変更 %u 集約 %u 書き込み %u 未保存 %u", b[0] - a[0],
+           b[1] - a[1], b[3] - a[3], dirty);
+    g_now_us += 5000000;
+    tb_task();
+    read_save_stats(b, &dirty);
+    EXPECT(b[3] == a[3] + 1 && !dirty, "書き込み %u 未保存 %u", b[3] - a[3], dirty);
+
+    // 行って戻ったら書かない
+    tb_process_record(TB_L_CPI_NEXT, &press);
+    tb_process_record(TB_L_CPI_PREV, &press);
+    g_now_us += 5000000;
+    tb_task();
+    read_save_stats(a, &dirty);
+    EXPECT(a[2] == b[2] + 1 && a[3] == b[3], "同じ内容の保存を省いていない（省略 %u 書き込み %u）", a[2] - b[2], a[3] - b[3]);
+
+    uint8_t data[RAW_EPSIZE] = {RAWHID_CMD_TB_SAVE, 0x7F};
+    tb_save_raw_hid(data, sizeof(data));
+    EXPECT(data[1] == RAWHID_ERR, "未知のサブコマンドを受け付けた");
+}
+
+static bool run_unit_tests(void) {
+    g_failures = 0;
+    test_bring_up();
+    test_cpi();
+    test_motion();
+    test_tb_cpi();
+    test_curve_cpi();
+    test_stress();
+    test_hotplug();
+    test_batch();
+    test_bus_limit();
+    test_trace();
+    test_save_stats();
+    if (g_failures) {
+        printf("[!] 単体テストで %u 件失敗\n", g_failures);
+        return false;
+    }
+    printf("[i] 単体テスト成功（PAW3222 モック、設定の保存、トレース）\n");
+    return true;
+}
+
+// ====== Benchmark ================================================
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define BENCH_ROUNDS 200
+
+// tb_apply_transform_side() は tb.c の static なので、その中身の tb_xform_apply() を
+// 片側 1 レポートずつ測る。比較に float 版も同じ入力で動かす（回転 90 度、CPI 1600、
+// スクロールは gain 1.25 / gamma 0.75 / 32 分割）。
+typedef struct {
+    bool    fixed; // false: float 版
+    uint8_t filter;
+    bool    scroll;
+} bench_case_t;
+
+static const bench_case_t k_bench_cases[] = {
+    {false, 0, false}, {false, 0, true},
+    {true, TB_FILTER_IIR, false}, {true, TB_FILTER_IIR, true},
+    {true, TB_FILTER_ONE_EURO, false}, {true, TB_FILTER_ONE_EURO, true},
+    {true, TB_FILTER_NONE, false}, {true, TB_FILTER_NONE, true},
+};
+
+static volatile int32_t g_sink;
+
+static double bench_case(const bench_case_t* c) {
+    tb_xform_t  xf = {.rot = tb_rot_from_deg(90), .gain_q8 = tb_cpi_gain_q8(1600, 1596),
+                       .speed_q8 = tb_speed_norm_q8(1596), .scroll = c->scroll, .filter = c->filter};
+    tb_scroll_t sc;
+    tb_accel_build(&xf.accel, (const tb_accel_pt_t[])TB_ACCEL_DEFAULT, TB_ACCEL_DEFAULT_N);
+    tb_xform_reset(&xf);
+    tb_scroll_build(&sc, 1.25f, 0.75f);
+    sc.unit = 32 * TB_ONE;
+    sc.inv  = true;
+
+    tb_float_state_t fs  = {0};
+    tb_float_cfg_t   fc  = {.rot_deg = 90, .cpi = 1600, .scroll = c->scroll, .inv = true, .div_shift = 5,
+                            .sc_gain = 1.25f, .sc_gamma = 0.75f};
+
+    double t0 = now_s();
+    for (uint32_t i = 0; i < BENCH_ROUNDS * TRACE_TICKS; ++i) {
+        const tick_t* k = &g_trace[i % TRACE_TICKS];
+        if (c->fixed) {
+            tb_xform_out_t out;
+            tb_xform_apply(&xf, &sc, k->lx, k->ly, k->dt_us, &out);
+            g_sink += out.x + out.h;
+        } else {
+            int16_t x = k->lx, y = k->ly, h = 0, v = 0;
+            tb_float_apply(&fs, &fc, &x, &y, &h, &v);
+            g_sink += x + h;
+        }
+    }
+    return (now_s() - t0) * 1e9 / ((double)BENCH_ROUNDS * TRACE_TICKS);
+}
+
+static void bench(void) {
+    printf("[i] 1 回 = 片側 1 レポート（%u ティック x %u 回の平均）\n", TRACE_TICKS, BENCH_ROUNDS);
+    for (uint8_t i = 0; i < LEN(k_bench_cases); ++i) {
+        const bench_case_t* c = &k_bench_cases[i];
+        printf("%-14s %-4s %-6s  %6.1f ns/回\n", c->fixed ? "tb_xform_apply" : "tb_float_apply",
+               c->fixed ? k_filter_names[c->filter] : "", c->scroll ? "scroll" : "cursor", bench_case(c));
+    }
+
+    tb_config_t base = default_config();
+    apply_config(&base);
+    double t0 = now_s();
+    for (uint32_t n = 0; n < BENCH_ROUNDS; ++n) {
+        for (uint32_t t = 0; t < TRACE_TICKS; ++t) {
+            const tick_t*  k = &g_trace[t];
+            report_mouse_t o = tb_task_combined((report_mouse_t){.x = k->lx, .y = k->ly}, (report_mouse_t){.x = k->rx, .y = k->ry}, k->dt_us);
+            g_sink += o.x + o.v;
+        }
+    }
+    double dt = now_s() - t0;
+    printf("tb_task_combined 既定の設定  %6.1f ns/回（左右 2 回の変換を含む）\n", dt * 1e9 / ((double)BENCH_ROUNDS * TRACE_TICKS));
+}
+
+// ====== Main =====================================================
+int main(int argc, char** argv) {
+    bool update = argc > 1 && strcmp(argv[1], "-u") == 0;
+    if (argc > 1 && !update) {
+        fprintf(stderr, "usage: %s [-u]\n", argv[0]);
+        return 2;
+    }
+
+    make_trace();
+    run_grid();
+    if (update) return write_golden(TB_TEST_GOLDEN) ? 0 : 1;
+
+    bool ok = check_golden(TB_TEST_GOLDEN);
+    ok &= run_unit_tests();
+    bench();
+    return ok ? 0 : 1;
+}
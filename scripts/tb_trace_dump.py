@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Vial raw HID 経由でトラックボールのトレースを取得する。
+
+  python3 scripts/tb_trace_dump.py arm            # 記録開始（上書き継続）
+  python3 scripts/tb_trace_dump.py arm --oneshot  # 満杯で自動停止
+  python3 scripts/tb_trace_dump.py info
+  python3 scripts/tb_trace_dump.py dump -o trace.txt  # 停止して吸い出す
+
+出力形式（tb_replay が読む）:
+  # kbdata <tb_config_t の 16 進ダンプ>
+  t_us repeat kind motion x y
+
+kind は L / R（その側のセンサの読み出し）か T（tb_task_combined() の呼び出し）。
+動きの無い読み出しとティックは repeat に畳み込まれている。
+
+要 hidapi (pip install hidapi)。共通処理は vial_rawhid.py。
+"""
+
+import argparse
+import struct
+import sys
+
+import vial_rawhid
+from vial_rawhid import EPSIZE, open_device
+
+TB_TRACE_ARM = 0x01
+TB_TRACE_STOP = 0x02
+TB_TRACE_INFO = 0x03
+TB_TRACE_READ = 0x04
+TB_TRACE_CONFIG = 0x06
+
+REC = struct.Struct("<IHBBhh")  # tb_trace_rec_t
+KINDS = "LRT"  # tb_trace_kind
+RECS_PER_PACKET = (EPSIZE - 2) // REC.size
+CONFIG_CHUNK = EPSIZE - 4
+
+
+def command(dev, sub, payload=b""):
+    return vial_rawhid.command(dev, vial_rawhid.CMD_TB_TRACE, sub, payload, "TB_TRACE_ENABLE")
+
+
+def read_config(dev):
+    """tb_config_t を保存形式のまま取得する（28 バイトずつ）。"""
+    config = b""
+    while True:
+        body = command(dev, TB_TRACE_CONFIG, bytes([len(config)]))
+        size = body[1]
+        config += body[2:2 + min(CONFIG_CHUNK, size - len(config))]
+        if len(config) >= size:
+            return config
+
+
+def info(dev):
+    body = command(dev, TB_TRACE_INFO)
+    running, rec_size, count, capacity, dropped = struct.unpack_from("<BBHHI", body)
+    if rec_size != REC.size:
+        sys.exit(f"[!] レコード長が一致しません: {rec_size} != {REC.size}")
+    config = read_config(dev)
+    return dict(running=bool(running), count=count, capacity=capacity, dropped=dropped, config=config)
+
+
+def dump(dev, out):
+    command(dev, TB_TRACE_STOP)
+    st = info(dev)
+    out.write(f"# kbdata {st['config'].hex()}\n")
+    out.write(f"# records {st['count']} dropped {st['dropped']}\n")
+    for start in range(0, st["count"], RECS_PER_PACKET):
+        body = command(dev, TB_TRACE_READ, struct.pack("<H", start))
+        for i in range(min(RECS_PER_PACKET, st["count"] - start)):
+            t_us, repeat, kind, motion, x, y = REC.unpack_from(body, i * REC.size)
+            out.write(f"{t_us} {repeat} {KINDS[kind]} {motion} {x} {y}\n")
+    return st
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("action", choices=["arm", "stop", "info", "dump"])
+    ap.add_argument("--oneshot", action="store_true", help="arm: バッファが満杯になったら停止")
+    ap.add_argument("-o", "--output", help="dump: 出力先（省略時は標準出力）")
+    ap.add_argument("--vid", type=lambda s: int(s, 0))
+    ap.add_argument("--pid", type=lambda s: int(s, 0))
+    args = ap.parse_args()
+
+    dev = open_device(args.vid, args.pid)
+    try:
+        if args.action == "arm":
+            command(dev, TB_TRACE_ARM, bytes([1 if args.oneshot else 0]))
+            print("[i] 記録を開始しました")
+        elif args.action == "stop":
+            command(dev, TB_TRACE_STOP)
+        elif args.action == "info":
+            st = info(dev)
+            print(f"running={st['running']} records={st['count']}/{st['capacity']} "
+                  f"dropped={st['dropped']} config={st['config'].hex()}")
+        else:
+            out = open(args.output, "w") if args.output else sys.stdout
+            st = dump(dev, out)
+            if args.output:
+                out.close()
+            print(f"[i] {st['count']} レコードを取得しました（欠落 {st['dropped']}）", file=sys.stderr)
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+"""Vial raw HID の独自コマンド（keymaps/vial/rawhid_cmd.h）を送る共通処理。
+
+要 hidapi (pip install hidapi)。
+"""
+
+import sys
+
+import hid
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE = 0x61
+EPSIZE = 32
+
+CMD_TB_TRACE = 0x70
+CMD_LINK_STATS = 0x71
+CMD_SCAN_PROF = 0x72
+CMD_SENSOR = 0x73
+CMD_TB_ACCEL = 0x74
+CMD_TB_SAVE = 0x75
+
+ERR = 0xFF
+
+
+def open_device(vid=None, pid=None):
+    for d in hid.enumerate(vid or 0, pid or 0):
+        if d["usage_page"] == RAW_USAGE_PAGE and d["usage"] == RAW_USAGE:
+            dev = hid.device()
+            dev.open_path(d["path"])
+            return dev
+    sys.exit("[!] raw HID デバイスが見つかりません")
+
+
+def command(dev, cmd, sub, payload=b"", feature="該当機能"):
+    """data[0] = cmd, data[1] = sub で送り、応答の data[2:] を返す。"""
+    req = bytes([cmd, sub]) + payload
+    req = req.ljust(EPSIZE, b"\0")
+    dev.write(b"\0" + req)  # 先頭はレポート ID
+    resp = bytes(dev.read(EPSIZE, 1000))
+    if len(resp) != EPSIZE or resp[0] != cmd:
+        sys.exit(f"[!] 応答がありません（{feature} でビルドされているか確認）")
+    if resp[1] == ERR:
+        sys.exit("[!] コマンドが拒否されました")
+    return resp[2:]